@@ -139,6 +139,78 @@ namespace Dune
       macroData_.insertElement( array );
     }
 
+    /** \brief reserve storage for the given numbers of vertices and elements
+     *
+     *  \param[in]  vertexCount   total number of vertices of the macro grid
+     *  \param[in]  elementCount  total number of elements of the macro grid
+     */
+    virtual void reserve ( std::size_t vertexCount, std::size_t elementCount )
+    {
+      macroData_.reserve( int( vertexCount ), int( elementCount ) );
+    }
+
+    /** \brief insert several vertices into the macro grid
+     *
+     *  \param[in]  coordinates  positions of the vertices (dimworld consecutive values per vertex)
+     *  \param[in]  vertexCount  number of vertices
+     */
+    virtual void insertVertices ( const ctype *coordinates, std::size_t vertexCount )
+    {
+      WorldVector pos;
+      for( std::size_t i = 0; i < vertexCount; ++i, coordinates += dimensionworld )
+      {
+        std::copy( coordinates, coordinates + dimensionworld, pos.begin() );
+        macroData_.insertVertex( pos );
+      }
+    }
+
+    /** \brief insert several elements of the same type into the macro grid
+     *
+     *  \param[in]  type         GeometryType of the new elements
+     *  \param[in]  vertices     indices of the element vertices (in DUNE numbering), one element after the other
+     *  \param[in]  numElements  number of elements
+     */
+    virtual void insertElements ( const GeometryType &type,
+                                  const unsigned int *vertices, std::size_t numElements )
+    {
+      if( (int)type.dim() != dimension )
+        DUNE_THROW( AlbertaError, "Inserting element of wrong dimension: " << type.dim() );
+      if( !type.isSimplex() )
+        DUNE_THROW( AlbertaError, "Alberta supports only simplices." );
+
+      int array[ numVertices ];
+      for( std::size_t k = 0; k < numElements; ++k, vertices += numVertices )
+      {
+        for( int i = 0; i < numVertices; ++i )
+          array[ i ] = vertices[ numberingMap_.alberta2dune( dimension, i ) ];
+        macroData_.insertElement( array );
+      }
+    }
+
+    /** \brief insert several elements into the macro grid
+     *
+     *  \param[in]  offsets      the vertices of element k are the entries offsets[k] to offsets[k+1]-1 of vertices
+     *  \param[in]  vertices     indices of the element vertices (in DUNE numbering)
+     *  \param[in]  numElements  number of elements
+     */
+    virtual void insertElements ( const unsigned int *offsets,
+                                  const unsigned int *vertices, std::size_t numElements )
+    {
+      for( std::size_t k = 0; k < numElements; ++k )
+      {
+        if( offsets[ k+1 ] - offsets[ k ] != (unsigned int)numVertices )
+          DUNE_THROW( AlbertaError, "Wrong number of vertices passed: " << offsets[ k+1 ] - offsets[ k ] << "." );
+      }
+
+      int array[ numVertices ];
+      for( std::size_t k = 0; k < numElements; ++k )
+      {
+        for( int i = 0; i < numVertices; ++i )
+          array[ i ] = vertices[ offsets[ k ] + numberingMap_.alberta2dune( dimension, i ) ];
+        macroData_.insertElement( array );
+      }
+    }
+
     /** \brief mark a face as boundary (and assign a boundary id)
      *
      *  \internal
@@ -167,6 +167,21 @@ namespace Dune
         return vertexCount_++;
       }
 
+      /** \brief reserve storage
+       *
+       *  Make room for the given total numbers of vertices and elements, so
+       *  that inserting them does not reallocate. This may only be done in
+       *  insert mode.
+       */
+      void reserve ( const int vertices, const int elements )
+      {
+        assert( (vertexCount_ >= 0) && (elementCount_ >= 0) );
+        if( vertices > data_->n_total_vertices )
+          resizeVertices( vertices );
+        if( elements > data_->n_macro_elements )
+          resizeElements( elements );
+      }
+
       void insertWallTrafo ( const GlobalMatrix &m, const GlobalVector &t );
       void insertWallTrafo ( const FieldMatrix< Real, dimWorld, dimWorld > &matrix,
                              const FieldVector< Real, dimWorld > &shift );
@@ -175,6 +175,28 @@ namespace Dune
     }
   }; // end class CommDataHandleIF
 
+  /** @brief
+     Handle of a communication that has already been completed.
+
+     This is returned by communicateBegin() of grids that do not support
+     split-phase communication. Such grids perform the whole communication
+     within communicateBegin(), wait() and test() have nothing left to do.
+
+     \ingroup GICollectiveCommunication
+   */
+  class CompletedCommunication
+  {
+  public:
+    //! wait until the communication is complete
+    void wait () {}
+
+    //! return true if the communication is complete
+    bool test () { return true; }
+
+    //! return true if the communication is complete
+    bool ready () const { return true; }
+  };
+
 #undef CHECK_INTERFACE_IMPLEMENTATION
 #undef CHECK_AND_CALL_INTERFACE_IMPLEMENTATION
 
@@ -3,6 +3,8 @@
 #ifndef DUNE_GRID_COMMON_DEFAULTGRIDVIEW_HH
 #define DUNE_GRID_COMMON_DEFAULTGRIDVIEW_HH
 
+#include <utility>
+
 #include <dune/common/typetraits.hh>
 #include <dune/common/exceptions.hh>
 
@@ -196,6 +198,16 @@ namespace Dune
       return grid().communicate( data, iftype, dir, level_ );
     }
 
+    /** start a split-phase communication on this view */
+    template< class DataHandleImp, class DataType >
+    auto communicateBegin ( CommDataHandleIF< DataHandleImp, DataType > &data,
+                            InterfaceType iftype,
+                            CommunicationDirection dir ) const
+    -> decltype( std::declval< const Grid & >().communicateBegin( data, iftype, dir, 0 ) )
+    {
+      return grid().communicateBegin( data, iftype, dir, level_ );
+    }
+
   private:
     const Grid *grid_;
     int level_;
@@ -378,6 +390,16 @@ namespace Dune
       return grid().communicate( data, iftype, dir );
     }
 
+    /** start a split-phase communication on this view */
+    template< class DataHandleImp, class DataType >
+    auto communicateBegin ( CommDataHandleIF< DataHandleImp, DataType > &data,
+                            InterfaceType iftype,
+                            CommunicationDirection dir ) const
+    -> decltype( std::declval< const Grid & >().communicateBegin( data, iftype, dir ) )
+    {
+      return grid().communicateBegin( data, iftype, dir );
+    }
+
   private:
     const Grid *grid_;
   };
@@ -1026,6 +1026,28 @@ namespace Dune {
                       InterfaceType iftype, CommunicationDirection dir) const
     {}
 
+    /** \brief default split-phase communicate, performs the whole communication
+     *  immediately and returns a completed communication
+     */
+    template<class DataHandleImp, class DataTypeImp>
+    CompletedCommunication communicateBegin (CommDataHandleIF<DataHandleImp,DataTypeImp> & data,
+                                             InterfaceType iftype, CommunicationDirection dir, int level) const
+    {
+      asImp().communicate(data,iftype,dir,level);
+      return CompletedCommunication();
+    }
+
+    /** \brief default split-phase communicate, performs the whole communication
+     *  immediately and returns a completed communication
+     */
+    template<class DataHandleImp, class DataTypeImp>
+    CompletedCommunication communicateBegin (CommDataHandleIF<DataHandleImp,DataTypeImp> & data,
+                                             InterfaceType iftype, CommunicationDirection dir) const
+    {
+      asImp().communicate(data,iftype,dir);
+      return CompletedCommunication();
+    }
+
     /*! \brief default implementation of load balance does nothing and returns false */
     bool loadBalance()
     {
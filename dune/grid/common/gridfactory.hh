@@ -7,6 +7,8 @@
     \brief Provide a generic factory class for unstructured grids.
  */
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -126,6 +128,68 @@ namespace Dune
       DUNE_THROW(GridError, "This grid does not support parametrized elements!");
     }
 
+    /** \brief Announce the number of vertices and elements that will be inserted
+
+       This is only a hint, which allows the factory to allocate its storage
+       once. More or fewer entities may be inserted afterwards.
+     */
+    virtual void reserve(std::size_t, std::size_t)
+    {}
+
+    /** \brief Insert several vertices into the coarse grid
+        \param coordinates The coordinates of the vertices, dimworld consecutive values per vertex
+        \param numVertices The number of vertices
+
+        The vertices get consecutive numbers, in the order in which they appear in the array.
+     */
+    virtual void insertVertices(const ctype* coordinates, std::size_t numVertices)
+    {
+      FieldVector<ctype,dimworld> pos;
+      for (std::size_t i=0; i<numVertices; i++, coordinates+=dimworld)
+      {
+        std::copy(coordinates, coordinates+dimworld, pos.begin());
+        insertVertex(pos);
+      }
+    }
+
+    /** \brief Insert several elements of the same type into the coarse grid
+        \param type The GeometryType of the new elements
+        \param vertices The vertices of the new elements, using the DUNE numbering,
+                        the corners of one element after the other
+        \param numElements The number of elements
+     */
+    virtual void insertElements(const GeometryType& type,
+                                const unsigned int* vertices, std::size_t numElements)
+    {
+      std::vector<unsigned int> corners(numCorners(type));
+      for (std::size_t i=0; i<numElements; i++, vertices+=corners.size())
+      {
+        std::copy(vertices, vertices+corners.size(), corners.begin());
+        insertElement(type, corners);
+      }
+    }
+
+    /** \brief Insert several elements into the coarse grid, whose types are given by their numbers of corners
+        \param offsets The corners of element i are the entries offsets[i] to offsets[i+1]-1 of
+                       the vertices array, there are numElements+1 offsets
+        \param vertices The vertices of the new elements, using the DUNE numbering
+        \param numElements The number of elements
+
+        The number of corners determines the type: in 2d, three corners make a triangle
+        and four a quadrilateral, in 3d four, five, six and eight corners make a
+        tetrahedron, a pyramid, a prism and a hexahedron.
+     */
+    virtual void insertElements(const unsigned int* offsets,
+                                const unsigned int* vertices, std::size_t numElements)
+    {
+      std::vector<unsigned int> corners;
+      for (std::size_t i=0; i<numElements; i++)
+      {
+        corners.assign(vertices+offsets[i], vertices+offsets[i+1]);
+        insertElement(typeOfElement(corners.size()), corners);
+      }
+    }
+
     /** \brief insert a boundary segment
      *
      *  This method inserts a boundary segment into the coarse grid. Using
@@ -247,6 +311,35 @@ namespace Dune
       DUNE_THROW( NotImplemented, "insertion indices have not yet been implemented." );
     }
 
+  protected:
+    //! the number of corners of an element of the given type
+    static std::size_t numCorners(const GeometryType& type)
+    {
+      if (type.isSimplex())
+        return type.dim()+1;
+      if (type.isCube())
+        return 1u << type.dim();
+      if (type.isPyramid())
+        return 5;
+      if (type.isPrism())
+        return 6;
+      DUNE_THROW(GridError, "Elements of type " << type << " have no corners!");
+    }
+
+    //! the type of an element of the grid dimension with the given number of corners
+    static GeometryType typeOfElement(std::size_t corners)
+    {
+      if (corners == std::size_t(dimension+1))
+        return GeometryType(GeometryType::simplex, dimension);
+      if (corners == (1u << dimension))
+        return GeometryType(GeometryType::cube, dimension);
+      if (dimension == 3 && corners == 5)
+        return GeometryType(GeometryType::pyramid, dimension);
+      if (dimension == 3 && corners == 6)
+        return GeometryType(GeometryType::prism, dimension);
+      DUNE_THROW(GridError, "There is no element type in " << dimension << "d with " << corners << " corners!");
+    }
+
   };
 
 
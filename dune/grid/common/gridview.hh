@@ -3,6 +3,8 @@
 #ifndef DUNE_GRIDVIEW_HH
 #define DUNE_GRIDVIEW_HH
 
+#include <utility>
+
 #include <dune/common/iteratorrange.hh>
 
 #include <dune/geometry/type.hh>
@@ -270,6 +272,26 @@ namespace Dune
       impl().communicate(data,iftype,dir);
     }
 
+    /** \brief Start a split-phase communication on this view
+
+       Gathers the data and starts the communication. The returned object
+       completes it: wait() blocks until all data has been scattered, test()
+       scatters the data that has already arrived and returns true once the
+       communication is complete. This allows to overlap the communication
+       with computation. Grids without support for split-phase communication
+       perform the whole communication here.
+
+       The data handle has to stay alive until the communication is complete.
+     */
+    template< class DataHandleImp, class DataType >
+    auto communicateBegin ( CommDataHandleIF< DataHandleImp, DataType > &data,
+                            InterfaceType iftype,
+                            CommunicationDirection dir ) const
+    -> decltype( std::declval< const Implementation & >().communicateBegin( data, iftype, dir ) )
+    {
+      return impl().communicateBegin(data,iftype,dir);
+    }
+
 #if DUNE_GRID_EXPERIMENTAL_GRID_EXTENSIONS
   public:
 #else
@@ -62,6 +62,23 @@ namespace Dune {
     virtual void insertElement(const GeometryType& type,
                                const std::vector<unsigned int>& vertices);
 
+    /** \brief Reserve storage for the given number of elements, the vertices are kept in a map */
+    virtual void reserve(std::size_t numVertices, std::size_t numElements);
+
+    /** \brief Insert several vertices into the coarse grid
+
+       Inserting the vertices in ascending order is fastest.
+     */
+    virtual void insertVertices(const ctype* coordinates, std::size_t numVertices);
+
+    /** \brief Insert several elements into the coarse grid, two vertices per element */
+    virtual void insertElements(const GeometryType& type,
+                                const unsigned int* vertices, std::size_t numElements);
+
+    /** \brief Insert several elements into the coarse grid, each of which must have two vertices */
+    virtual void insertElements(const unsigned int* offsets,
+                                const unsigned int* vertices, std::size_t numElements);
+
     /** \brief Insert a boundary segment (== a point).
         This influences the ordering of the boundary segments
      */
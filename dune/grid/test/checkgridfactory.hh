@@ -15,24 +15,15 @@
 namespace Dune
 {
 
-  // checkGridFactory
-  // ----------------
+  // checkInsertionIndices
+  // ---------------------
 
   template< class Grid, class Mesh, class Projection >
-  void checkGridFactory ( const Mesh &mesh, Projection &&projection )
+  void checkInsertionIndices ( const GridFactory< Grid > &factory, const Grid &grid,
+                               const Mesh &mesh, Projection &&projection )
   {
-    GridFactory< Grid > factory;
-
-    // create grid from mesh
     typedef FieldVector< typename Grid::ctype, Grid::dimensionworld > Vertex;
 
-    mesh.addToGridFactory( factory, projection );
-
-    std::unique_ptr< Grid > gridptr( factory.createGrid() );
-    Grid &grid = *gridptr;
-
-    // check insertion indices
-
     // check vertex insertion index
     for( const auto vertex : vertices( grid.leafGridView() ) )
     {
@@ -96,6 +87,79 @@ namespace Dune
   }
 
 
+  // checkGridFactory
+  // ----------------
+
+  template< class Grid, class Mesh, class Projection >
+  void checkGridFactory ( const Mesh &mesh, Projection &&projection )
+  {
+    GridFactory< Grid > factory;
+
+    // create grid from mesh
+    mesh.addToGridFactory( factory, projection );
+
+    std::unique_ptr< Grid > gridptr( factory.createGrid() );
+
+    // check insertion indices
+    checkInsertionIndices( factory, *gridptr, mesh, projection );
+  }
+
+
+  // checkBulkInsertion
+  // ------------------
+
+  template< class Grid, class Mesh, class Projection >
+  void checkBulkInsertion ( const Mesh &mesh, Projection &&projection )
+  {
+    GridFactory< Grid > factory;
+    factory.reserve( mesh.vertices.size(), mesh.elements.size() );
+
+    // insert all vertices at once
+    std::vector< typename Grid::ctype > coordinates;
+    for( const auto &v : mesh.vertices )
+    {
+      const auto x = projection( v );
+      coordinates.insert( coordinates.end(), x.begin(), x.end() );
+    }
+    factory.insertVertices( coordinates.data(), mesh.vertices.size() );
+
+    // insert the leading elements of the first type together, at most half of them
+    std::size_t head = 0;
+    while( (head < mesh.elements.size() / 2) && (mesh.elements[ head ].first == mesh.elements[ 0 ].first) )
+      ++head;
+
+    std::vector< unsigned int > connectivity;
+    for( std::size_t i = 0; i < head; ++i )
+      connectivity.insert( connectivity.end(), mesh.elements[ i ].second.begin(), mesh.elements[ i ].second.end() );
+    if( head > 0 )
+      factory.insertElements( mesh.elements[ 0 ].first, connectivity.data(), head );
+
+    // insert the others with offsets, the number of corners determines their type
+    std::vector< unsigned int > offsets( 1, 0 );
+    connectivity.clear();
+    for( std::size_t i = head; i < mesh.elements.size(); ++i )
+    {
+      connectivity.insert( connectivity.end(), mesh.elements[ i ].second.begin(), mesh.elements[ i ].second.end() );
+      offsets.push_back( connectivity.size() );
+    }
+    factory.insertElements( offsets.data(), connectivity.data(), mesh.elements.size() - head );
+
+    for( const auto &b : mesh.boundaries )
+      factory.insertBoundarySegment( b );
+
+    std::unique_ptr< Grid > gridptr( factory.createGrid() );
+
+    // the grid must be the same as one inserted entity by entity
+    checkInsertionIndices( factory, *gridptr, mesh, projection );
+  }
+
+  template< class Grid, class Mesh >
+  void checkBulkInsertion ( const Mesh &mesh )
+  {
+    checkBulkInsertion< Grid >( mesh, [] ( const typename Mesh::Vertex &v ) { return v; } );
+  }
+
+
   template< class Grid, class Mesh >
   void checkGridFactory ( const Mesh &mesh )
   {
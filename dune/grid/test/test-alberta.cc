@@ -127,11 +127,15 @@ try {
 #if ALBERTA_DIM == 2 && GRIDDIM == 2
   std::cout << "Check GridFactory ..." <<std::endl;
   Dune::checkGridFactory< GridType >( Dune::TestGrids::kuhn2d );
+  std::cout << "Check bulk insertion into the GridFactory ..." <<std::endl;
+  Dune::checkBulkInsertion< GridType >( Dune::TestGrids::kuhn2d );
 #endif // #if ALBERTA_DIM == 2 && GRIDDIM == 2
 
 #if ALBERTA_DIM == 3 && GRIDDIM == 3
   std::cout << "Check GridFactory ..." <<std::endl;
   Dune::checkGridFactory< GridType >( Dune::TestGrids::kuhn3d );
+  std::cout << "Check bulk insertion into the GridFactory ..." <<std::endl;
+  Dune::checkBulkInsertion< GridType >( Dune::TestGrids::kuhn3d );
 #endif // #if ALBERTA_DIM == 3 && GRIDDIM == 3
 
   std::string filename;
@@ -15,24 +15,42 @@
 
 using namespace Dune;
 
-std::unique_ptr<OneDGrid> testFactory()
+std::unique_ptr<OneDGrid> testFactory(bool bulkInsertion)
 {
   GridFactory<OneDGrid> factory;
 
   // Insert vertices
   std::vector<FieldVector<double,1> > vertexPositions = {0.6, 1.0, 0.2, 0.0, 0.4, 0.3, 0.7};
 
-  for (auto&& pos : vertexPositions)
-    factory.insertVertex(pos);
-
   // Insert elements
   GeometryType segment(GeometryType::simplex,1);
-  factory.insertElement(segment, {6,1});
-  factory.insertElement(segment, {4,0});
-  factory.insertElement(segment, {0,6});
-  factory.insertElement(segment, {5,4});
-  factory.insertElement(segment, {3,2});
-  factory.insertElement(segment, {2,5});
+
+  if (bulkInsertion)
+  {
+    factory.reserve(7, 6);
+
+    std::vector<double> coordinates = {0.6, 1.0, 0.2, 0.0, 0.4, 0.3, 0.7};
+    factory.insertVertices(coordinates.data(), 3);
+    factory.insertVertices(coordinates.data()+3, 4);
+
+    // Insert half of the elements with a single type and half with offsets
+    std::vector<unsigned int> connectivity = {6,1, 4,0, 0,6, 5,4, 3,2, 2,5};
+    std::vector<unsigned int> offsets = {0, 2, 4, 6};
+    factory.insertElements(segment, connectivity.data(), 3);
+    factory.insertElements(offsets.data(), connectivity.data()+6, 3);
+  }
+  else
+  {
+    for (auto&& pos : vertexPositions)
+      factory.insertVertex(pos);
+
+    factory.insertElement(segment, {6,1});
+    factory.insertElement(segment, {4,0});
+    factory.insertElement(segment, {0,6});
+    factory.insertElement(segment, {5,4});
+    factory.insertElement(segment, {3,2});
+    factory.insertElement(segment, {2,5});
+  }
 
   // Insert boundary segments
   factory.insertBoundarySegment({1});
@@ -153,10 +171,15 @@ void testOneDGrid(OneDGrid& grid)
 int main () try
 {
   // Create a OneDGrid using the grid factory and test it
-  std::unique_ptr<Dune::OneDGrid> factoryGrid(testFactory());
+  std::unique_ptr<Dune::OneDGrid> factoryGrid(testFactory(false));
 
   testOneDGrid(*factoryGrid);
 
+  // The same grid, inserted into the factory with the bulk methods
+  std::unique_ptr<Dune::OneDGrid> bulkFactoryGrid(testFactory(true));
+
+  testOneDGrid(*bulkFactoryGrid);
+
   // Create a OneDGrid with an array of vertex coordinates and test it
   std::vector<double> coords = {-1,
                                 -0.4,
@@ -7,6 +7,7 @@
 #include <unistd.h>
 #include <iostream>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 #include <dune/common/parallel/mpihelper.hh>
@@ -296,6 +297,81 @@ void testCommunication(const GridView &gridView, bool isLeaf, bool printVTK=fals
   }
 }
 
+// A DataHandle class sending the center of each entity, the receiver compares it with its own
+template<class GridView, int commCodim>
+class CenterExchange
+  : public Dune::CommDataHandleIF<CenterExchange<GridView, commCodim>, double>
+{
+public:
+  typedef double DataType;
+
+  CenterExchange(const GridView &gridView)
+    : gridView_(gridView)
+  {}
+
+  bool contains (int dim, int codim) const
+  {
+    return (codim == commCodim);
+  }
+
+  bool fixedSize (int dim, int codim) const
+  {
+    return true;
+  }
+
+  template<class EntityType>
+  size_t size (EntityType& e) const
+  {
+    return GridView::dimensionworld;
+  }
+
+  template<class MessageBuffer, class EntityType>
+  void gather(MessageBuffer& buff, const EntityType& e) const
+  {
+    const auto center = e.geometry().center();
+    for (int i = 0; i < GridView::dimensionworld; i++)
+      buff.write(center[i]);
+  }
+
+  template<class MessageBuffer, class EntityType>
+  void scatter(MessageBuffer& buff, const EntityType& e, size_t n)
+  {
+    const auto center = e.geometry().center();
+    for (int i = 0; i < GridView::dimensionworld; i++)
+    {
+      DataType x;
+      buff.read(x);
+      if (Dune::FloatCmp::ne(x, center[i]))
+        DUNE_THROW(Dune::Exception, "Process "
+                   << gridView_.comm().rank()+1
+                   << " received the center of a different entity in the fused communication");
+    }
+  }
+
+private:
+  const GridView &gridView_;
+};
+
+//! communicate element and vertex data of several handles together
+template <class GridView>
+void testFusedCommunication(const GridView &gridView, int level)
+{
+  std::cout << gridView.comm().rank() + 1
+            << ": Testing fused communication for element and vertex data\n";
+
+  const int dim = GridView::dimension;
+  CenterExchange<GridView, 0> elementCenters(gridView);
+  CenterExchange<GridView, dim> vertexCenters(gridView);
+  CenterExchange<GridView, dim> moreVertexCenters(gridView);
+
+  if (level < 0)
+    gridView.grid().communicate(std::tie(elementCenters, vertexCenters, moreVertexCenters),
+                                Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+  else
+    gridView.grid().communicate(std::tie(elementCenters, vertexCenters, moreVertexCenters),
+                                Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication, level);
+}
+
 //! edge and face communication
 template <class GridView, int commCodim>
 class EdgeAndFaceCommunication
@@ -414,48 +490,64 @@ class LoadBalance
     Vector& dataVector_;
   };
 
-public:
-  template <class Grid>
-  static void test(Grid& grid)
+  /** \brief Balance the grid together with the centers of the codim commCodim entities and check them
+   *
+   * \param targetProcessors The target rank of each leaf element, or nullptr to let UG balance the grid
+   */
+  template <int commCodim, class Grid>
+  static void testBalance(Grid& grid, const std::vector<typename Grid::Rank>* targetProcessors)
   {
     const int dim = Grid::dimension;
-    const int commCodim = dim;
     typedef typename Grid::ctype ctype;
 
     // define the vector containing the data to be balanced
     typedef Dune::FieldVector<ctype, dim> Position;
     std::vector<Position> dataVector(grid.leafGridView().size(commCodim));
 
-    // fill the data vector
+    // fill the data vector, UG's leaf iterators only support codims 0 and dim,
+    // so the entities are reached as subentities of the interior elements
     const auto& gv = grid.leafGridView();
-    for (const auto& entity : entities(gv, Dune::Codim<commCodim>(),
-                                       Dune::Partitions::interiorBorder)) {
-      int index = gv.indexSet().index(entity);
+    for (const auto& element : elements(gv, Dune::Partitions::interior)) {
+      for (unsigned int i = 0; i < element.subEntities(commCodim); i++) {
+        const auto entity = element.template subEntity<commCodim>(i);
+        int index = gv.indexSet().index(entity);
 
-      // assign the position of the entity to the entry in the vector
-      dataVector[index] = entity.geometry().center();
+        // assign the position of the entity to the entry in the vector
+        dataVector[index] = entity.geometry().center();
+      }
     }
 
     // balance the grid and the data
     LBDataHandle<Grid, std::vector<Position>, commCodim> dataHandle(grid, dataVector);
-    grid.loadBalance(dataHandle);
+    if (targetProcessors)
+      grid.loadBalance(*targetProcessors, 0, dataHandle);
+    else
+      grid.loadBalance(dataHandle);
+
+    // make sure the data really had to migrate
+    if (targetProcessors && gv.comm().rank() != 0 && gv.size(0) > 0)
+      DUNE_THROW(Dune::ParallelError,
+                 gv.comm().rank() << ": still has " << gv.size(0)
+                                  << " elements, although all of them were sent to rank 0");
 
     // check for correctness
-    for (const auto& entity : entities(gv, Dune::Codim<commCodim>(),
-                                       Dune::Partitions::interiorBorder)) {
-      int index = gv.indexSet().index(entity);
+    for (const auto& element : elements(gv, Dune::Partitions::interior)) {
+      for (unsigned int i = 0; i < element.subEntities(commCodim); i++) {
+        const auto entity = element.template subEntity<commCodim>(i);
+        int index = gv.indexSet().index(entity);
 
-      const auto position = entity.geometry().center();
+        const auto position = entity.geometry().center();
 
-      // compare the position with the balanced data
-      for (int k = 0; k < dim; k++)
-      {
-        if (Dune::FloatCmp::ne(dataVector[index][k], position[k]))
+        // compare the position with the balanced data
+        for (int k = 0; k < dim; k++)
         {
-          DUNE_THROW(Dune::ParallelError,
-                     gv.comm().rank() << ": position " << position
-                                      << " does not coincide with communicated data "
-                                      << dataVector[index]);
+          if (Dune::FloatCmp::ne(dataVector[index][k], position[k]))
+          {
+            DUNE_THROW(Dune::ParallelError,
+                       gv.comm().rank() << ": position " << position
+                                        << " does not coincide with communicated data "
+                                        << dataVector[index]);
+          }
         }
       }
     }
@@ -463,6 +555,20 @@ public:
     std::cout << gv.comm().rank()
               << ": load balancing with data was successful." << std::endl;
   }
+
+public:
+  /** \brief Gather the grid with data on codim commCodim entities on rank 0, then distribute it again
+   *
+   * Both steps move entities between the processes, so the data of all of them has to migrate.
+   */
+  template <int commCodim, class Grid>
+  static void test(Grid& grid)
+  {
+    std::vector<typename Grid::Rank> targetProcessors(grid.leafGridView().size(0), 0);
+    testBalance<commCodim>(grid, &targetProcessors);
+
+    testBalance<commCodim>(grid, nullptr);
+  }
 };
 
 template <int dim>
@@ -491,7 +597,13 @@ void testParallelUG(bool simplexGrid, bool localRefinement, int refinementDim, b
   //////////////////////////////////////////////////////
   // Distribute the grid
   //////////////////////////////////////////////////////
-  LoadBalance::test(*grid);
+  LoadBalance::test<dim>(*grid);
+
+  // balance again with data on the edges (codim dim-1, in 2d and 3d), on the faces in 3d and on the elements
+  LoadBalance::test<dim-1>(*grid);
+  if (dim == 3)
+    LoadBalance::test<1>(*grid);
+  LoadBalance::test<0>(*grid);
 
   std::cout << "Process " << grid->comm().rank() + 1
             << " has " << grid->size(0)
@@ -548,6 +660,10 @@ void testParallelUG(bool simplexGrid, bool localRefinement, int refinementDim, b
   if (dim == 3)
     EdgeAndFaceCommunication<LeafGV, 1>::test(leafGridView);
 
+  // Test several data handles in one sweep
+  testFusedCommunication(level0GridView, 0);
+  testFusedCommunication(leafGridView, -1);
+
   ////////////////////////////////////////////////////
   //  Refine globally and test again
   ////////////////////////////////////////////////////
@@ -614,9 +730,79 @@ void testParallelUG(bool simplexGrid, bool localRefinement, int refinementDim, b
   EdgeAndFaceCommunication<LeafGV, dim-1>::test(grid->leafGridView());
   if (dim == 3)
     EdgeAndFaceCommunication<LeafGV, 1>::test(grid->leafGridView());
+  testFusedCommunication(grid->leafGridView(), -1);
 
 }
 
+/** \brief Create a distributed 2d grid with each process inserting a stripe of quadrilaterals
+ *
+ * Process p inserts the rows 4p to 4p+3 of a structured grid of 4 rows per process,
+ * the vertices on the lines between the stripes are inserted by both neighbors.
+ */
+void testDistributedCreation()
+{
+  const int dim = 2;
+  typedef UGGrid<dim> GridType;
+
+  const auto& comm = MPIHelper::getCollectiveCommunication();
+  const int columns = 4;
+  const int rows = 4*comm.size();
+  const int firstRow = 4*comm.rank();
+  const int lastRow = firstRow + 4;
+
+  std::cout << "Testing the distributed creation of UGGrid<" << dim << ">\n";
+
+  GridFactory<GridType> factory;
+
+  // The vertices of the stripe, numbered row by row in the whole grid
+  std::vector<unsigned int> localIndex((rows+1)*(columns+1));
+  unsigned int numVertices = 0;
+  for (int j=firstRow; j<=lastRow; j++)
+    for (int i=0; i<=columns; i++) {
+      FieldVector<double,dim> pos = {double(i)/columns, double(j)/rows};
+      unsigned int globalIndex = j*(columns+1) + i;
+      factory.insertVertex(pos, globalIndex);
+      localIndex[globalIndex] = numVertices++;
+    }
+
+  GeometryType quadrilateral(GeometryType::cube, dim);
+  for (int j=firstRow; j<lastRow; j++)
+    for (int i=0; i<columns; i++) {
+      unsigned int v = j*(columns+1) + i;
+      factory.insertElement(quadrilateral, {localIndex[v], localIndex[v+1],
+                                            localIndex[v+columns+1], localIndex[v+columns+2]});
+    }
+
+  std::unique_ptr<GridType> grid(factory.createGrid());
+
+  // Each process owns exactly the elements it inserted
+  int interiorElements = 0;
+  for (const auto& element : elements(grid->leafGridView(), Partitions::interior)) {
+    const double y = element.geometry().center()[1];
+    if (y < double(firstRow)/rows || y > double(lastRow)/rows)
+      DUNE_THROW(GridError, "Process " << comm.rank() << " owns an element at height " << y
+                 << ", outside of the stripe it inserted!");
+    interiorElements++;
+  }
+
+  if (interiorElements != 4*columns)
+    DUNE_THROW(GridError, "Process " << comm.rank() << " owns " << interiorElements
+               << " elements, but has inserted " << 4*columns << "!");
+
+  // The insertion index is the number in the order of insertion on this process
+  for (const auto& element : elements(grid->leafGridView(), Partitions::interior)) {
+    const unsigned int k = factory.insertionIndex(element);
+    const FieldVector<double,dim> center = {(k%columns + 0.5)/columns, (firstRow + k/columns + 0.5)/rows};
+    if ((center - element.geometry().center()).two_norm() > 1e-8)
+      DUNE_THROW(GridError, "Process " << comm.rank() << " has an element at " << element.geometry().center()
+                 << " with the insertion index " << k << " of the element at " << center << "!");
+  }
+
+  typedef GridType::LeafGridView LeafGV;
+  testCommunication<LeafGV, 0>(grid->leafGridView(), true);
+  testCommunication<LeafGV, dim>(grid->leafGridView(), true);
+}
+
 int main (int argc , char **argv) try
 {
   // initialize MPI, finalize is done automatically on exit
@@ -654,6 +840,8 @@ int main (int argc , char **argv) try
     }
   }
 
+  testDistributedCreation();
+
   return 0;
 }
 catch (Dune::Exception& e) {
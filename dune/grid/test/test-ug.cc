@@ -4,7 +4,9 @@
 #include <config.h>
 
 #include <iostream>
+#include <map>
 #include <memory>
+#include <set>
 
 #include <dune/common/parallel/mpihelper.hh>
 
@@ -12,10 +14,13 @@
    Instantiate UG-Grid and feed it to the generic gridcheck()
  */
 #include <dune/grid/uggrid.hh>
+#include <dune/grid/common/mcmgmapper.hh>
 #include <doc/grids/gridfactory/hybridtestgrids.hh>
+#include <doc/grids/gridfactory/testgrids.hh>
 
 #include "gridcheck.hh"
 #include "checkcommunicate.hh"
+#include "checkgridfactory.hh"
 #include "checkgeometryinfather.hh"
 #include "checkintersectionit.hh"
 #include "checkpartition.hh"
@@ -146,6 +151,159 @@ void markOne ( GridType & grid , int num , int ref )
   grid.postAdapt();
 }
 
+/* Refine the elements around a vertex a few times and coarsen them again.
+   After each step the leaf indices, which UGGrid updates incrementally, must
+   be consecutive for each geometry type and the same on all elements
+   containing an entity, and so must the level indices of the elements. */
+template <class GridType>
+void checkIndicesAfterLocalAdaptation(GridType& grid)
+{
+  const int dim = GridType::dimension;
+  const auto center = grid.levelGridView(0).template begin<dim>()->geometry().corner(0);
+
+  auto checkLeafIndices = [&grid]()
+  {
+    const auto& indexSet = grid.leafIndexSet();
+    const auto& idSet = grid.globalIdSet();
+    typedef typename GridType::Traits::GlobalIdSet::IdType IdType;
+
+    for (int codim=0; codim<=dim; codim++)
+    {
+      std::map<IdType, unsigned int> indexOfId;
+      std::map<GeometryType, std::set<unsigned int> > indices;
+      for (const auto& element : elements(grid.leafGridView()))
+      {
+        const auto& refElement = ReferenceElements<double,dim>::general(element.type());
+        for (int i=0; i<refElement.size(codim); i++)
+        {
+          unsigned int index = indexSet.subIndex(element, i, codim);
+          auto entry = indexOfId.insert(std::make_pair(idSet.subId(element, i, codim), index));
+          if (entry.first->second != index)
+            DUNE_THROW(GridError, "Two leaf indices for one entity of codimension " << codim);
+          indices[refElement.type(i, codim)].insert(index);
+        }
+      }
+
+      std::size_t entities = 0;
+      for (const auto& type : indices)
+      {
+        if (type.second.size() != std::size_t(indexSet.size(type.first)) || *type.second.rbegin() >= type.second.size())
+          DUNE_THROW(GridError, "The leaf indices of the " << type.first << " are not consecutive");
+        entities += type.second.size();
+      }
+      if (entities != indexOfId.size())
+        DUNE_THROW(GridError, "One leaf index for several entities of codimension " << codim);
+    }
+  };
+
+  // The level index sets are computed on demand after each grid change
+  auto checkLevelIndices = [&grid]()
+  {
+    for (int level=0; level<=grid.maxLevel(); level++)
+    {
+      const auto& indexSet = grid.levelIndexSet(level);
+      std::set<unsigned int> indices;
+      for (const auto& element : elements(grid.levelGridView(level)))
+        indices.insert(indexSet.index(element));
+      if (indices.size() != std::size_t(indexSet.size(0)) || (!indices.empty() && *indices.rbegin() >= indices.size()))
+        DUNE_THROW(GridError, "The element indices of level " << level << " are not consecutive");
+    }
+  };
+
+  // A mapper keeps a reference to the level index set, which has to bring itself up to date
+  typedef MultipleCodimMultipleGeomTypeMapper<typename GridType::LevelGridView, MCMGElementLayout> LevelMapper;
+  std::unique_ptr<LevelMapper> levelMapper;
+  auto checkLevelMapper = [&grid, &levelMapper]()
+  {
+    if (grid.maxLevel() < 1)
+      return;
+    if (levelMapper)
+      levelMapper->update();
+    else
+      levelMapper.reset(new LevelMapper(grid.levelGridView(1)));
+
+    std::set<std::size_t> indices;
+    for (const auto& element : elements(grid.levelGridView(1)))
+      indices.insert(levelMapper->index(element));
+    if (indices.size() != std::size_t(levelMapper->size()) || (!indices.empty() && *indices.rbegin() >= indices.size()))
+      DUNE_THROW(GridError, "The mapper of level 1 is not up to date after adaptation");
+  };
+
+  auto adaptAroundCenter = [&grid, &center](int refCount)
+  {
+    for (const auto& element : elements(grid.leafGridView()))
+      for (int i=0; i<element.geometry().corners(); i++)
+        if ((element.geometry().corner(i) - center).two_norm() < 1e-8)
+          grid.mark(refCount, element);
+    grid.preAdapt();
+    grid.adapt();
+    grid.postAdapt();
+  };
+
+  // The leaf indices of the entities far away from the adapted region must not change.
+  // Record them before each step and compare them afterwards.
+  typedef typename GridType::Traits::GlobalIdSet::IdType IdType;
+  std::vector<std::map<IdType, unsigned int> > farIndices(dim+1);
+  auto forFarEntities = [&grid, &center](auto&& f)
+  {
+    for (const auto& element : elements(grid.leafGridView()))
+    {
+      bool far = true;
+      for (int i=0; i<element.geometry().corners(); i++)
+        far = far && (element.geometry().corner(i) - center).two_norm() > 0.5;
+      if (!far)
+        continue;
+      for (int codim=0; codim<=dim; codim++)
+        for (unsigned int i=0; i<element.subEntities(codim); i++)
+          f(codim, grid.globalIdSet().subId(element, i, codim), grid.leafIndexSet().subIndex(element, i, codim));
+    }
+  };
+  auto recordFarIndices = [&]()
+  {
+    for (auto& indices : farIndices)
+      indices.clear();
+    forFarEntities([&farIndices](int codim, const IdType& id, unsigned int index) {
+      farIndices[codim][id] = index;
+    });
+  };
+  auto checkFarIndices = [&]()
+  {
+    std::size_t found = 0;
+    forFarEntities([&farIndices, &found](int codim, const IdType& id, unsigned int index) {
+      auto entry = farIndices[codim].find(id);
+      if (entry == farIndices[codim].end())
+        return;
+      if (entry->second != index)
+        DUNE_THROW(GridError, "The leaf index of an entity of codimension " << codim << " far from the adapted region changed");
+      found++;
+    });
+    std::size_t recorded = 0;
+    for (const auto& indices : farIndices)
+      recorded += indices.size();
+    if (found == 0 || found < recorded)
+      DUNE_THROW(GridError, "The entities far from the adapted region are not leaf entities anymore");
+  };
+
+  for (int i=0; i<3; i++)
+  {
+    recordFarIndices();
+    adaptAroundCenter(1);
+    checkLevelMapper();
+    checkLeafIndices();
+    checkLevelIndices();
+    checkFarIndices();
+  }
+  for (int i=0; i<3; i++)
+  {
+    recordFarIndices();
+    adaptAroundCenter(-1);
+    checkLevelMapper();
+    checkLeafIndices();
+    checkLevelIndices();
+    checkFarIndices();
+  }
+}
+
 void generalTests(bool greenClosure)
 {
   // /////////////////////////////////////////////////////////////////
@@ -234,6 +392,12 @@ void generalTests(bool greenClosure)
   for( int i = 0; i <= grid3d->maxLevel(); ++i )
     checkPartitionType( grid3d->levelGridView( i ) );
 
+  // check the incremental update of the leaf indices
+  checkIndicesAfterLocalAdaptation(*grid2d);
+  checkIndicesAfterLocalAdaptation(*grid3d);
+  gridcheck(*grid2d);
+  gridcheck(*grid3d);
+
 }
 
 int main (int argc , char **argv) try
@@ -253,6 +417,13 @@ int main (int argc , char **argv) try
   std::cout << "Testing UGGrid<2> and UGGrid<3> with nonconforming refinement" << std::endl;
   generalTests(false);
 
+  // ////////////////////////////////////////////////////////////////////////
+  //   Check the bulk insertion of vertices and elements into the factory
+  // ////////////////////////////////////////////////////////////////////////
+  std::cout << "Testing bulk insertion into the GridFactory of UGGrid<2> and UGGrid<3>" << std::endl;
+  Dune::checkBulkInsertion<Dune::UGGrid<2> >(Dune::TestGrids::hybrid2d);
+  Dune::checkBulkInsertion<Dune::UGGrid<3> >(Dune::TestGrids::hybrid3d);
+
   // ////////////////////////////////////////////////////////////////////////////
   //   Test whether I can create a grid with explict boundary segment ordering,
   //   but not parametrization functions (only 2d, so far)
@@ -24,6 +24,19 @@ int main (int argc , char **argv) {
     // Test again with refinement
     check_backuprestore(YaspFactory<2,Dune::EquidistantCoordinates<double,2> >::buildGrid(true, 1));
 
+    // Test again with ghost cells instead of overlap cells
+    Dune::YaspGridOptions<2> options;
+    options.halo = Dune::YaspHalo::ghost;
+    std::array<int,2> s = {{8, 8}};
+    check_backuprestore(new Dune::YaspGrid<2>(Dune::FieldVector<double,2>(1.0), s, std::bitset<2>(0), 1,
+                                              Dune::YaspGrid<2>::CollectiveCommunicationType(), options));
+
+    // Test again with a space filling curve ordering
+    options.halo = Dune::YaspHalo::overlap;
+    options.ordering = Dune::YaspOrdering::hilbert;
+    check_backuprestore(new Dune::YaspGrid<2>(Dune::FieldVector<double,2>(1.0), s, std::bitset<2>(0), 1,
+                                              Dune::YaspGrid<2>::CollectiveCommunicationType(), options));
+
   } catch (Dune::Exception &e) {
     std::cerr << e << std::endl;
     return 1;
@@ -29,6 +29,38 @@ int main (int argc , char **argv) {
       check_yasp(YaspFactory<2,Dune::TensorProductCoordinates<double,2> >::buildGrid(refineOpt == 1, 1));
     }
 
+    // Communication with neighborhood collectives or shared memory, and ranks placed by node
+    check_yasp_torus<2>(Dune::TorusBackend::neighborhood, Dune::TorusMapping::node);
+    check_yasp_torus<2>(Dune::TorusBackend::sharedMemory, Dune::TorusMapping::lexicographic);
+
+    // Partitioning by a cost field
+    check_yasp_weighted<2>();
+
+    // Halo cells as ghosts
+    check_yasp_ghosts<2>();
+
+    // Several data handles in one exchange
+    check_yasp_fused<2>();
+
+    // Index maps for multigrid transfer
+    check_yasp_level_transfer<2>(Dune::YaspOrdering::lexicographic);
+    check_yasp_level_transfer<2>(Dune::YaspOrdering::hilbert);
+
+    // Extents known at compile time
+    check_yasp_static<2>();
+
+    // Block-structured local refinement
+    check_yasp_patches<2>();
+
+    // Cells and vertices numbered along space filling curves
+    check_yasp_ordering<2>(Dune::YaspOrdering::morton);
+    check_yasp_ordering<2>(Dune::YaspOrdering::hilbert);
+
+    // Repartitioning with data migration
+    check_yasp_repartition<2,Dune::EquidistantCoordinates<double,2> >();
+    check_yasp_repartition<2,Dune::EquidistantOffsetCoordinates<double,2> >();
+    check_yasp_repartition<2,Dune::TensorProductCoordinates<double,2> >();
+
     // And periodicity
 //    check_yasp(YaspFactory<2,Dune::EquidistantCoordinates<double,2> >::buildGrid(true, 0, true));
 //    check_yasp(YaspFactory<2,Dune::EquidistantOffsetCoordinates<double,2> >::buildGrid(true, 0, true));
@@ -22,6 +22,28 @@ int main (int argc , char **argv) {
     check_yasp(YaspFactory<3,Dune::EquidistantOffsetCoordinates<double,3> >::buildGrid());
     check_yasp(YaspFactory<3,Dune::TensorProductCoordinates<double,3> >::buildGrid());
 
+    // Halo cells as ghosts
+    check_yasp_ghosts<3>();
+
+    // Several data handles in one exchange
+    check_yasp_fused<3>();
+
+    // Index maps for multigrid transfer
+    check_yasp_level_transfer<3>(Dune::YaspOrdering::lexicographic);
+    check_yasp_level_transfer<3>(Dune::YaspOrdering::hilbert);
+
+    // Extents known at compile time
+    check_yasp_static<3>();
+
+    // Block-structured local refinement
+    check_yasp_patches<3>();
+
+    // Cells and vertices numbered along space filling curves
+    check_yasp_ordering<3>(Dune::YaspOrdering::hilbert);
+
+    // 4096^3 cells do not fit into int local indices on one process
+    check_yasp_localoverflow<3>();
+
   } catch (Dune::Exception &e) {
     std::cerr << e << std::endl;
     return 1;
@@ -3,6 +3,13 @@
 #ifndef DUNE_GRID_TEST_TEST_YASPGRID_HH
 #define DUNE_GRID_TEST_TEST_YASPGRID_HH
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
 #include <dune/grid/yaspgrid.hh>
 
 #include <dune/grid/test/gridcheck.hh>
@@ -121,6 +128,340 @@ struct YaspFactory<dim, Dune::TensorProductCoordinates<double,dim> >
   }
 };
 
+// communicates one value per cell, used to check the split-phase communication
+template<class GridView>
+class YaspCellDataHandle
+  : public Dune::CommDataHandleIF<YaspCellDataHandle<GridView>, double>
+{
+public:
+  YaspCellDataHandle (const GridView& gv, std::vector<double>& data)
+    : _gv(gv), _data(data)
+  {}
+
+  bool contains (int dim, int codim) const { return codim == 0; }
+  bool fixedSize (int dim, int codim) const { return true; }
+
+  template<class E>
+  std::size_t size (const E& e) const { return 1; }
+
+  template<class Buf, class E>
+  void gather (Buf& buf, const E& e) const
+  {
+    buf.write(_data[_gv.indexSet().index(e)]);
+  }
+
+  template<class Buf, class E>
+  void scatter (Buf& buf, const E& e, std::size_t n)
+  {
+    buf.read(_data[_gv.indexSet().index(e)]);
+  }
+
+private:
+  const GridView& _gv;
+  std::vector<double>& _data;
+};
+
+// communicates a varying number of copies of one value per vertex, or a given number if uniform is not zero
+template<class GridView>
+class YaspVertexDataHandle
+  : public Dune::CommDataHandleIF<YaspVertexDataHandle<GridView>, double>
+{
+public:
+  YaspVertexDataHandle (const GridView& gv, std::vector<double>& data, std::size_t uniform = 0)
+    : _gv(gv), _data(data), _uniform(uniform)
+  {}
+
+  bool contains (int dim, int codim) const { return codim == dim; }
+  bool fixedSize (int dim, int codim) const { return false; }
+
+  template<class E>
+  std::size_t size (const E& e) const { return _uniform ? _uniform : 1 + _gv.indexSet().index(e) % 3; }
+
+  template<class Buf, class E>
+  void gather (Buf& buf, const E& e) const
+  {
+    for (std::size_t i=0; i<size(e); i++)
+      buf.write(_data[_gv.indexSet().index(e)]);
+  }
+
+  template<class Buf, class E>
+  void scatter (Buf& buf, const E& e, std::size_t n)
+  {
+    for (std::size_t i=0; i<n; i++)
+      buf.read(_data[_gv.indexSet().index(e)]);
+  }
+
+private:
+  const GridView& _gv;
+  std::vector<double>& _data;
+  std::size_t _uniform;
+};
+
+// a value that identifies a cell by its center
+template<class Entity>
+double yaspCellValue (const Entity& e)
+{
+  auto c = e.geometry().center();
+  double v = 0.0, w = 1.0;
+  for (std::size_t i=0; i<c.size(); i++, w*=10.0)
+    v += w*c[i];
+  return v;
+}
+
+// check that communicateBegin() followed by wait() or test() distributes interior data
+template <class GridView>
+void check_yasp_splitphase(const GridView& gv, bool poll)
+{
+  std::vector<double> data(gv.size(0), -1.0);
+  for (const auto& e : elements(gv, Dune::Partitions::interior))
+    data[gv.indexSet().index(e)] = yaspCellValue(e);
+
+  YaspCellDataHandle<GridView> handle(gv, data);
+  auto comm = gv.communicateBegin(handle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+
+  // the same communication may not be started again while it is in flight
+  std::vector<double> other(data);
+  YaspCellDataHandle<GridView> otherHandle(gv, other);
+  bool rejected = false;
+  try {
+    gv.communicateBegin(otherHandle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication).wait();
+  }
+  catch (Dune::InvalidStateException&) {
+    rejected = true;
+  }
+  if (!rejected)
+    DUNE_THROW(Dune::Exception, "a communication was started twice while in flight");
+
+  if (poll)
+    while (!comm.test()) ;
+  else
+    comm.wait();
+  if (!comm.ready())
+    DUNE_THROW(Dune::Exception, "split-phase communication not complete after wait()");
+
+  for (const auto& e : elements(gv))
+    if (std::abs(data[gv.indexSet().index(e)] - yaspCellValue(e)) > 1e-8)
+      DUNE_THROW(Dune::Exception, "split-phase communication delivered wrong data");
+}
+
+// check that communicateVector() distributes interior data of an index ordered array
+template <int dim, class CC>
+void check_yasp_vector(const Dune::YaspGrid<dim,CC>& grid)
+{
+  auto gv = grid.leafGridView();
+  std::vector<double> data(2*gv.size(0), -1.0);
+  for (const auto& e : elements(gv, Dune::Partitions::interior))
+  {
+    data[2*gv.indexSet().index(e)] = yaspCellValue(e);
+    data[2*gv.indexSet().index(e)+1] = -yaspCellValue(e);
+  }
+
+  grid.communicateVector(data.data(), 2, 0, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+
+  for (const auto& e : elements(gv))
+    if (std::abs(data[2*gv.indexSet().index(e)] - yaspCellValue(e)) > 1e-8
+        || std::abs(data[2*gv.indexSet().index(e)+1] + yaspCellValue(e)) > 1e-8)
+      DUNE_THROW(Dune::Exception, "communicateVector delivered wrong data");
+}
+
+// check that variable size data is communicated, both with differing sizes per entity
+// and with the same size for all entities, whose size headers are run length encoded
+template <class GridView>
+void check_yasp_variable(const GridView& gv)
+{
+  const int dim = GridView::dimension;
+  for (std::size_t uniform : {0, 2})
+  {
+    std::vector<double> data(gv.size(dim), -1.0);
+    for (const auto& v : vertices(gv, Dune::Partitions::interiorBorder))
+      data[gv.indexSet().index(v)] = yaspCellValue(v);
+
+    YaspVertexDataHandle<GridView> handle(gv, data, uniform);
+    gv.communicate(handle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+
+    for (const auto& v : vertices(gv))
+      if (std::abs(data[gv.indexSet().index(v)] - yaspCellValue(v)) > 1e-8)
+        DUNE_THROW(Dune::Exception, "variable size communication delivered wrong data"
+                   << (uniform ? " for a uniform size" : ""));
+  }
+}
+
+// check that several data handles of different codims and sizes are communicated in one exchange
+template <int dim>
+void check_yasp_fused()
+{
+  Dune::FieldVector<double,dim> Len(1.0);
+  std::array<int,dim> s;
+  std::fill(s.begin(), s.end(), 8);
+  Dune::YaspGrid<dim> grid(Len, s, std::bitset<dim>(0ULL), 1);
+  grid.globalRefine(1);
+
+  auto gv = grid.leafGridView();
+  typedef decltype(gv) GridView;
+  std::vector<double> cells(gv.size(0), -1.0), negated(gv.size(0), 1.0), verts(gv.size(dim), -1.0);
+  for (const auto& e : elements(gv, Dune::Partitions::interior))
+  {
+    cells[gv.indexSet().index(e)] = yaspCellValue(e);
+    negated[gv.indexSet().index(e)] = -yaspCellValue(e);
+  }
+  for (const auto& v : vertices(gv, Dune::Partitions::interiorBorder))
+    verts[gv.indexSet().index(v)] = yaspCellValue(v);
+
+  // two handles of the same type and a variable size one
+  YaspCellDataHandle<GridView> first(gv, cells), second(gv, negated);
+  YaspVertexDataHandle<GridView> third(gv, verts);
+  grid.communicate(std::tie(first, second, third), Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+
+  for (const auto& e : elements(gv))
+    if (std::abs(cells[gv.indexSet().index(e)] - yaspCellValue(e)) > 1e-8
+        || std::abs(negated[gv.indexSet().index(e)] + yaspCellValue(e)) > 1e-8)
+      DUNE_THROW(Dune::Exception, "fused communication delivered wrong cell data");
+  for (const auto& v : vertices(gv))
+    if (std::abs(verts[gv.indexSet().index(v)] - yaspCellValue(v)) > 1e-8)
+      DUNE_THROW(Dune::Exception, "fused communication delivered wrong vertex data");
+}
+
+// check that the global indices number the entities of each level consecutively
+template <int dim, class CC>
+void check_yasp_globalindex(const Dune::YaspGrid<dim,CC>& grid)
+{
+  typedef typename Dune::YaspGrid<dim,CC>::GlobalIndexType GlobalIndexType;
+  for (int l=0; l<=grid.maxLevel(); l++)
+  {
+    auto gv = grid.levelGridView(l);
+
+    // every cell is interior on exactly one process
+    std::vector<GlobalIndexType> indices;
+    for (const auto& e : elements(gv, Dune::Partitions::interior))
+      indices.push_back(grid.globalIndex(e));
+    std::sort(indices.begin(), indices.end());
+    if (std::unique(indices.begin(), indices.end()) != indices.end())
+      DUNE_THROW(Dune::Exception, "globalIndex() is not unique");
+    if (!indices.empty() && (indices.front() < 0 || indices.back() >= grid.globalCount(l,0)))
+      DUNE_THROW(Dune::Exception, "globalIndex() out of range");
+    if (grid.comm().sum(long(indices.size())) != grid.globalCount(l,0))
+      DUNE_THROW(Dune::Exception, "globalCount() does not match the number of cells");
+
+    for (const auto& v : vertices(gv))
+      if (grid.globalIndex(v) < 0 || grid.globalIndex(v) >= grid.globalCount(l,dim))
+        DUNE_THROW(Dune::Exception, "globalIndex() of a vertex out of range");
+  }
+}
+
+// check the batches of YaspStructuredAccess::forEachBatch() against the cells of a partition
+template <Dune::PartitionIteratorType pitype, class GridView, class Access>
+void check_yasp_batches(const GridView& gv, const Access& s)
+{
+  const int dim = GridView::dimension;
+  std::vector<int> expected, visited;
+  for (const auto& e : elements(gv, Dune::Partitions::all))
+    if (Dune::partitionSet<pitype>().contains(e.partitionType()))
+      expected.push_back(gv.indexSet().index(e));
+
+  std::vector<std::array<double,2*dim> > boxes(gv.size(0));
+  for (const auto& e : elements(gv))
+    for (int i=0; i<dim; i++)
+    {
+      boxes[gv.indexSet().index(e)][i] = e.geometry().corner(0)[i];
+      boxes[gv.indexSet().index(e)][dim+i] = e.geometry().corner((1<<dim)-1)[i] - e.geometry().corner(0)[i];
+    }
+
+  s.template forEachBatch<4>(pitype, [&](const Dune::YaspCellBatch<double,dim,4>& batch)
+  {
+    if (batch.size() < 1 || batch.size() > 4)
+      DUNE_THROW(Dune::Exception, "batch has a wrong size");
+    for (int j=0; j<4; j++)
+    {
+      const int k = batch.index[j];
+      if (j >= batch.size() && k != batch.index[batch.size()-1])
+        DUNE_THROW(Dune::Exception, "padding lanes of a batch do not repeat the last cell");
+      for (int i=0; i<dim; i++)
+        if (std::abs(batch.lowerLeft[i][j] - boxes[k][i]) > 1e-8 || std::abs(batch.extent[i][j] - boxes[k][dim+i]) > 1e-8)
+          DUNE_THROW(Dune::Exception, "batch has wrong coordinates");
+      if (j < batch.size())
+        visited.push_back(k);
+    }
+  });
+
+  std::sort(expected.begin(), expected.end());
+  std::sort(visited.begin(), visited.end());
+  if (expected != visited)
+    DUNE_THROW(Dune::Exception, "batches do not visit the cells of the partition");
+}
+
+// check that YaspStructuredAccess describes the cells and neighbors of the index sets
+template <int dim, class CC>
+void check_yasp_structured(const Dune::YaspGrid<dim,CC>& grid)
+{
+  typedef Dune::YaspGrid<dim,CC> Grid;
+  for (int l=0; l<=grid.maxLevel(); l++)
+  {
+    auto gv = grid.levelGridView(l);
+    Dune::YaspStructuredAccess<Grid> s(grid, l);
+    if (s.count() != gv.size(0))
+      DUNE_THROW(Dune::Exception, "YaspStructuredAccess has a wrong number of cells");
+
+    for (const auto& e : elements(gv))
+    {
+      const int k = gv.indexSet().index(e);
+      const auto c = s.coord(k);
+      if (!s.contains(c) || s.index(c) != k)
+        DUNE_THROW(Dune::Exception, "YaspStructuredAccess has wrong cell coordinates");
+
+      bool interior = true;
+      for (int i=0; i<dim; i++)
+        interior = interior && (c[i] >= s.interiorBegin(i)) && (c[i] < s.interiorEnd(i));
+      if (interior != (e.partitionType() == Dune::InteriorEntity))
+        DUNE_THROW(Dune::Exception, "YaspStructuredAccess has a wrong interior");
+
+      for (const auto& is : intersections(gv, e))
+      {
+        const int i = is.indexInInside()/2;
+        if (std::abs(e.geometry().corner(0)[i] - e.geometry().corner((1<<dim)-1)[i] + s.meshsize(i,c[i])) > 1e-8)
+          DUNE_THROW(Dune::Exception, "YaspStructuredAccess has a wrong mesh size");
+        if (!is.neighbor())
+          continue;
+        const int offset = (is.indexInInside()%2) ? 1 : -1;
+        auto nc = c;
+        nc[i] += offset;
+        if (s.contains(nc) && gv.indexSet().index(is.outside()) != s.neighbor(k,i,offset))
+          DUNE_THROW(Dune::Exception, "YaspStructuredAccess has a wrong neighbor");
+      }
+    }
+  }
+
+  // the leaf view is the finest level
+  Dune::YaspStructuredAccess<Grid> leaf(grid);
+  auto gv = grid.leafGridView();
+  if (leaf.level() != grid.maxLevel() || leaf.count() != gv.size(0))
+    DUNE_THROW(Dune::Exception, "YaspStructuredAccess of the leaf grid is wrong");
+
+  // batches of cells visit the same cells as the iterators of the partitions
+  check_yasp_batches<Dune::Interior_Partition>(gv, leaf);
+  check_yasp_batches<Dune::All_Partition>(gv, leaf);
+}
+
+// check that a grid with more entities per process than local indices can address is rejected
+template <int dim>
+void check_yasp_localoverflow()
+{
+  if (Dune::MPIHelper::getCollectiveCommunication().size() > 1)
+    return;
+
+  Dune::FieldVector<double,dim> Len(1.0);
+  std::array<int,dim> s;
+  std::fill(s.begin(), s.end(), 4096);
+  try
+  {
+    Dune::YaspGrid<dim> grid(Len, s);
+  }
+  catch (Dune::GridError&)
+  {
+    return;
+  }
+  DUNE_THROW(Dune::Exception, "YaspGrid accepted a grid that overflows its local indices");
+}
+
 template <int dim, class CC>
 void check_yasp(Dune::YaspGrid<dim,CC>* grid) {
   std::cout << std::endl << "YaspGrid<" << dim << ">";
@@ -138,6 +479,14 @@ void check_yasp(Dune::YaspGrid<dim,CC>* grid) {
   // check communication correctness
   Dune::GridCheck::check_communication_correctness(grid->leafGridView());
 
+  // check split-phase communication
+  check_yasp_splitphase(grid->leafGridView(), false);
+  check_yasp_splitphase(grid->levelGridView(0), true);
+  check_yasp_vector(*grid);
+  check_yasp_variable(grid->leafGridView());
+  check_yasp_globalindex(*grid);
+  check_yasp_structured(*grid);
+
   // check geometry lifetime
   checkGeometryLifetime( grid->leafGridView() );
   // check the method geometryInFather()
@@ -158,6 +507,630 @@ void check_yasp(Dune::YaspGrid<dim,CC>* grid) {
   delete grid;
 }
 
+// check the communication of a grid using the given backend and rank placement of the torus
+template <int dim>
+void check_yasp_torus(Dune::TorusBackend backend, Dune::TorusMapping mapping)
+{
+  Dune::FieldVector<double,dim> Len(1.0);
+  std::array<int,dim> s;
+  std::fill(s.begin(), s.end(), 8);
+  std::bitset<dim> p(0);
+  p[0] = true;
+
+  typedef Dune::YaspGrid<dim> Grid;
+  Grid grid(Len, s, p, 1, typename Grid::CollectiveCommunicationType(),
+            Grid::defaultLoadbalancer(), backend, mapping);
+  grid.globalRefine(1);
+
+  const auto& torus = grid.torus();
+  for (int r=0; r<torus.procs(); r++)
+    if (torus.coord_to_rank(torus.rank_to_coord(r)) != r)
+      DUNE_THROW(Dune::Exception, "node mapping of the torus is not a permutation");
+  if (torus.mapping() == Dune::TorusMapping::node
+      && (torus.internodeHaloFraction() < 0.0 || torus.internodeHaloFraction() > 1.0))
+    DUNE_THROW(Dune::Exception, "invalid inter-node halo fraction");
+
+  checkCommunication(grid,-1,Dune::dvverb);
+  Dune::GridCheck::check_communication_correctness(grid.leafGridView());
+  check_yasp_splitphase(grid.leafGridView(), false);
+  check_yasp_splitphase(grid.levelGridView(0), true);
+  check_yasp_vector(grid);
+}
+
+// check a grid partitioned by a cost field that is higher near the lower left corner
+template <int dim>
+void check_yasp_weighted()
+{
+  std::array<int,dim> s;
+  std::fill(s.begin(), s.end(), 8);
+  int cells = 1;
+  for (int i=0; i<dim; i++)
+    cells *= s[i];
+
+  std::vector<double> cost(cells, 1.0);
+  for (int c=0; c<cells; c++)
+  {
+    bool corner = true;
+    for (int i=0, cc=c; i<dim; i++, cc/=s[0])
+      corner = corner && (cc%s[0] < 2);
+    if (corner)
+      cost[c] = 10.0;
+  }
+  Dune::YaspWeightedPartitioner<dim> lb(s, cost);
+
+  typedef Dune::YaspGrid<dim> Grid;
+  Dune::FieldVector<double,dim> Len(1.0);
+
+  // the maximum over all processes of the cost of the interior cells
+  auto maxCost = [&](const Grid& grid)
+  {
+    double sum = 0.0;
+    for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior))
+    {
+      const auto center = element.geometry().center();
+      int c = 0;
+      for (int i=dim-1; i>=0; i--)
+        c = c*s[i] + int(center[i]*s[i]/Len[i]);
+      sum += cost[c];
+    }
+    return grid.comm().max(sum);
+  };
+
+  // the weighted partition must not be worse than the default one
+  Grid weighted(Len, s, std::bitset<dim>(0ULL), 1, typename Grid::CollectiveCommunicationType(), &lb);
+  Grid unweighted(Len, s, std::bitset<dim>(0ULL), 1);
+  if (maxCost(weighted) > maxCost(unweighted))
+    DUNE_THROW(Dune::Exception, "weighted partition has a higher maximum cost per process than the default one");
+
+  check_yasp(new Grid(Len, s, std::bitset<dim>(0ULL), 1, typename Grid::CollectiveCommunicationType(), &lb));
+
+  // the grid keeps a copy of the partitioner, which may be gone before loadBalance()
+  std::unique_ptr<Grid> grid;
+  {
+    Dune::YaspWeightedPartitioner<dim> temporary(s, cost);
+    grid.reset(new Grid(Len, s, std::bitset<dim>(0ULL), 1, typename Grid::CollectiveCommunicationType(), &temporary));
+  }
+  if (grid->loadBalance())
+    DUNE_THROW(Dune::Exception, "loadBalance() with the partitioner given at construction changed the partition");
+
+  // a partitioner without its own clone() cannot be kept, loadBalance() must not replace it
+  struct NoClonePartitioner : public Dune::YLoadBalanceDefault<dim> {};
+  NoClonePartitioner noClone;
+  Grid gridWithoutClone(Len, s, std::bitset<dim>(0ULL), 1, typename Grid::CollectiveCommunicationType(), &noClone);
+  bool thrown = false;
+  try {
+    gridWithoutClone.loadBalance();
+  } catch (const Dune::GridError&) {
+    thrown = true;
+  }
+  if (!thrown)
+    DUNE_THROW(Dune::Exception, "loadBalance() did not reject a partitioner it could not keep");
+}
+
+// check that a partition is traversed in increasing index order
+template <int codim, Dune::PartitionIteratorType pitype, class GridView>
+void check_yasp_traversal_order(const GridView& gv)
+{
+  int previous = -1;
+  int count = 0;
+  for (const auto& e : entities(gv, Dune::Codim<codim>(), Dune::partitionSet<pitype>()))
+  {
+    const int k = gv.indexSet().index(e);
+    if (k <= previous)
+      DUNE_THROW(Dune::Exception, "entities are not traversed in the order of the index set");
+    previous = k;
+    count++;
+  }
+  if (pitype == Dune::All_Partition && count != gv.size(codim))
+    DUNE_THROW(Dune::Exception, "traversal misses entities of codim " << codim);
+}
+
+// check the numbering of cells and vertices along a space filling curve
+template <int dim>
+void check_yasp_ordering(Dune::YaspOrdering ordering)
+{
+  Dune::FieldVector<double,dim> Len(1.0);
+  std::array<int,dim> s;
+  std::fill(s.begin(), s.end(), 6);
+
+  typedef Dune::YaspGrid<dim> Grid;
+  Grid grid(Len, s, std::bitset<dim>(0ULL), 1, typename Grid::CollectiveCommunicationType(),
+            Grid::defaultLoadbalancer(), Dune::TorusBackend::pointToPoint, Dune::TorusMapping::lexicographic, ordering);
+  grid.globalRefine(1);
+  if (grid.ordering() != ordering)
+    DUNE_THROW(Dune::Exception, "YaspGrid does not store its ordering");
+
+  gridcheck(grid);
+  checkIterators(grid.leafGridView());
+  checkCommunication(grid,-1,Dune::dvverb);
+  Dune::GridCheck::check_communication_correctness(grid.leafGridView());
+  check_yasp_vector(grid);
+
+  for (int l=0; l<=grid.maxLevel(); l++)
+  {
+    auto gv = grid.levelGridView(l);
+    check_yasp_traversal_order<0,Dune::All_Partition>(gv);
+    check_yasp_traversal_order<0,Dune::Interior_Partition>(gv);
+    check_yasp_traversal_order<dim,Dune::All_Partition>(gv);
+    check_yasp_traversal_order<dim,Dune::InteriorBorder_Partition>(gv);
+    check_yasp_traversal_order<dim,Dune::Overlap_Partition>(gv);
+
+    // subindices of the vertices agree with the index of the vertices
+    for (const auto& e : elements(gv))
+      for (unsigned int i=0; i<e.subEntities(dim); i++)
+        if (gv.indexSet().subIndex(e,i,dim) != gv.indexSet().index(e.template subEntity<dim>(i)))
+          DUNE_THROW(Dune::Exception, "subIndex() of a vertex does not match its index");
+  }
+
+  // building the levels with several threads gives the same numbering
+  Grid threaded(Len, s, std::bitset<dim>(0ULL), 1, typename Grid::CollectiveCommunicationType(),
+                Grid::defaultLoadbalancer(), Dune::TorusBackend::pointToPoint, Dune::TorusMapping::lexicographic,
+                ordering, Dune::YaspHalo::overlap, 3);
+  threaded.setThreads(2);
+  threaded.globalRefine(1);
+  for (int l=0; l<=grid.maxLevel(); l++)
+  {
+    auto gv = grid.levelGridView(l);
+    auto tgv = threaded.levelGridView(l);
+    auto it = elements(tgv).begin();
+    for (const auto& e : elements(gv))
+    {
+      if (gv.indexSet().index(e) != tgv.indexSet().index(*it))
+        DUNE_THROW(Dune::Exception, "the numbering of the cells depends on the number of threads");
+      for (unsigned int i=0; i<e.subEntities(dim); i++)
+        if (gv.indexSet().subIndex(e,i,dim) != tgv.indexSet().subIndex(*it,i,dim))
+          DUNE_THROW(Dune::Exception, "the numbering of the vertices depends on the number of threads");
+      ++it;
+    }
+  }
+
+  // on a sequential power of two box consecutive cells of the Hilbert curve are neighbors
+  if (ordering == Dune::YaspOrdering::hilbert && grid.comm().size() == 1)
+  {
+    std::array<int,dim> cube;
+    std::fill(cube.begin(), cube.end(), 8);
+    Grid cubeGrid(Len, cube, std::bitset<dim>(0ULL), 1, typename Grid::CollectiveCommunicationType(),
+                  Grid::defaultLoadbalancer(), Dune::TorusBackend::pointToPoint, Dune::TorusMapping::lexicographic, ordering);
+    auto gv = cubeGrid.leafGridView();
+    std::vector<Dune::FieldVector<double,dim> > centers(gv.size(0));
+    for (const auto& e : elements(gv))
+      centers[gv.indexSet().index(e)] = e.geometry().center();
+    const double h = Len[0]/cube[0];
+    for (std::size_t k=1; k<centers.size(); k++)
+      if ((centers[k] - centers[k-1]).two_norm() > 1.5*h)
+        DUNE_THROW(Dune::Exception, "consecutive cells on the Hilbert curve are not neighbors");
+  }
+
+  // the structured access needs the lexicographic numbering
+  try
+  {
+    Dune::YaspStructuredAccess<Grid> access(grid);
+  }
+  catch (Dune::GridError&)
+  {
+    return;
+  }
+  DUNE_THROW(Dune::Exception, "YaspStructuredAccess accepted a grid numbered along a curve");
+}
+
+// check a grid whose halo cells are ghosts
+template <int dim>
+void check_yasp_ghosts()
+{
+  Dune::FieldVector<double,dim> Len(1.0);
+  std::array<int,dim> s;
+  std::fill(s.begin(), s.end(), 8);
+
+  typedef Dune::YaspGrid<dim> Grid;
+  Dune::YaspGridOptions<dim> options;
+  options.halo = Dune::YaspHalo::ghost;
+  Grid grid(Len, s, std::bitset<dim>(0ULL), 1, typename Grid::CollectiveCommunicationType(), options);
+  grid.globalRefine(1);
+  if (grid.halo() != Dune::YaspHalo::ghost || grid.overlapSize(0) != 0 || grid.ghostSize(0,0) != 1)
+    DUNE_THROW(Dune::Exception, "YaspGrid with ghost halo reports wrong overlap or ghost size");
+
+  gridcheck(grid);
+  checkIterators(grid.leafGridView());
+  checkIterators(grid.levelGridView(0));
+  checkCommunication(grid,-1,Dune::dvverb);
+  Dune::GridCheck::check_communication_correctness(grid.leafGridView());
+  checkPartitionType(grid.leafGridView());
+  checkPartitionType(grid.levelGridView(0));
+  check_yasp_splitphase(grid.leafGridView(), false);
+  check_yasp_vector(grid);
+
+  auto gv = grid.leafGridView();
+
+  // there are no overlap and front entities, the halo cells are ghosts
+  int cells = 0, interior = 0, ghosts = 0;
+  for (const auto& e : elements(gv))
+  {
+    cells++;
+    if (e.partitionType() != Dune::InteriorEntity && e.partitionType() != Dune::GhostEntity)
+      DUNE_THROW(Dune::Exception, "cell of a ghost halo grid is neither interior nor ghost");
+  }
+  for (const auto& e : elements(gv, Dune::Partitions::interior))
+    interior += (e.partitionType() == Dune::InteriorEntity);
+  for (const auto& e : elements(gv, Dune::Partitions::ghost))
+    ghosts += (e.partitionType() == Dune::GhostEntity);
+  if (interior + ghosts != cells)
+    DUNE_THROW(Dune::Exception, "ghost and interior cells do not add up to all cells");
+  for (const auto& v : vertices(gv))
+    if (v.partitionType() == Dune::OverlapEntity || v.partitionType() == Dune::FrontEntity)
+      DUNE_THROW(Dune::Exception, "ghost halo grid has an overlap or front vertex");
+
+  // the overlap interface is empty
+  std::vector<double> data(gv.size(0), -1.0);
+  for (const auto& e : elements(gv, Dune::Partitions::interior))
+    data[gv.indexSet().index(e)] = yaspCellValue(e);
+  YaspCellDataHandle<decltype(gv)> handle(gv, data);
+  gv.communicate(handle, Dune::Overlap_All_Interface, Dune::ForwardCommunication);
+  for (const auto& e : elements(gv, Dune::Partitions::ghost))
+    if (data[gv.indexSet().index(e)] != -1.0)
+      DUNE_THROW(Dune::Exception, "overlap interface of a ghost halo grid communicates data");
+
+  // batches of cells follow the ghost partitions
+  Dune::YaspStructuredAccess<Grid> access(grid);
+  check_yasp_batches<Dune::Ghost_Partition>(gv, access);
+  check_yasp_batches<Dune::Overlap_Partition>(gv, access);
+  check_yasp_batches<Dune::All_Partition>(gv, access);
+}
+
+// compare the maps of YaspLevelTransfer with the hierarchic structure of the grid
+template <int dim>
+void check_yasp_level_transfer(Dune::YaspOrdering ordering)
+{
+  Dune::FieldVector<double,dim> Len(1.0);
+  std::array<int,dim> s;
+  std::fill(s.begin(), s.end(), 3);
+  typedef Dune::YaspGrid<dim> Grid;
+  Grid grid(Len, s, std::bitset<dim>(1ULL), 1, typename Grid::CollectiveCommunicationType(),
+            Grid::defaultLoadbalancer(), Dune::TorusBackend::pointToPoint, Dune::TorusMapping::lexicographic, ordering);
+  grid.globalRefine(2);
+
+  for (int l=1; l<=grid.maxLevel(); l++)
+  {
+    Dune::YaspLevelTransfer<Grid> transfer(grid, l);
+    const auto& fine = grid.levelGridView(l).indexSet();
+    const auto& coarse = grid.levelGridView(l-1).indexSet();
+    if (transfer.father().size() != std::size_t(fine.size(0)) || transfer.stencilOffsets().size() != std::size_t(fine.size(dim)+1))
+      DUNE_THROW(Dune::Exception, "YaspLevelTransfer has the wrong size");
+
+    // fathers and child slots
+    for (const auto& e : elements(grid.levelGridView(l)))
+    {
+      const int k = fine.index(e);
+      if (transfer.father()[k] != coarse.index(e.father()))
+        DUNE_THROW(Dune::Exception, "YaspLevelTransfer::father() is wrong");
+      const auto center = e.geometryInFather().center();
+      for (int i=0; i<dim; i++)
+        if (bool(transfer.childSlot()[k] & (1<<i)) != (center[i] > 0.5))
+          DUNE_THROW(Dune::Exception, "YaspLevelTransfer::childSlot() is wrong");
+    }
+
+    // the interpolation reproduces linear functions in the non-periodic directions
+    auto f = [] (const Dune::FieldVector<double,dim>& x)
+    {
+      double v = 0.0;
+      for (int i=1; i<dim; i++)
+        v += (i+1)*x[i];
+      return v;
+    };
+    std::vector<double> u(coarse.size(dim)), v(fine.size(dim));
+    for (const auto& vertex : vertices(grid.levelGridView(l-1)))
+      u[coarse.index(vertex)] = f(vertex.geometry().center());
+    transfer.prolongateVertices(u, v);
+    for (const auto& vertex : vertices(grid.levelGridView(l)))
+    {
+      const int k = fine.index(vertex);
+      if (transfer.stencilOffsets()[k] < transfer.stencilOffsets()[k+1]
+          && std::abs(v[k] - f(vertex.geometry().center())) > 1e-12)
+        DUNE_THROW(Dune::Exception, "YaspLevelTransfer does not interpolate linear functions");
+    }
+
+    // the vertices inside of the coarse box have a stencil with weights summing to one
+    for (std::size_t k=0; k+1<transfer.stencilOffsets().size(); k++)
+    {
+      double sum = 0.0;
+      for (int j=transfer.stencilOffsets()[k]; j<transfer.stencilOffsets()[k+1]; j++)
+        sum += transfer.stencilWeights()[j];
+      if (transfer.stencilOffsets()[k] < transfer.stencilOffsets()[k+1] && std::abs(sum - 1.0) > 1e-12)
+        DUNE_THROW(Dune::Exception, "YaspLevelTransfer stencil weights do not sum to one");
+    }
+
+    // restriction of cells is the transpose of the prolongation
+    std::vector<double> a(coarse.size(0)), b(fine.size(0)), pa(fine.size(0), 0.0), rb(coarse.size(0));
+    for (std::size_t k=0; k<a.size(); k++)
+      a[k] = std::sin(1.0+k);
+    for (std::size_t k=0; k<b.size(); k++)
+      b[k] = std::cos(1.0+k);
+    transfer.prolongateCells(a, pa);
+    transfer.restrictCells(b, rb);
+    double left = 0.0, right = 0.0;
+    for (std::size_t k=0; k<b.size(); k++)
+      left += (transfer.father()[k] >= 0) ? pa[k]*b[k] : 0.0;
+    for (std::size_t k=0; k<a.size(); k++)
+      right += a[k]*rb[k];
+    if (std::abs(left - right) > 1e-10)
+      DUNE_THROW(Dune::Exception, "YaspLevelTransfer::restrictCells() is not the transpose of prolongateCells()");
+  }
+}
+
+// compare YaspStaticAccess of a StaticYaspGrid on one process with the runtime structured access
+template <class Grid, int level>
+void check_yasp_static_level (const Grid& grid)
+{
+  const int dim = Grid::dim;
+  typedef Dune::YaspStaticAccess<Grid, level> Static;
+  Static s(grid);
+  Dune::YaspStructuredAccess<Dune::YaspGrid<dim> > r(grid, level);
+
+  if (Static::count() != r.count() || Static::count() != grid.levelGridView(level).size(0))
+    DUNE_THROW(Dune::Exception, "YaspStaticAccess has the wrong number of cells");
+  for (int i=0; i<dim; i++)
+  {
+    if (Static::size(i) != r.size(i) || Static::stride(i) != r.stride(i)
+        || Static::interiorBegin(i) != r.interiorBegin(i) || Static::interiorEnd(i) != r.interiorEnd(i))
+      DUNE_THROW(Dune::Exception, "YaspStaticAccess does not match YaspStructuredAccess");
+    for (int k=0; k<Static::size(i); k++)
+      if (std::abs(s.lower(i,k) - r.lower(i,k)) > 1e-12 || std::abs(s.meshsize(i) - r.meshsize(i,k)) > 1e-12)
+        DUNE_THROW(Dune::Exception, "YaspStaticAccess has wrong coordinates");
+  }
+  for (int k=0; k<Static::count(); k++)
+    if (Static::index(Static::coord(k)) != k || Static::coord(k) != r.coord(k))
+      DUNE_THROW(Dune::Exception, "YaspStaticAccess::coord() is wrong");
+
+  // the interior cells are visited in the order of the level iterator
+  auto gv = grid.levelGridView(level);
+  std::vector<int> expected;
+  for (const auto& e : elements(gv, Dune::Partitions::interior))
+    expected.push_back(gv.indexSet().index(e));
+  std::vector<int> visited;
+  s.forEachInterior([&](int k) { visited.push_back(k); });
+  if (visited != expected)
+    DUNE_THROW(Dune::Exception, "YaspStaticAccess::forEachInterior() does not visit the interior cells");
+}
+
+template <int dim>
+void check_yasp_static ()
+{
+  // periodic in direction 0 only
+  typedef typename std::conditional<dim == 2, Dune::StaticYaspGrid<1, 1u, 5, 4>,
+                                    Dune::StaticYaspGrid<1, 1u, 5, 4, 3> >::type Grid;
+  Dune::FieldVector<double,dim> Len(1.0);
+#if HAVE_MPI
+  Grid grid(Len, typename Grid::CollectiveCommunicationType(MPI_COMM_SELF));
+#else
+  Grid grid(Len);
+#endif
+  static_assert(Dune::YaspStaticAccess<Grid>::size(0) == 7, "wrong compile-time size");
+
+  check_yasp_static_level<Grid,0>(grid);
+  grid.globalRefine(1);
+  check_yasp_static_level<Grid,1>(grid);
+
+  // the extents do not match on a distributed grid
+  if (Dune::MPIHelper::getCollectiveCommunication().size() > 1)
+  {
+    Grid distributed(Len);
+    bool caught = false;
+    try {
+      Dune::YaspStaticAccess<Grid> s(distributed);
+    }
+    catch (Dune::GridError&) {
+      caught = true;
+    }
+    if (!caught)
+      DUNE_THROW(Dune::Exception, "YaspStaticAccess accepted a distributed grid");
+  }
+}
+
+// check the leaf cells and faces of a locally refined YaspPatchHierarchy
+template <int dim>
+void check_yasp_patches()
+{
+  Dune::FieldVector<double,dim> Len(1.0);
+  std::array<int,dim> s;
+  std::fill(s.begin(), s.end(), 8);
+  typedef Dune::YaspGrid<dim> Grid;
+  Grid grid(Len, s);
+
+  typedef Dune::YaspPatchHierarchy<Grid> Hierarchy;
+  Hierarchy h(grid);
+  int cells = 0;
+  for (const auto& e : elements(grid.levelGridView(0), Dune::Partitions::interior))
+  {
+    if (h.leafIndex(e) != cells++ || h.level(h.leafIndex(e)) != 0)
+      DUNE_THROW(Dune::Exception, "leafIndex() of a cell of level 0 is wrong");
+  }
+  if (h.size() != cells)
+    DUNE_THROW(Dune::Exception, "initial patch hierarchy is not the interior of level 0");
+
+  // refine a band along the diagonal twice
+  for (int round=0; round<2; round++)
+  {
+    for (int k=0; k<h.size(); k++)
+    {
+      bool diagonal = true;
+      for (int i=1; i<dim; i++)
+        diagonal = diagonal && std::abs(h.lower(h.level(k),i,h.coord(k)[i]) - h.lower(h.level(k),0,h.coord(k)[0])) < 0.1;
+      if (diagonal)
+        h.mark(1,k);
+    }
+    h.adapt();
+  }
+  // the diagonal may miss the interior of some processes
+  if (h.maxLevel() > 2 || grid.maxLevel() != 2)
+    DUNE_THROW(Dune::Exception, "patch hierarchy has the wrong number of levels");
+
+  // the leaf cells cover the interior
+  double volume = 0.0;
+  for (int k=0; k<h.size(); k++)
+  {
+    volume += h.volume(k);
+    if (h.index(h.level(k), h.coord(k)) != k)
+      DUNE_THROW(Dune::Exception, "index() of a leaf cell is wrong");
+  }
+  double interiorVolume = 0.0;
+  for (const auto& e : elements(grid.levelGridView(0), Dune::Partitions::interior))
+    interiorVolume += e.geometry().volume();
+  if (std::abs(volume - interiorVolume) > 1e-8)
+    DUNE_THROW(Dune::Exception, "leaf cells of the patch hierarchy do not cover the interior");
+
+  // the rows visit every leaf cell once
+  std::vector<int> visits(h.size(), 0);
+  h.forEachLeafRow([&](int level, const std::array<int,dim>& first, int length, int index)
+  {
+    for (int j=0; j<length; j++)
+    {
+      std::array<int,dim> c(first);
+      c[0] += j;
+      if (h.level(index+j) != level || h.coord(index+j) != c)
+        DUNE_THROW(Dune::Exception, "forEachLeafRow() visits wrong cells");
+      visits[index+j]++;
+    }
+  });
+  if (std::count(visits.begin(), visits.end(), 1) != h.size())
+    DUNE_THROW(Dune::Exception, "forEachLeafRow() does not visit every leaf cell once");
+
+  // the faces tile the sides of the leaf cells in the interior of the process
+  std::vector<std::array<double,2*dim> > area(h.size());
+  h.forEachLeafFace([&](const typename Hierarchy::Face& f)
+  {
+    if (std::abs(h.level(f.inside) - h.level(f.outside)) > 1)
+      DUNE_THROW(Dune::Exception, "patch hierarchy is not properly nested");
+    area[f.inside][2*f.direction+1] += h.area(f);
+    area[f.outside][2*f.direction] += h.area(f);
+  });
+  const auto& box = *grid.begin(0)->interior[0].dataBegin();
+  for (int k=0; k<h.size(); k++)
+    for (int i=0; i<dim; i++)
+      for (int side=0; side<2; side++)
+      {
+        const int l = h.level(k);
+        const int c = h.coord(k)[i];
+        if ((side == 0 && c == (box.origin(i) << l)) || (side == 1 && c == ((box.origin(i)+box.size(i)) << l)-1))
+          continue;
+        double full = 1.0;
+        for (int j=0; j<dim; j++)
+          if (j != i)
+            full *= h.meshsize(l,j,h.coord(k)[j]);
+        if (std::abs(area[k][2*i+side] - full) > 1e-8)
+          DUNE_THROW(Dune::Exception, "faces of the patch hierarchy do not tile the cell sides");
+      }
+
+  // coarsen everything again
+  for (int round=0; round<2; round++)
+  {
+    for (int k=0; k<h.size(); k++)
+      h.mark(-1,k);
+    h.adapt();
+  }
+  if (h.maxLevel() != 0)
+    DUNE_THROW(Dune::Exception, "patch hierarchy was not coarsened");
+
+  // refine one cell by two levels at once, all its descendants on level 2 become leaf cells
+  const std::array<int,dim> corner(h.coord(0));
+  h.mark(2,0);
+  h.adapt();
+  if (h.maxLevel() != 2)
+    DUNE_THROW(Dune::Exception, "mark(2) did not refine by two levels");
+  std::array<int,dim> c;
+  for (int k=0; k<(1<<(2*dim)); k++)
+  {
+    for (int i=0; i<dim; i++)
+      c[i] = 4*corner[i] + (k >> (2*i))%4;
+    if (h.index(2,c) < 0)
+      DUNE_THROW(Dune::Exception, "mark(2) did not refine all descendants of the cell");
+  }
+}
+
+// migrates one value per cell and vertex, stored by id, during repartition()
+template<class Grid>
+class YaspMigrationDataHandle
+  : public Dune::CommDataHandleIF<YaspMigrationDataHandle<Grid>, double>
+{
+  typedef typename Grid::GlobalIdSet::IdType IdType;
+public:
+  YaspMigrationDataHandle (const Grid& grid, const std::map<IdType,double>& before, std::map<IdType,double>& after)
+    : _grid(grid), _before(before), _after(after)
+  {}
+
+  bool contains (int dim, int codim) const { return codim == 0 || codim == dim; }
+  bool fixedSize (int dim, int codim) const { return true; }
+
+  template<class E>
+  std::size_t size (const E& e) const { return 1; }
+
+  template<class Buf, class E>
+  void gather (Buf& buf, const E& e) const
+  {
+    buf.write(_before.at(_grid.globalIdSet().id(e)));
+  }
+
+  template<class Buf, class E>
+  void scatter (Buf& buf, const E& e, std::size_t n)
+  {
+    buf.read(_after[_grid.globalIdSet().id(e)]);
+  }
+
+private:
+  const Grid& _grid;
+  const std::map<IdType,double>& _before;
+  std::map<IdType,double>& _after;
+};
+
+// check that repartitioning by a cost field keeps the refinement and migrates cell and vertex data
+template <int dim, class CC>
+void check_yasp_repartition()
+{
+  typedef Dune::YaspGrid<dim,CC> Grid;
+  typedef typename Grid::GlobalIdSet::IdType IdType;
+  Grid* grid = YaspFactory<dim,CC>::buildGrid(true, 1);
+
+  std::map<IdType,double> before, after;
+  for (int l=0; l<=grid->maxLevel(); l++)
+  {
+    for (const auto& e : elements(grid->levelGridView(l)))
+      before[grid->globalIdSet().id(e)] = yaspCellValue(e);
+    for (const auto& v : vertices(grid->levelGridView(l)))
+      before[grid->globalIdSet().id(v)] = yaspCellValue(v);
+  }
+
+  // the same partitioner as at construction does not change anything
+  YaspMigrationDataHandle<Grid> handle(*grid, before, after);
+  if (grid->repartition(Dune::YLoadBalanceDefault<dim>(), handle) || !after.empty())
+    DUNE_THROW(Dune::Exception, "repartition() with an unchanged partition modified the grid");
+
+  std::array<int,dim> s;
+  std::fill(s.begin(), s.end(), 8);
+  std::array<std::vector<double>,dim> cost;
+  for (int i=0; i<dim; i++)
+  {
+    cost[i].assign(s[i], 1.0);
+    cost[i][0] = cost[i][1] = 10.0;
+  }
+  Dune::YaspWeightedPartitioner<dim> lb(cost);
+  bool changed = grid->repartition(lb, handle);
+  if (changed && grid->comm().size() == 1)
+    DUNE_THROW(Dune::Exception, "repartition() changed the partition of a sequential grid");
+  if (grid->maxLevel() != 1)
+    DUNE_THROW(Dune::Exception, "repartition() did not keep the refinement");
+
+  const std::map<IdType,double>& data = changed ? after : before;
+  for (int l=0; l<=grid->maxLevel(); l++)
+  {
+    for (const auto& e : elements(grid->levelGridView(l)))
+      if (std::abs(data.at(grid->globalIdSet().id(e)) - yaspCellValue(e)) > 1e-8)
+        DUNE_THROW(Dune::Exception, "repartition() migrated wrong cell data");
+    for (const auto& v : vertices(grid->levelGridView(l)))
+      if (std::abs(data.at(grid->globalIdSet().id(v)) - yaspCellValue(v)) > 1e-8)
+        DUNE_THROW(Dune::Exception, "repartition() migrated wrong vertex data");
+  }
+
+  check_yasp(grid);
+}
+
 template <int dim, class CC = Dune::EquidistantCoordinates<double,dim> >
 void check_backuprestore(Dune::YaspGrid<dim,CC>* grid)
 {
@@ -199,6 +1172,11 @@ void check_backuprestore(Dune::YaspGrid<dim,CC>* grid)
      }
    }
 
+   if (restored->halo() != grid->halo())
+     DUNE_THROW(Dune::Exception, "BackupRestoreFacility did not restore the halo mode");
+   if (restored->ordering() != grid->ordering())
+     DUNE_THROW(Dune::Exception, "BackupRestoreFacility did not restore the ordering");
+
    check_yasp(restored);
 
    delete grid;
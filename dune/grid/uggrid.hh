@@ -9,12 +9,15 @@
  */
 
 #include <memory>
+#include <tuple>
 
 #include <dune/common/classname.hh>
 #include <dune/common/parallel/collectivecommunication.hh>
 #include <dune/common/exceptions.hh>
 #include <dune/common/parallel/mpihelper.hh>
 #include <dune/common/deprecated.hh>
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/std/utility.hh>
 
 #include <dune/grid/common/boundarysegment.hh>
 #include <dune/grid/common/capabilities.hh>
@@ -138,6 +141,18 @@ DataHandle *Dune::UGMessageBufferBase<DataHandle,GridDim,codim>::duneDataHandle_
 
 template <class DataHandle, int GridDim, int codim>
 int Dune::UGMessageBufferBase<DataHandle,GridDim,codim>::level = -1;
+
+template <int GridDim, int codim, class... DataHandles>
+std::tuple<DataHandles*...> Dune::UGFusedMessageBuffer<GridDim,codim,DataHandles...>::handles_;
+
+template <int GridDim, int codim, class... DataHandles>
+std::array<unsigned, sizeof...(DataHandles)> Dune::UGFusedMessageBuffer<GridDim,codim,DataHandles...>::offsets_;
+
+template <int GridDim, int codim, class... DataHandles>
+std::array<unsigned, sizeof...(DataHandles)> Dune::UGFusedMessageBuffer<GridDim,codim,DataHandles...>::sizes_;
+
+template <int GridDim, int codim, class... DataHandles>
+int Dune::UGFusedMessageBuffer<GridDim,codim,DataHandles...>::level_ = -1;
 #endif // ModelP
 
 namespace Dune {
@@ -478,7 +493,8 @@ namespace Dune {
     /** \brief Distributes the grid and some data over the available nodes in a distributed machine
 
         \tparam DataHandle works like the data handle for the communicate
-        methods.
+        methods.  Data of all codimensions the handle contains is migrated,
+        and the size may vary from entity to entity.
 
         \return True, if grid has changed, false otherwise
      */
@@ -486,12 +502,12 @@ namespace Dune {
     bool loadBalance (DataHandle& dataHandle)
     {
 #ifdef ModelP
-      // gather element data
-      //        UGLBGatherScatter::template gather<0>(this->leafGridView(), dataHandle);
+      // gather node data into the UG nodes, DDD migrates it with them
+      UGLBGatherScatter::gatherVertices(this->leafGridView(), dataHandle);
 
-      // gather node data
-      if (dataHandle.contains(dim,dim))
-        UGLBGatherScatter::template gather<dim>(this->leafGridView(), dataHandle);
+      // gather element, edge and face data, where it goes is only known afterwards
+      auto records = UGLBGatherScatter::gatherElements(this->leafGridView(), dataHandle,
+                                                       static_cast<const std::vector<Rank>*>(nullptr));
 #endif
 
       // the load balancing step now also attaches
@@ -499,12 +515,12 @@ namespace Dune {
       loadBalance();
 
 #ifdef ModelP
-      // scatter element data
-      //        UGLBGatherScatter::template scatter<0>(this->leafGridView(), dataHandle);
-
       // scatter node data
-      if (dataHandle.contains(dim,dim))
-        UGLBGatherScatter::template scatter<dim>(this->leafGridView(), dataHandle);
+      UGLBGatherScatter::scatterVertices(this->leafGridView(), dataHandle);
+
+      // send the element, edge and face data to the new owners and scatter it
+      UGLBGatherScatter::findDestinations(this->leafGridView(), dataHandle, records);
+      UGLBGatherScatter::scatterElements(this->leafGridView(), dataHandle, records);
 #endif
 
       return true;
@@ -563,11 +579,11 @@ namespace Dune {
     bool loadBalance (const std::vector<Rank>& targetProcessors, unsigned int fromLevel, DataHandle& dataHandle)
     {
 #ifdef ModelP
-      // gather element data
-      //        UGLBGatherScatter::template gather<0>(this->leafGridView(), dataHandle);
+      // gather node data into the UG nodes, DDD migrates it with them
+      UGLBGatherScatter::gatherVertices(this->leafGridView(), dataHandle);
 
-      // gather node data
-      UGLBGatherScatter::template gather<dim>(this->leafGridView(), dataHandle);
+      // gather element, edge and face data, addressed to the targets of the elements
+      auto records = UGLBGatherScatter::gatherElements(this->leafGridView(), dataHandle, &targetProcessors);
 #endif
 
       // the load balancing step now also attaches
@@ -575,11 +591,11 @@ namespace Dune {
       loadBalance(targetProcessors,fromLevel);
 
 #ifdef ModelP
-      // scatter element data
-      //        UGLBGatherScatter::template scatter<0>(this->leafGridView(), dataHandle);
-
       // scatter node data
-      UGLBGatherScatter::template scatter<dim>(this->leafGridView(), dataHandle);
+      UGLBGatherScatter::scatterVertices(this->leafGridView(), dataHandle);
+
+      // send the element, edge and face data to the new owners and scatter it
+      UGLBGatherScatter::scatterElements(this->leafGridView(), dataHandle, records);
 #endif
 
       return true;
@@ -657,6 +673,37 @@ namespace Dune {
 #endif // ModelP
     }
 
+    /** \brief Communicate several data handles together on a given level
+       @param handles the data handles, e.g. created with std::tie
+       @param iftype one of the predefined interface types, throws error if it is not implemented
+       @param dir choose between forward and backward communication
+       @param level communicate for entities on the given level
+
+       For each codim the data of all handles containing it is packed into
+       one message buffer per entity, so there is one DDD interface sweep
+       per codim instead of one per handle and codim.
+     */
+    template<class... DataHandles>
+    void communicate (const std::tuple<DataHandles&...>& handles, InterfaceType iftype, CommunicationDirection dir, int level) const
+    {
+#ifdef ModelP
+      communicateFused_(this->levelGridView(level), level, handles, iftype, dir);
+#endif // ModelP
+    }
+
+    /** \brief Communicate several data handles together on the leaf level
+       @param handles the data handles, e.g. created with std::tie
+       @param iftype one of the predefined interface types, throws error if it is not implemented
+       @param dir choose between forward and backward communication
+     */
+    template<class... DataHandles>
+    void communicate (const std::tuple<DataHandles&...>& handles, InterfaceType iftype, CommunicationDirection dir) const
+    {
+#ifdef ModelP
+      communicateFused_(this->leafGridView(), -1, handles, iftype, dir);
+#endif // ModelP
+    }
+
     /** the collective communication */
     const CollectiveCommunication<UGGrid>& comm () const
     {
@@ -697,6 +744,64 @@ namespace Dune {
                                  &UGMsgBuf::ugScatter_);
     }
 
+    template <class GridView, class... DataHandles>
+    void communicateFused_(const GridView& gv, int level,
+                           const std::tuple<DataHandles&...>& handles,
+                           InterfaceType iftype,
+                           CommunicationDirection dir) const
+    {
+      for (int curCodim = 0; curCodim <= dim; ++curCodim) {
+        bool contained = false;
+        Hybrid::forEach(Std::make_index_sequence<sizeof...(DataHandles)>{}, [&](auto i) {
+          contained = contained || std::get<i>(handles).contains(dim, curCodim);
+        });
+        if (!contained)
+          continue;
+
+        if (curCodim == 0)
+          communicateFusedUG_<GridView, 0>(gv, level, handles, iftype, dir);
+        else if (curCodim == dim)
+          communicateFusedUG_<GridView, dim>(gv, level, handles, iftype, dir);
+        else if (curCodim == dim - 1)
+          communicateFusedUG_<GridView, dim-1>(gv, level, handles, iftype, dir);
+        else if (curCodim == 1)
+          communicateFusedUG_<GridView, 1>(gv, level, handles, iftype, dir);
+        else
+          DUNE_THROW(NotImplemented,
+                     className(*this) << "::communicate(): Not "
+                     "supported for dim " << dim << " and codim " << curCodim);
+      }
+    }
+
+    template <class GridView, int codim, class... DataHandles>
+    void communicateFusedUG_(const GridView& gv, int level,
+                             const std::tuple<DataHandles&...>& handles,
+                             InterfaceType iftype,
+                             CommunicationDirection dir) const
+    {
+      typename UG_NS<dim>::DDD_IF_DIR ugIfDir;
+      // Translate the communication direction from Dune-Speak to UG-Speak
+      if (dir==ForwardCommunication)
+        ugIfDir = UG_NS<dim>::IF_FORWARD();
+      else
+        ugIfDir = UG_NS<dim>::IF_BACKWARD();
+
+      typedef UGFusedMessageBuffer<dim,codim,DataHandles...> UGMsgBuf;
+
+      std::vector<typename UG_NS<dim>::DDD_IF> ugIfs;
+      findDDDInterfaces_(ugIfs, iftype, codim);
+
+      unsigned bufSize = UGMsgBuf::setup_(gv, handles, level);
+      if (!bufSize)
+        return;     // we don't need to communicate if we don't have any data!
+      for (unsigned i=0; i < ugIfs.size(); ++i)
+        UG_NS<dim>::DDD_IFOneway(ugIfs[i],
+                                 ugIfDir,
+                                 bufSize,
+                                 &UGMsgBuf::ugGather_,
+                                 &UGMsgBuf::ugScatter_);
+    }
+
     void findDDDInterfaces_(std::vector<typename UG_NS<dim>::DDD_IF > &dddIfaces,
                             InterfaceType iftype,
                             int codim) const
@@ -887,9 +992,15 @@ namespace Dune {
         \param setLevelZero If this is false, level indices of the level 0 are not touched
         \param nodePermutation Permutation array for the vertex level 0 indices.  If this is NULL,
         the identity is used.
+        \param firstChangedLevel The coarsest level whose elements changed.  The level indices
+        of coarser levels are not touched, and the leaf indices are updated incrementally.
      */
     void setIndices(bool setLevelZero,
-                    std::vector<unsigned int>* nodePermutation);
+                    std::vector<unsigned int>* nodePermutation,
+                    int firstChangedLevel = 0);
+
+    /** \brief The coarsest level whose elements were changed by adapt(), computed after adapt() */
+    int coarsestChangedLevel() const;
 
     // Each UGGrid object has a unique name to identify it in the
     // UG environment structure
@@ -933,6 +1044,12 @@ namespace Dune {
      */
     bool someElementHasBeenMarkedForCoarsening_;
 
+    /** \brief The coarsest level of an element marked for coarsening since the last call to postAdapt()
+
+        This bounds the levels changed by adapt(), for the incremental index update.
+     */
+    int coarsestLevelMarkedForCoarsening_;
+
     /** \brief The size of UG's internal heap in megabytes
      *
      * It is handed over to UG for each new multigrid.
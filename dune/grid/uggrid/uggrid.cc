@@ -3,6 +3,8 @@
 
 #include <config.h>
 
+#include <algorithm>
+#include <limits>
 #include <set>
 #include <map>
 #include <memory>
@@ -40,6 +42,7 @@ UGGrid < dim >::UGGrid()
     closureType_(GREEN),
     someElementHasBeenMarkedForRefinement_(false),
     someElementHasBeenMarkedForCoarsening_(false),
+    coarsestLevelMarkedForCoarsening_(std::numeric_limits<int>::max()),
     numBoundarySegments_(0)
 {
   // If no UGGrid object exists yet start up UG for 2d and 3d
@@ -216,6 +219,7 @@ bool UGGrid < dim >::mark(int refCount,
         ) DUNE_THROW(GridError, "UG" << dim << "d::MarkForRefinement returned error code!");
 
     someElementHasBeenMarkedForCoarsening_ = true;
+    coarsestLevelMarkedForCoarsening_ = std::min(coarsestLevelMarkedForCoarsening_, e.level());
     return true;
   } else
     DUNE_THROW(GridError, "UGGrid only supports refCount values -1, 0, and 1 for mark()!");
@@ -233,6 +237,8 @@ bool UGGrid < dim >::mark(const typename Traits::template Codim<0>::Entity& e,
     return false;
 
   someElementHasBeenMarkedForRefinement_ = true;
+  if (rule == UG_NS<dim>::COARSE)
+    coarsestLevelMarkedForCoarsening_ = std::min(coarsestLevelMarkedForCoarsening_, e.level());
 
   return UG_NS<dim>::MarkForRefinement(target, rule, side);
 
@@ -309,8 +315,8 @@ bool UGGrid < dim >::adapt()
   if (rv!=0)
     DUNE_THROW(GridError, "UG::adapt() returned with error code " << rv);
 
-  // Renumber everything
-  setIndices(false, nullptr);
+  // Renumber what has changed
+  setIndices(false, nullptr, coarsestChangedLevel());
 
   // Return true iff the grid hierarchy changed
   //return !(bool)multigrid_->status;
@@ -329,6 +335,35 @@ void UGGrid <dim>::postAdapt()
   // reset marker flags
   someElementHasBeenMarkedForRefinement_ = false;
   someElementHasBeenMarkedForCoarsening_ = false;
+  coarsestLevelMarkedForCoarsening_ = std::numeric_limits<int>::max();
+}
+
+template <int dim>
+int UGGrid <dim>::coarsestChangedLevel() const
+{
+  // Copies of all leaf elements are created on a new level
+  if (refinementType_==COPY)
+    return 0;
+
+  // UG does not tell which elements were created or removed.  The fathers of
+  // the elements marked for coarsening become leaf elements again, and the
+  // closure of their neighbors may change one level further down.
+  int level = coarsestLevelMarkedForCoarsening_ - 2;
+
+  // New elements carry the NEWEL flag until postAdapt(), their fathers are
+  // not leaf elements anymore.  Only the levels below the current bound are searched.
+  for (int i=0; i<=maxLevel() && i-1<level; i++)
+    for (const auto& element : elements(this->levelGridView(i)))
+      if (UG_NS<dim>::ReadCW(this->getRealImplementation(element).target_, UG_NS<dim>::NEWEL_CE))
+      {
+        level = i-1;
+        break;
+      }
+
+  level = std::min(level, maxLevel()+1);
+
+  // Ghost elements change with the elements of other processes
+  return std::max(this->comm().min(level), 0);
 }
 
 template < int dim >
@@ -606,7 +641,8 @@ void UGGrid<dim>::loadState(const std::string& filename)
 
 template < int dim >
 void UGGrid < dim >::setIndices(bool setLevelZero,
-                                      std::vector<unsigned int>* nodePermutation)
+                                      std::vector<unsigned int>* nodePermutation,
+                                      int firstChangedLevel)
 {
   // Create new level index sets if necessary
   for (int i=levelIndexSets_.size(); i<=maxLevel(); i++)
@@ -617,12 +653,15 @@ void UGGrid < dim >::setIndices(bool setLevelZero,
   if (setLevelZero)
     levelIndexSets_[0]->update(*this, 0, nodePermutation);
 
-  // Update the remaining level index sets
-  for (int i=1; i<=maxLevel(); i++)
-    if (levelIndexSets_[i])
-      levelIndexSets_[i]->update(*this, i);
+  // The remaining level index sets recompute themselves when they are used next,
+  // those of unchanged levels stay valid
+  for (std::size_t i=std::max(1,firstChangedLevel); i<levelIndexSets_.size(); i++)
+    levelIndexSets_[i]->invalidate(*this, i);
 
-  leafIndexSet_.update(nodePermutation);
+  if (firstChangedLevel > 0)
+    leafIndexSet_.updateIncremental(firstChangedLevel);
+  else
+    leafIndexSet_.update(nodePermutation);
 
   // id sets don't need updating
 }
@@ -3,11 +3,17 @@
 
 #include <config.h>
 
+#include <algorithm>
 #include <memory>
+#include <set>
+#include <string>
+#include <utility>
 
 #include <dune/common/std/memory.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/mcmgmapper.hh>
 #include <dune/grid/uggrid/uggridfactory.hh>
 #include "boundaryextractor.hh"
 
@@ -69,6 +75,76 @@ static int boundarySegmentWrapper3dQuad(void *data, double *param, double *resul
 
 
 
+namespace {
+
+  // Collect the entries of a vector from all processes on rank 0, ordered by rank.
+  // On rank 0, counts[i] is the number of entries from process i afterwards.
+  template <class T, class Comm>
+  std::vector<T> gatherOnMaster(const Comm& comm, const std::vector<T>& local, std::vector<int>& counts)
+  {
+    int n = local.size();
+    counts.assign(comm.size(), 0);
+    comm.gather(&n, counts.data(), 1, 0);
+
+    std::vector<int> offsets(comm.size()+1, 0);
+    for (int i=0; i<comm.size(); i++)
+      offsets[i+1] = offsets[i] + counts[i];
+
+    std::vector<T> all((comm.rank()==0) ? offsets.back() : 0);
+    comm.gatherv(local.data(), n, all.data(), counts.data(), offsets.data(), 0);
+    return all;
+  }
+
+  // Send the insertion index of each coarse grid element along with the element,
+  // the elements are indexed by their level index before and after the load balancing
+  template <class Grid>
+  class InsertionIndexHandle
+    : public CommDataHandleIF<InsertionIndexHandle<Grid>, unsigned int>
+  {
+  public:
+    typedef unsigned int DataType;
+
+    InsertionIndexHandle(const Grid& grid, const std::vector<unsigned int>& sent, std::vector<unsigned int>& received)
+      : grid_(grid), sent_(sent), received_(received)
+    {}
+
+    bool contains (int dim, int codim) const
+    {
+      return codim == 0;
+    }
+
+    bool fixedSize (int dim, int codim) const
+    {
+      return true;
+    }
+
+    template<class Entity>
+    size_t size (const Entity& entity) const
+    {
+      return 1;
+    }
+
+    template<class MessageBuffer, class Entity>
+    void gather (MessageBuffer& buff, const Entity& entity) const
+    {
+      buff.write(sent_[grid_.levelGridView(0).indexSet().index(entity)]);
+    }
+
+    template<class MessageBuffer, class Entity>
+    void scatter (MessageBuffer& buff, const Entity& entity, size_t n)
+    {
+      received_.resize(grid_.levelGridView(0).size(0));
+      buff.read(received_[grid_.levelGridView(0).indexSet().index(entity)]);
+    }
+
+  private:
+    const Grid& grid_;
+    const std::vector<unsigned int>& sent_;
+    std::vector<unsigned int>& received_;
+  };
+
+}
+
 template <int dimworld>
 GridFactory<UGGrid<dimworld> >::
 GridFactory()
@@ -103,9 +179,23 @@ template <int dimworld>
 void GridFactory<UGGrid<dimworld> >::
 insertVertex(const FieldVector<typename GridFactory<UGGrid<dimworld> >::ctype,dimworld>& pos)
 {
+  if (!vertexGlobalIndices_.empty())
+    DUNE_THROW(GridError, "The vertices of a distributed coarse grid need global indices!");
+
   vertexPositions_.push_back(pos);
 }
 
+template <int dimworld>
+void GridFactory<UGGrid<dimworld> >::
+insertVertex(const FieldVector<typename GridFactory<UGGrid<dimworld> >::ctype,dimworld>& pos, unsigned int globalIndex)
+{
+  if (vertexGlobalIndices_.size() != vertexPositions_.size())
+    DUNE_THROW(GridError, "The vertices of a distributed coarse grid need global indices!");
+
+  vertexPositions_.push_back(pos);
+  vertexGlobalIndices_.push_back(globalIndex);
+}
+
 template <int dimworld>
 void GridFactory<UGGrid<dimworld> >::
 insertElement(const GeometryType& type,
@@ -178,6 +268,99 @@ insertElement(const GeometryType& type,
 
 }
 
+template <int dimworld>
+void GridFactory<UGGrid<dimworld> >::
+toUGNumbering(unsigned int* corners, std::size_t numCorners)
+{
+  // Quadrilaterals, pyramids and hexahedra are numbered differently in DUNE and UG
+  if ((dimworld==2 && numCorners==4) || numCorners==5 || numCorners==8)
+    std::swap(corners[2], corners[3]);
+  if (numCorners==8)
+    std::swap(corners[6], corners[7]);
+}
+
+template <int dimworld>
+void GridFactory<UGGrid<dimworld> >::
+reserve(std::size_t numVertices, std::size_t numElements)
+{
+  vertexPositions_.reserve(numVertices);
+  elementTypes_.reserve(numElements);
+
+  // Reserve for hexahedra resp. quadrilaterals, no element has more corners
+  elementVertices_.reserve(numElements << dimworld);
+}
+
+template <int dimworld>
+void GridFactory<UGGrid<dimworld> >::
+insertVertices(const typename GridFactory<UGGrid<dimworld> >::ctype* coordinates, std::size_t numVertices)
+{
+  if (!vertexGlobalIndices_.empty())
+    DUNE_THROW(GridError, "The vertices of a distributed coarse grid need global indices!");
+
+  std::size_t first = vertexPositions_.size();
+  vertexPositions_.resize(first + numVertices);
+  for (std::size_t i=0; i<numVertices; i++)
+    for (int j=0; j<dimworld; j++)
+      vertexPositions_[first+i][j] = *coordinates++;
+}
+
+template <int dimworld>
+void GridFactory<UGGrid<dimworld> >::
+insertVertices(const typename GridFactory<UGGrid<dimworld> >::ctype* coordinates,
+               const unsigned int* globalIndices, std::size_t numVertices)
+{
+  if (vertexGlobalIndices_.size() != vertexPositions_.size())
+    DUNE_THROW(GridError, "The vertices of a distributed coarse grid need global indices!");
+
+  std::size_t first = vertexPositions_.size();
+  vertexPositions_.resize(first + numVertices);
+  for (std::size_t i=0; i<numVertices; i++)
+    for (int j=0; j<dimworld; j++)
+      vertexPositions_[first+i][j] = *coordinates++;
+
+  vertexGlobalIndices_.insert(vertexGlobalIndices_.end(), globalIndices, globalIndices + numVertices);
+}
+
+template <int dimworld>
+void GridFactory<UGGrid<dimworld> >::
+insertElements(const GeometryType& type,
+               const unsigned int* vertices, std::size_t numElements)
+{
+  if (dimworld!=type.dim() || !(type.isSimplex() || type.isCube() || type.isPyramid() || type.isPrism()))
+    DUNE_THROW(GridError, "You cannot insert a " << type
+                                                 << " into a UGGrid<" << dimworld << ">!");
+
+  const std::size_t numCorners = this->numCorners(type);
+  std::size_t first = elementVertices_.size();
+
+  elementTypes_.insert(elementTypes_.end(), numElements, numCorners);
+  elementVertices_.insert(elementVertices_.end(), vertices, vertices + numElements*numCorners);
+
+  for (std::size_t i=0; i<numElements; i++)
+    toUGNumbering(&elementVertices_[first + i*numCorners], numCorners);
+}
+
+template <int dimworld>
+void GridFactory<UGGrid<dimworld> >::
+insertElements(const unsigned int* offsets,
+               const unsigned int* vertices, std::size_t numElements)
+{
+  // Check all elements before anything is inserted
+  for (std::size_t i=0; i<numElements; i++)
+    this->typeOfElement(offsets[i+1] - offsets[i]);
+
+  std::size_t first = elementVertices_.size();
+
+  elementVertices_.insert(elementVertices_.end(), vertices + offsets[0], vertices + offsets[numElements]);
+
+  for (std::size_t i=0; i<numElements; i++)
+  {
+    const std::size_t numCorners = offsets[i+1] - offsets[i];
+    elementTypes_.push_back(numCorners);
+    toUGNumbering(&elementVertices_[first + offsets[i] - offsets[0]], numCorners);
+  }
+}
+
 template <int dimworld>
 void GridFactory<UGGrid<dimworld> >::
 insertBoundarySegment(const std::vector<unsigned int>& vertices)
@@ -212,94 +395,238 @@ insertBoundarySegment(const std::vector<unsigned int>& vertices,
 }
 
 template <int dimworld>
-UGGrid<dimworld>* GridFactory<UGGrid<dimworld> >::
-createGrid()
+int GridFactory<UGGrid<dimworld> >::
+gatherDistributedGrid(std::vector<unsigned int>& elementOwners)
 {
-  // Prevent a crash when this method is called twice in a row
-  // You never know who may do this...
-  if (grid_==nullptr)
-    return nullptr;
+  const auto& comm = MPIHelper::getCollectiveCommunication();
 
-  // ///////////////////////////////////////////////////////////////////////////////
-  //  Communicate the grid information from the master to all other processes
-  //
-  // Rationale: Parallel Dune grids that are set up by providing a coarse grid
-  // on rank 0 and then loadbalancing should not require that the grid be
-  // provided to all processes directly. Usually UGGrid does that, because
-  // it needs the grid only on rank 0, but the grid _boundary_ on all processes.
-  // This patch makes the rank 0 process broadcast the entire coarse
-  // grid information from rank 0 to all other processes before
-  // starting the actual grid creation.  That way, the user has to
-  // supply the coarse grid only on rank 0 (as the specification says),
-  // but still the UGGridFactory has all relevant information available
-  // on all processes.
-  // ///////////////////////////////////////////////////////////////////////////////
+  // Refer to the corners of the elements by their global indices
+  for (auto& vertex : elementVertices_)
+    vertex = vertexGlobalIndices_[vertex];
 
-  // Broadcast the vertex positions
-  int numVertices = vertexPositions_.size();
-  MPIHelper::getCollectiveCommunication().broadcast(&numVertices, 1, 0);
+  std::vector<int> vertexCounts, elementCounts, cornerCounts;
+  std::vector<unsigned int> globalIndices = gatherOnMaster(comm, vertexGlobalIndices_, vertexCounts);
+  std::vector<FieldVector<double, dimworld> > positions = gatherOnMaster(comm, vertexPositions_, vertexCounts);
+  elementTypes_ = gatherOnMaster(comm, elementTypes_, elementCounts);
+  elementVertices_ = gatherOnMaster(comm, elementVertices_, cornerCounts);
+
+  std::vector<unsigned int>().swap(vertexGlobalIndices_);
+  vertexPositions_.clear();
+
+  if (comm.rank()!=0)
+    return 0;
+
+  // Vertices shared by several processes arrive several times, with the same position
+  unsigned int numVertices = globalIndices.empty() ? 0 : *std::max_element(globalIndices.begin(), globalIndices.end()) + 1;
+  std::vector<bool> inserted(numVertices, false);
   vertexPositions_.resize(numVertices);
-  MPIHelper::getCollectiveCommunication().broadcast(&vertexPositions_[0], vertexPositions_.size(), 0);
+  for (std::size_t i=0; i<globalIndices.size(); i++) {
+    vertexPositions_[globalIndices[i]] = positions[i];
+    inserted[globalIndices[i]] = true;
+  }
 
-  // Broadcast the element corners
-  int numElementVertices = elementVertices_.size();
-  MPIHelper::getCollectiveCommunication().broadcast(&numElementVertices, 1, 0);
-  elementVertices_.resize(numElementVertices);
-  MPIHelper::getCollectiveCommunication().broadcast(&elementVertices_[0], elementVertices_.size(), 0);
+  // The elements are numbered by the rank that inserted them, and they go back to that rank
+  for (int rank=0; rank<comm.size(); rank++)
+    elementOwners.insert(elementOwners.end(), elementCounts[rank], rank);
 
-  // Broadcast the geometry types
-  int numElementTypes = elementTypes_.size();
-  MPIHelper::getCollectiveCommunication().broadcast(&numElementTypes, 1, 0);
-  elementTypes_.resize(numElementTypes);
-  MPIHelper::getCollectiveCommunication().broadcast(&elementTypes_[0], elementTypes_.size(), 0);
+  return std::count(inserted.begin(), inserted.end(), false);
+}
+
+template <int dimworld>
+void GridFactory<UGGrid<dimworld> >::
+extractBoundary(int missingVertices,
+                std::vector<int>& isBoundaryNode,
+                std::vector<unsigned int>& nodePermutation,
+                std::vector<FieldVector<double, dimworld> >& boundaryNodePositions,
+                std::vector<std::array<int, dimworld*2-2> >& segmentCorners) const
+{
+  if (missingVertices > 0)
+    DUNE_THROW(GridError, missingVertices << " global vertex indices of the distributed coarse grid have not been inserted!");
 
-  // ///////////////////////////////////////////
-  //   Extract grid boundary segments
-  // ///////////////////////////////////////////
   std::set<UGGridBoundarySegment<dimworld> > boundarySegments;
-  typedef typename std::set<UGGridBoundarySegment<dimworld> >::iterator SetIterator;
 
   BoundaryExtractor::detectBoundarySegments(elementTypes_, elementVertices_, boundarySegments);
   if (boundarySegments.empty())
     DUNE_THROW(GridError, "Couldn't extract grid boundary.");
 
-  std::vector<int> isBoundaryNode;
   BoundaryExtractor::detectBoundaryNodes(boundarySegments, vertexPositions_.size(), isBoundaryNode);
 
   dverb << boundarySegments.size() << " boundary segments were found!" << std::endl;
 
-  if (grid_->boundarySegments_.size() > boundarySegments.size())
-    DUNE_THROW(GridError, "You have supplied " << grid_->boundarySegments_.size()
+  if (boundarySegmentVertices_.size() > boundarySegments.size())
+    DUNE_THROW(GridError, "You have supplied " << boundarySegmentVertices_.size()
                                                << " parametrized boundary segments, but the coarse grid has only "
                                                << boundarySegments.size() << " boundary faces!");
 
-  // Count number of nodes on the boundary
-  int noOfBNodes = 0;
-  for (unsigned int i=0; i<isBoundaryNode.size(); i++) {
-    if (isBoundaryNode[i] != -1)
-      noOfBNodes++;
-  }
-
   // ///////////////////////////////////////////////////////
   //   UG needs all boundary vertices first.  We set up
   //   up an array to keep track of the reordering.
   // ///////////////////////////////////////////////////////
-  std::vector<unsigned int> nodePermutation;
-
   for (unsigned int i=0; i<isBoundaryNode.size(); ++i) {
     if (isBoundaryNode[i]!=-1)
       nodePermutation.push_back(i);
   }
 
+  boundaryNodePositions.resize(nodePermutation.size());
+
   for (unsigned int i=0; i<isBoundaryNode.size(); ++i) {
     if (isBoundaryNode[i]==-1)
       nodePermutation.push_back(i);
+    else
+      boundaryNodePositions[isBoundaryNode[i]] = vertexPositions_[i];
+  }
+
+  // //////////////////////////////////////////////////////////////////
+  //   The explicitly given segments come first.  Remove each of them
+  //   from the set of computed boundary segments, to mark that it
+  //   has been handled.
+  // //////////////////////////////////////////////////////////////////
+  for (std::size_t i=0; i<boundarySegmentVertices_.size(); i++) {
+
+    std::array<int, dimworld*2-2> corners;
+    UGGridBoundarySegment<dimworld> thisSegment;
+    for (int j=0; j<dimworld*2-2; j++) {
+      // -1 is used as a sentinel value for unused vertices and must be preserved.
+      const auto idx = boundarySegmentVertices_[i][j];
+      corners[j] = idx == -1 ? -1 : isBoundaryNode[idx];
+      thisSegment[j] = idx;
+    }
+
+    if (boundarySegments.erase(thisSegment) == 0)
+      DUNE_THROW(GridError, "You have provided a boundary parametrization for"
+                 << " a segment which is not boundary segment in the grid!");
+
+    segmentCorners.push_back(corners);
+  }
+
+  // ///////////////////////////////////////////////////////////////////////
+  //   The boundary segments remaining in the std::set boundarySegments
+  //   have not been provided with an explicit parametrization.  They are
+  //   inserted into the domain as straight boundary segments.
+  // ///////////////////////////////////////////////////////////////////////
+  for (const auto& thisSegment : boundarySegments) {
+
+    std::array<int, dimworld*2-2> corners;
+    corners.fill(-1);
+    for (int j=0; j<thisSegment.numVertices(); j++)
+      corners[j] = isBoundaryNode[thisSegment[j]];
+
+    segmentCorners.push_back(corners);
+  }
+}
+
+template <int dimworld>
+void GridFactory<UGGrid<dimworld> >::
+distributeToOwners(const std::vector<unsigned int>& elementOwners)
+{
+  // The targetProcessors argument of loadBalance is indexed like this mapper
+  typedef MultipleCodimMultipleGeomTypeMapper<typename UGGrid<dimworld>::LeafGridView, MCMGElementLayout> ElementMapper;
+  ElementMapper elementMapper(grid_->leafGridView());
+
+  std::vector<typename UGGrid<dimworld>::Rank> targetProcessors(elementMapper.size());
+  for (const auto& element : elements(grid_->leafGridView()))
+    targetProcessors[elementMapper.index(element)] = elementOwners[insertionIndex(element)];
+
+  // The elements of each rank are consecutive, their insertion index on that rank
+  // is the distance to the first of them
+  std::vector<unsigned int> localIndices(elementOwners.size());
+  for (std::size_t i=0, first=0; i<elementOwners.size(); i++) {
+    if (i>0 && elementOwners[i]!=elementOwners[i-1])
+      first = i;
+    localIndices[i] = i - first;
+  }
+
+  std::vector<unsigned int> elementInsertionIndices;
+  InsertionIndexHandle<UGGrid<dimworld> > dataHandle(*grid_, localIndices, elementInsertionIndices);
+  grid_->loadBalance(targetProcessors, 0, dataHandle);
+
+  elementInsertionIndices_.swap(elementInsertionIndices);
+}
+
+template <int dimworld>
+UGGrid<dimworld>* GridFactory<UGGrid<dimworld> >::
+createGrid()
+{
+  // Prevent a crash when this method is called twice in a row
+  // You never know who may do this...
+  if (grid_==nullptr)
+    return nullptr;
+
+  // ///////////////////////////////////////////////////////////////////////////////
+  //  UG creates the coarse grid on the master process only, and distributes it
+  //  later on.  If the processes have inserted their parts of a distributed
+  //  coarse grid, collect the parts on the master first.
+  // ///////////////////////////////////////////////////////////////////////////////
+  const auto& comm = MPIHelper::getCollectiveCommunication();
+
+  int distributed = !vertexGlobalIndices_.empty();
+  distributed = comm.max(distributed);
+
+  // Throw on all processes, the others would wait for the parts otherwise
+  elementInsertionIndices_.clear();
+  if (distributed) {
+    int consistent = (vertexGlobalIndices_.size() == vertexPositions_.size());
+    if (!comm.min(consistent))
+      DUNE_THROW(GridError, "Either all processes have to insert their vertices with global indices, or none!");
+  }
+
+  std::vector<unsigned int> elementOwners;
+  int missingVertices = 0;
+  if (distributed)
+    missingVertices = gatherDistributedGrid(elementOwners);
+
+  // ///////////////////////////////////////////////////////////////////////////////
+  //  Extract the grid boundary on the master process.
+  //
+  // All processes need the grid boundary to set up the UG domain, but only
+  // the master process needs the grid itself.  Therefore only the boundary
+  // nodes and segments are broadcast from the master to the other processes,
+  // using the numbering of the boundary nodes in UG.  The segments are
+  // ordered as they are inserted into the domain: first those that were
+  // given explicitly, then the ones found in the grid.
+  // ///////////////////////////////////////////////////////////////////////////////
+  std::vector<int> isBoundaryNode;
+  std::vector<unsigned int> nodePermutation;
+  std::vector<FieldVector<double,dimworld> > boundaryNodePositions;
+  std::vector<std::array<int, dimworld*2-2> > segmentCorners;
+
+  std::string error;
+  if (PPIF::me==0) {
+    try {
+      extractBoundary(missingVertices, isBoundaryNode, nodePermutation, boundaryNodePositions, segmentCorners);
+    } catch (GridError& e) {
+      error = e.what();
+    }
+  }
+
+  int failed = !error.empty();
+  comm.broadcast(&failed, 1, 0);
+  if (failed)
+    DUNE_THROW(GridError, ((PPIF::me==0) ? error : std::string("Extracting the grid boundary on the master process failed!")));
+
+  // Broadcast the boundary nodes
+  int noOfBNodes = boundaryNodePositions.size();
+  comm.broadcast(&noOfBNodes, 1, 0);
+  boundaryNodePositions.resize(noOfBNodes);
+  comm.broadcast(boundaryNodePositions.data(), boundaryNodePositions.size(), 0);
+
+  // Broadcast the corners of the boundary segments
+  int numSegments = segmentCorners.size();
+  comm.broadcast(&numSegments, 1, 0);
+  segmentCorners.resize(numSegments);
+  comm.broadcast(segmentCorners.data()->data(), segmentCorners.size()*(dimworld*2-2), 0);
+
+  // The other processes do not need their grid data anymore
+  if (PPIF::me!=0) {
+    std::vector<FieldVector<double, dimworld> >().swap(vertexPositions_);
+    std::vector<unsigned char>().swap(elementTypes_);
+    std::vector<unsigned int>().swap(elementVertices_);
   }
 
   // ///////////////////////////////////////////
   //   Create the domain data structure
   // ///////////////////////////////////////////
-  grid_->numBoundarySegments_ = boundarySegments.size();
+  grid_->numBoundarySegments_ = numSegments;
   std::string domainName = grid_->name_ + "_Domain";
 
   if (UG_NS<dimworld>::CreateDomain(domainName.c_str(),     // The domain name
@@ -310,8 +637,7 @@ createGrid()
   // ///////////////////////////////////////////
   //   Insert the boundary segments
   // ///////////////////////////////////////////
-  unsigned int i;
-  for (i=0; i<grid_->boundarySegments_.size(); i++) {
+  for (int i=0; i<numSegments; i++) {
 
     // Create some boundary segment name
     char segmentName[20];
@@ -319,16 +645,17 @@ createGrid()
       DUNE_THROW(GridError, "sprintf returned error code!");
 
     // Copy the vertices into a C-style array
-    // We copy four vertices here even if the segment is a triangle -- it doesn't matter
+    // For parameterized boundary segments, -1 is used as a sentinel value
+    // for unused vertices.
     int vertices_c_style[dimworld*2-2];
+    int numVertices = 0;
     for (int j=0; j<dimworld*2-2; j++) {
-      // For parameterized boundary segments, -1 is used as a sentinel value
-      // for unused vertices and must be preserved.
-      const auto idx = boundarySegmentVertices_[i][j];
-      vertices_c_style[j] = idx == -1 ? -1 : isBoundaryNode[idx];
+      vertices_c_style[j] = segmentCorners[i][j];
+      if (vertices_c_style[j] != -1)
+        numVertices++;
     }
 
-    if (grid_->boundarySegments_[i]) {
+    if (i < int(grid_->boundarySegments_.size()) && grid_->boundarySegments_[i]) {
 
       // Create dummy parameter ranges
       const double alpha[2] = {0, 0};
@@ -360,14 +687,10 @@ createGrid()
 
     } else {       // No explicit boundary parametrization has been given. We insert a linear segment
 
-      int numVertices = (dimworld==2)
-                        ? 2
-                        : ((boundarySegmentVertices_[i][3]==-1) ? 3 : 4);
-
       double segmentCoordinates[dimworld*2-2][dimworld];
       for (int j=0; j<numVertices; j++)
         for (int k=0; k<dimworld; k++)
-          segmentCoordinates[j][k] = vertexPositions_[boundarySegmentVertices_[i][j]][k];
+          segmentCoordinates[j][k] = boundaryNodePositions[vertices_c_style[j]][k];
 
       if (UG_NS<dimworld>::CreateLinearSegment(segmentName,
                                                1,               /*id of left subdomain */
@@ -380,64 +703,6 @@ createGrid()
         DUNE_THROW(IOError, "Error calling CreateLinearSegment");
 
     }
-
-    // /////////////////////////////////////////////////////////////////////
-    //   Remove this segment from the set of computed boundary segments.
-    // /////////////////////////////////////////////////////////////////////
-
-    UGGridBoundarySegment<dimworld> thisSegment;
-    /** \todo Not nice: we need to copy because the array types are different */
-    for (int j=0; j<2*dimworld-2; j++)
-      thisSegment[j] = boundarySegmentVertices_[i][j];
-
-    SetIterator boundaryElementFace = boundarySegments.find(thisSegment);
-
-    if (boundaryElementFace==boundarySegments.end())
-      DUNE_THROW(GridError, "You have provided a boundary parametrization for"
-                 << " a segment which is not boundary segment in the grid!");
-
-    // Everything is fine.  Delete the element face from the list to mark that it has been properly handled
-    boundarySegments.erase(thisSegment);
-  }
-
-
-  // ///////////////////////////////////////////////////////////////////////
-  //   The boundary segments remaining in the std::set boundarySegments
-  //   have not been provided with an explicit parametrization.  They are
-  //   inserted into the domain as straight boundary segments.
-  // ///////////////////////////////////////////////////////////////////////
-  SetIterator it = boundarySegments.begin();
-
-  for (; it != boundarySegments.end(); ++it, ++i) {
-
-    const UGGridBoundarySegment<dimworld>& thisSegment = *it;
-
-    // Copy the vertices into a C-style array
-    int vertices_c_style[4];
-
-    for (int j=0; j<thisSegment.numVertices(); j++)
-      vertices_c_style[j] = isBoundaryNode[thisSegment[j]];
-
-    // Create some boundary segment name
-    char segmentName[20];
-    if(sprintf(segmentName, "BS %d", i) < 0)
-      DUNE_THROW(GridError, "sprintf returned error code!");
-
-    double segmentCoordinates[2*dimworld-2][dimworld];
-    for (int j=0; j<thisSegment.numVertices(); j++)
-      for (int k=0; k<dimworld; k++)
-        segmentCoordinates[j][k] = vertexPositions_[thisSegment[j]][k];
-
-    if (UG_NS<dimworld>::CreateLinearSegment(segmentName,
-                                             1,        /*id of left subdomain */
-                                             2,       /*id of right subdomain*/
-                                             i,           /*id of segment*/
-                                             thisSegment.numVertices(),   // Number of corners
-                                             vertices_c_style,
-                                             segmentCoordinates
-                                             )==nullptr)
-      DUNE_THROW(IOError, "Error calling CreateLinearSegment");
-
   }
 
 
@@ -495,6 +760,10 @@ createGrid()
     Release(grid_->multigrid_->theHeap, UG::FROM_TOP, grid_->multigrid_->MarkKey);
     grid_->multigrid_->MarkKey = 0;
 
+    // Receive the elements inserted on this process
+    if (distributed)
+      distributeToOwners(elementOwners);
+
     // ///////////////////////////////////////////////////
     // hand over the grid and delete the member pointer
     // ///////////////////////////////////////////////////
@@ -557,6 +826,9 @@ createGrid()
   for (const auto& element : elements(grid_->levelGridView(0)))
     UG_NS<dimworld>::WriteCW(grid_->getRealImplementation(element).target_, UG_NS<dimworld>::NEWEL_CE, 0);
 
+  // Send the elements back to the processes that inserted them
+  if (distributed)
+    distributeToOwners(elementOwners);
 
   // ///////////////////////////////////////////////////
   // hand over the grid and delete the member pointer
@@ -151,6 +151,31 @@ namespace Dune {
      to actually distribute the grid.
      </p>
 
+     <p>
+     Alternatively, each process can insert only its own part of the coarse grid.
+     Insert the vertices of the part by calling
+     </p>
+
+     <pre>
+     factory.insertVertex(const FieldVector&lt;double,dimworld&gt;& position, unsigned int globalIndex);
+     </pre>
+
+     <p>
+     where <b>globalIndex</b> numbers the vertices of the whole coarse grid consecutively,
+     starting at zero.  Vertices shared by several parts are inserted on each of the
+     processes with the same global index.  The elements refer to the vertices by the
+     order of insertion on the process, as above, and the boundary segments by the
+     global indices.  When all processes call <tt>createGrid()</tt>, the parts are collected
+     on the master process, as UG creates the coarse grid there, and the grid is
+     distributed right away: each element goes to the process that inserted it.
+     Only the boundary of the domain is sent to all processes, not the whole grid.
+     The boundary segments are only taken from the master process, the vertices given to
+     <tt>insertBoundarySegment()</tt> on the other processes are ignored.  Their
+     parametrizations are still needed on all processes, see below.
+     <tt>insertionIndex()</tt> of an element returns its number in the order of insertion
+     on its process, <tt>insertionIndex()</tt> of a vertex is not supported.
+     </p>
+
      <p>\warning To use a parametrized boundary on a parallel machine you need
      to hand over the boundary segments to the grid factory on <b>all</b> processes.
      This behavior violates the Dune grid interface specification and will be
@@ -189,6 +214,12 @@ namespace Dune {
     /** \brief Insert a vertex into the coarse grid */
     virtual void insertVertex(const FieldVector<ctype,dimworld>& pos);
 
+    /** \brief Insert a vertex of the part of a distributed coarse grid on this process
+        \param pos The position of the vertex
+        \param globalIndex The index of the vertex in the whole coarse grid
+     */
+    void insertVertex(const FieldVector<ctype,dimworld>& pos, unsigned int globalIndex);
+
     /** \brief Insert an element into the coarse grid
         \param type The GeometryType of the new element
         \param vertices The vertices of the new element, using the DUNE numbering
@@ -196,6 +227,38 @@ namespace Dune {
     virtual void insertElement(const GeometryType& type,
                                const std::vector<unsigned int>& vertices);
 
+    /** \brief Reserve storage for the given numbers of vertices and elements */
+    virtual void reserve(std::size_t numVertices, std::size_t numElements);
+
+    /** \brief Insert several vertices into the coarse grid
+        \param coordinates The coordinates of the vertices, dimworld consecutive values per vertex
+        \param numVertices The number of vertices
+     */
+    virtual void insertVertices(const ctype* coordinates, std::size_t numVertices);
+
+    /** \brief Insert several vertices of the part of a distributed coarse grid on this process
+        \param coordinates The coordinates of the vertices, dimworld consecutive values per vertex
+        \param globalIndices The indices of the vertices in the whole coarse grid
+        \param numVertices The number of vertices
+     */
+    void insertVertices(const ctype* coordinates, const unsigned int* globalIndices, std::size_t numVertices);
+
+    /** \brief Insert several elements of the same type into the coarse grid
+        \param type The GeometryType of the new elements
+        \param vertices The vertices of the new elements, using the DUNE numbering
+        \param numElements The number of elements
+     */
+    virtual void insertElements(const GeometryType& type,
+                                const unsigned int* vertices, std::size_t numElements);
+
+    /** \brief Insert several elements into the coarse grid, whose types are given by their numbers of corners
+        \param offsets The corners of element i are the entries offsets[i] to offsets[i+1]-1 of vertices
+        \param vertices The vertices of the new elements, using the DUNE numbering
+        \param numElements The number of elements
+     */
+    virtual void insertElements(const unsigned int* offsets,
+                                const unsigned int* vertices, std::size_t numElements);
+
     /** \brief Method to insert a boundary segment into a coarse grid
 
        Using this method is optional.  It only influences the ordering of the segments
@@ -228,17 +291,22 @@ namespace Dune {
 
     /** \brief Return the number of the element in the order of insertion into the factory
      *
-     * For UGGrid elements this number is the same as the element level index
+     * For UGGrid elements this number is the same as the element level index.
+     * For a distributed coarse grid it is the number in the order of insertion
+     * on the process that inserted the element.
      */
     virtual unsigned int
     insertionIndex ( const typename Codim< 0 >::Entity &entity ) const
     {
-      return UG_NS<dimension>::levelIndex(grid_->getRealImplementation(entity).target_);
+      const unsigned int levelIndex = UG_NS<dimension>::levelIndex(grid_->getRealImplementation(entity).target_);
+      return elementInsertionIndices_.empty() ? levelIndex : elementInsertionIndices_[levelIndex];
     }
 
     /** \brief Return the number of the vertex in the order of insertion into the factory
      *
-     * For UGGrid vertices this number is the same as the vertex level index
+     * For UGGrid vertices this number is the same as the vertex level index.
+     * This is not supported for a distributed coarse grid, whose vertices are
+     * renumbered when the grid is distributed.
      */
     virtual unsigned int
     insertionIndex ( const typename Codim< dimension >::Entity &entity ) const
@@ -268,6 +336,23 @@ namespace Dune {
     // Initialize the grid structure in UG
     void createBegin();
 
+    // Reorder the corners of an element from the DUNE to the UG numbering
+    static void toUGNumbering(unsigned int* corners, std::size_t numCorners);
+
+    // Collect the parts of a distributed coarse grid on the master process,
+    // returns the number of global vertex indices that were not inserted
+    int gatherDistributedGrid(std::vector<unsigned int>& elementOwners);
+
+    // Find the boundary of the coarse grid on the master process
+    void extractBoundary(int missingVertices,
+                         std::vector<int>& isBoundaryNode,
+                         std::vector<unsigned int>& nodePermutation,
+                         std::vector<FieldVector<double, dimworld> >& boundaryNodePositions,
+                         std::vector<std::array<int, dimworld*2-2> >& segmentCorners) const;
+
+    // Move the elements of a distributed coarse grid to the processes that inserted them
+    void distributeToOwners(const std::vector<unsigned int>& elementOwners);
+
     // Pointer to the grid being built
     UGGrid<dimworld>* grid_;
 
@@ -289,6 +374,12 @@ namespace Dune {
     /** \brief Buffer the vertices until createend() is called */
     std::vector<FieldVector<double, dimworld> > vertexPositions_;
 
+    /** \brief The global indices of the vertices, if the processes insert a distributed coarse grid */
+    std::vector<unsigned int> vertexGlobalIndices_;
+
+    /** \brief For a distributed coarse grid, the insertion index on this process of each element, by level index */
+    std::vector<unsigned int> elementInsertionIndices_;
+
   };
 
 }
@@ -2,11 +2,68 @@
 // vi: set et ts=4 sw=2 sts=2:
 #include <config.h>
 
+#include <algorithm>
+#include <map>
+
 #include <dune/grid/uggrid.hh>
 #include <dune/grid/uggrid/uggridindexsets.hh>
 
 namespace Dune {
 
+namespace {
+
+  // The key of an edge for UGGridIndexSlots: its two vertices, given by UG corner numbers of an element
+  template <int dim>
+  std::array<const void*, 2> edgeKey(const typename UG_NS<dim>::Element* target, int a, int b)
+  {
+    std::array<const void*, 2> key = {{UG_NS<dim>::Corner(target,a)->myvertex, UG_NS<dim>::Corner(target,b)->myvertex}};
+    std::sort(key.begin(), key.end());
+    return key;
+  }
+
+  // The key of a face for UGGridIndexSlots: its three or four vertices, given by the DUNE face number of an element
+  template <int dim>
+  std::array<const void*, 4> faceKey(const typename UG_NS<dim>::Element* target, const GeometryType& gt, int i)
+  {
+    const auto& refElement = ReferenceElements<double,dim>::general(gt);
+    std::array<const void*, 4> key = {{nullptr, nullptr, nullptr, nullptr}};
+    const int corners = refElement.size(i,1,dim);
+    for (int k=0; k<corners; k++)
+      key[k] = UG_NS<dim>::Corner(target,UGGridRenumberer<dim>::verticesDUNEtoUG(refElement.subEntity(i,1,k,dim),gt))->myvertex;
+    std::sort(key.begin(), key.begin()+corners);
+    return key;
+  }
+
+  // Set the leaf index of an edge of an element, given by UG corner numbers, and of its copies on coarser levels
+  template <int dim>
+  void setEdgeLeafIndex(typename UG_NS<dim>::Element* target, int a, int b, int index)
+  {
+    UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(target,a), UG_NS<dim>::Corner(target,b))) = index;
+    typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target);
+    while (father_!=0)
+    {
+      if (!UG_NS<dim>::hasCopy(father_)) break;                 // handle only copies
+      UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(father_,a), UG_NS<dim>::Corner(father_,b))) = index;
+      father_ = UG_NS<dim>::EFather(father_);
+    }
+  }
+
+  // Set the leaf index of a face of an element, given by the UG side number, and of its copies on coarser levels
+  template <int dim>
+  void setFaceLeafIndex(typename UG_NS<dim>::Element* target, int side, UG::UINT index)
+  {
+    UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(target,side)) = index;
+    typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target);
+    while (father_!=0)
+    {
+      if (!UG_NS<dim>::hasCopy(father_)) break;                 // handle only copies
+      UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(father_,side)) = index;
+      father_ = UG_NS<dim>::EFather(father_);
+    }
+  }
+
+} // end anonymous namespace
+
 template <class GridImp>
 void UGGridLevelIndexSet<GridImp>::update(const GridImp& grid, int level, std::vector<unsigned int>* nodePermutation) {
 
@@ -145,6 +202,17 @@ void UGGridLevelIndexSet<GridImp>::update(const GridImp& grid, int level, std::v
 
   myTypes_[dim].resize(0);
   myTypes_[dim].push_back(GeometryType(GeometryType::cube,0));
+
+  valid_.store(true, std::memory_order_release);
+}
+
+template <class GridImp>
+void UGGridLevelIndexSet<GridImp>::makeValid() const
+{
+  // Several threads may use the index set at the same time, only the first one recomputes it
+  std::lock_guard<std::mutex> lock(updateMutex_);
+  if (!valid_.load(std::memory_order_relaxed))
+    const_cast<UGGridLevelIndexSet*>(this)->update(*grid_, level_);
 }
 
 template <class GridImp>
@@ -198,6 +266,10 @@ void UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutat
   numTriFaces_  = 0;
   numQuadFaces_ = 0;
 
+  edgeSlots_.clear();
+  faceSlots_[0].clear();
+  faceSlots_[1].clear();
+
   // second loop : set indices
   for (int level_=grid_.maxLevel(); level_>=0; level_--)
   {
@@ -233,6 +305,11 @@ void UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutat
         {
           // get new index and assign
           index = numEdges_++;
+          edgeSlots_.set(index,
+                         edgeKey<dim>(target_,
+                                      UGGridRenumberer<dim>::verticesDUNEtoUG(a,gt),
+                                      UGGridRenumberer<dim>::verticesDUNEtoUG(b,gt)),
+                         level_);
           // write index through to coarser grids
           typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target_);
           while (father_!=0)
@@ -245,6 +322,8 @@ void UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutat
             father_ = UG_NS<dim>::EFather(father_);
           }
         }
+        else
+          edgeSlots_.visit(index, level_);
       }
 
       // codim 1 (faces): todo
@@ -253,10 +332,10 @@ void UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutat
         {
           GeometryType gt = element.type();
           UG::UINT& index = UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(target_,UGGridRenumberer<dim>::facesDUNEtoUG(i,gt)));
+          GeometryType gtType = ReferenceElements<double,dim>::general(gt).type(i,1);
           if (index==std::numeric_limits<UG::UINT>::max())                       // not visited yet
           {
             // get new index and assign
-            GeometryType gtType = ReferenceElements<double,dim>::general(gt).type(i,1);
             if (gtType.isSimplex())
               index = numTriFaces_++;
             else if (gtType.isCube())
@@ -265,6 +344,7 @@ void UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutat
               std::cout << "face geometry type is " << gtType << std::endl;
               DUNE_THROW(GridError, "wrong geometry type in face");
             }
+            faceSlots_[gtType.isCube()].set(index, faceKey<dim>(target_,gt,i), level_);
             // write index through to coarser grid
             typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target_);
             while (father_!=0)
@@ -274,6 +354,8 @@ void UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutat
               father_ = UG_NS<dim>::EFather(father_);
             }
           }
+          else
+            faceSlots_[gtType.isCube()].visit(index, level_);
         }
 
       // set the isLeaf information of the nodes based on the leaf elements
@@ -290,20 +372,6 @@ void UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutat
 
   }
 
-  // Update the list of geometry types present
-  myTypes_[dim-1].resize(0);
-  myTypes_[dim-1].push_back(GeometryType(GeometryType::cube,1));
-
-  if (dim==3) {
-
-    myTypes_[1].resize(0);
-    if (numTriFaces_ > 0)
-      myTypes_[1].push_back(GeometryType(GeometryType::simplex,dim-1));
-    if (numQuadFaces_ > 0)
-      myTypes_[1].push_back(GeometryType(GeometryType::cube,dim-1));
-
-  }
-
   // ///////////////////////////////
   //   Init the element indices
   // ///////////////////////////////
@@ -312,25 +380,259 @@ void UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutat
   numPrisms_    = 0;
   numCubes_     = 0;
 
+  for (auto& slots : elementSlots_)
+    slots.clear();
+
   for (const auto& element : elements(grid_.leafGridView())) {
 
     GeometryType eType = element.type();
+    typename UG_NS<dim>::Element* target = grid_.getRealImplementation(element).target_;
+    int& index = UG_NS<dim>::leafIndex(target);
 
     if (eType.isSimplex())
-      UG_NS<dim>::leafIndex(grid_.getRealImplementation(element).target_) = numSimplices_++;
+      index = numSimplices_++;
     else if (eType.isPyramid())
-      UG_NS<dim>::leafIndex(grid_.getRealImplementation(element).target_) = numPyramids_++;
+      index = numPyramids_++;
     else if (eType.isPrism())
-      UG_NS<dim>::leafIndex(grid_.getRealImplementation(element).target_) = numPrisms_++;
+      index = numPrisms_++;
     else if (eType.isCube())
-      UG_NS<dim>::leafIndex(grid_.getRealImplementation(element).target_) = numCubes_++;
+      index = numCubes_++;
     else {
       DUNE_THROW(GridError, "Found the GeometryType " << eType
                                                       << ", which should never occur in a UGGrid!");
     }
+    elementSlots_[typeSlot(eType)].set(index, {{target}}, element.level());
   }
 
-  // Update the list of geometry types present
+  // //////////////////////////////
+  //   Init the vertex indices
+  // //////////////////////////////
+  // leaf index in node writes through to vertex !
+  numVertices_ = 0;
+  vertexSlots_.clear();
+
+  for (const auto& vertex : vertices(grid_.leafGridView()))
+  {
+    typename UG_NS<dim>::Node* node = grid_.getRealImplementation(vertex).target_;
+    std::array<const void*, 1> key = {{node->myvertex}};
+    int& index = UG_NS<dim>::leafIndex(node);
+    if (nodePermutation!=0 and grid_.maxLevel()==0)
+      index = (*nodePermutation)[numVertices_++];
+    else
+      index = numVertices_++;
+
+    // The iterator visits the finest leaf node of the vertex, look for the coarsest one
+    int level = vertex.level();
+    for (node = UG_NS<dim>::NodeNodeFather(node); node; node = UG_NS<dim>::NodeNodeFather(node))
+      if (node->isLeaf)
+        level = UG_NS<dim>::myLevel(node);
+    vertexSlots_.set(index, key, level);
+  }
+
+  updateTypes();
+}
+
+template <class GridImp>
+void UGGridLeafIndexSet<GridImp>::updateIncremental(int firstChangedLevel)
+{
+  // Everything may have changed
+  if (firstChangedLevel <= 0)
+  {
+    update();
+    return;
+  }
+
+  for (auto& slots : elementSlots_)
+    slots.begin(firstChangedLevel);
+  vertexSlots_.begin(firstChangedLevel);
+  edgeSlots_.begin(firstChangedLevel);
+  faceSlots_[0].begin(firstChangedLevel);
+  faceSlots_[1].begin(firstChangedLevel);
+
+  // //////////////////////////////////////////////////////////////////
+  //   Clear the indices of edges and faces and the isLeaf information
+  //   of the nodes on the changed levels.  The coarser levels are not
+  //   touched, their leaf elements and the entities contained in them
+  //   did not change.
+  // //////////////////////////////////////////////////////////////////
+  for (int level_=grid_.maxLevel(); level_>=firstChangedLevel; level_--)
+  {
+    for (const auto& element : elements(grid_.levelGridView(level_)))
+    {
+      typename UG_NS<dim>::Element* target_ = grid_.getRealImplementation(element).target_;
+      GeometryType gt = element.type();
+
+      for (unsigned int i=0; i<element.subEntities(dim-1); i++)
+      {
+        int a = ReferenceElements<double,dim>::general(gt).subEntity(i,dim-1,0,dim);
+        int b = ReferenceElements<double,dim>::general(gt).subEntity(i,dim-1,1,dim);
+        UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(target_,UGGridRenumberer<dim>::verticesDUNEtoUG(a,gt)),
+                                                  UG_NS<dim>::Corner(target_,UGGridRenumberer<dim>::verticesDUNEtoUG(b,gt)))) = -1;
+      }
+
+      if (dim==3)
+        for (unsigned int i=0; i<element.subEntities(1); i++)
+          UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(target_,UGGridRenumberer<dim>::facesDUNEtoUG(i,gt)))
+            = std::numeric_limits<UG::UINT>::max();
+
+      for (unsigned int i=0; i<element.subEntities(dim); i++)
+        UG_NS<dim>::Corner(target_,i)->isLeaf = false;
+    }
+  }
+
+  // ///////////////////////////////////////////////////////////////////
+  //   Visit the leaf elements of the changed levels from top to bottom.
+  //   Elements and vertices take their old index back if it was
+  //   released, edges and faces contained in unchanged leaf elements
+  //   find their index on a copy of the element on a coarser level.
+  //   All other entities get an index after the traversal.
+  // ///////////////////////////////////////////////////////////////////
+  std::vector<std::pair<typename UG_NS<dim>::Element*, int> > newElements;
+  std::vector<std::pair<typename UG_NS<dim>::Node*, int> > newVertices;
+  std::map<const void*, std::size_t> newVertexPosition;
+
+  for (int level_=grid_.maxLevel(); level_>=firstChangedLevel; level_--)
+  {
+    for (const auto& element : elements(grid_.levelGridView(level_)))
+    {
+      if (!element.isLeaf())
+        continue;
+
+      typename UG_NS<dim>::Element* target_ = grid_.getRealImplementation(element).target_;
+      GeometryType gt = element.type();
+
+      // codim 0
+      int elementIndex = UG_NS<dim>::leafIndex(target_);
+      if (elementIndex < 0
+          || !elementSlots_[typeSlot(gt)].claim(elementIndex, {{target_}}, level_, std::make_pair(target_,0)))
+        newElements.push_back(std::make_pair(target_, typeSlot(gt)));
+
+      // codim dim-1 (edges)
+      for (unsigned int i=0; i<element.subEntities(dim-1); i++)
+      {
+        int a = UGGridRenumberer<dim>::verticesDUNEtoUG(ReferenceElements<double,dim>::general(gt).subEntity(i,dim-1,0,dim),gt);
+        int b = UGGridRenumberer<dim>::verticesDUNEtoUG(ReferenceElements<double,dim>::general(gt).subEntity(i,dim-1,1,dim),gt);
+        int index = UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(target_,a), UG_NS<dim>::Corner(target_,b)));
+        if (index >= 0)
+        {
+          edgeSlots_.visit(index, level_);
+          continue;
+        }
+
+        std::array<const void*, 2> key = edgeKey<dim>(target_,a,b);
+        bool kept = false;
+        typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target_);
+        for (; !kept && father_!=0 && UG_NS<dim>::hasCopy(father_); father_ = UG_NS<dim>::EFather(father_))
+        {
+          index = UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(father_,a), UG_NS<dim>::Corner(father_,b)));
+          kept = UG_NS<dim>::myLevel(father_) < firstChangedLevel && index >= 0 && edgeSlots_.isKept(index, key);
+        }
+        if (!kept)
+          index = edgeSlots_.assign(key, level_, std::make_pair(target_, 8*a+b));
+        setEdgeLeafIndex<dim>(target_, a, b, index);
+      }
+
+      // codim 1 (faces)
+      if (dim==3)
+        for (unsigned int i=0; i<element.subEntities(1); i++)
+        {
+          int side = UGGridRenumberer<dim>::facesDUNEtoUG(i,gt);
+          UG::UINT index = UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(target_,side));
+          UGGridIndexSlots<4>& slots = faceSlots_[ReferenceElements<double,dim>::general(gt).type(i,1).isCube()];
+          if (index != std::numeric_limits<UG::UINT>::max())
+          {
+            slots.visit(index, level_);
+            continue;
+          }
+
+          std::array<const void*, 4> key = faceKey<dim>(target_,gt,i);
+          bool kept = false;
+          typename UG_NS<dim>::Element* father_ = UG_NS<dim>::EFather(target_);
+          for (; !kept && father_!=0 && UG_NS<dim>::hasCopy(father_); father_ = UG_NS<dim>::EFather(father_))
+          {
+            index = UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(father_,side));
+            kept = UG_NS<dim>::myLevel(father_) < firstChangedLevel && slots.isKept(index, key);
+          }
+          if (!kept)
+            index = slots.assign(key, level_, std::make_pair(target_, side));
+          setFaceLeafIndex<dim>(target_, side, index);
+        }
+
+      // codim dim (vertices), and the isLeaf information of the nodes
+      for (unsigned int i=0; i<element.subEntities(dim); i++)
+      {
+        typename UG_NS<dim>::Node* theNode = UG_NS<dim>::Corner(target_,i);
+        theNode->isLeaf = true;
+
+        std::array<const void*, 1> key = {{theNode->myvertex}};
+        int index = UG_NS<dim>::leafIndex(theNode);
+        if (index >= 0 && (vertexSlots_.isKept(index, key) || vertexSlots_.isOwnedBy(index, key)))
+          vertexSlots_.visit(index, level_);
+        else if (index < 0 || !vertexSlots_.claim(index, key, level_, std::make_pair(theNode,0)))
+        {
+          auto position = newVertexPosition.insert(std::make_pair(key[0], newVertices.size()));
+          if (position.second)
+            newVertices.push_back(std::make_pair(theNode, level_));
+          else
+            newVertices[position.first->second].second = level_;
+        }
+      }
+    }
+  }
+
+  for (const auto& element : newElements)
+  {
+    typename UG_NS<dim>::Element* target = element.first;
+    UG_NS<dim>::leafIndex(target) = elementSlots_[element.second].assign({{target}}, UG_NS<dim>::myLevel(target),
+                                                                         std::make_pair(target,0));
+  }
+
+  for (const auto& vertex : newVertices)
+  {
+    std::array<const void*, 1> key = {{vertex.first->myvertex}};
+    UG_NS<dim>::leafIndex(vertex.first) = vertexSlots_.assign(key, vertex.second, std::make_pair(vertex.first,0));
+  }
+
+  // //////////////////////////////////////////////////////////
+  //   Make the indices consecutive again
+  // //////////////////////////////////////////////////////////
+  bool compact = true;
+  for (auto& slots : elementSlots_)
+    compact = compact && slots.compact([](std::pair<void*, int> object, unsigned int index) {
+      UG_NS<dim>::leafIndex(static_cast<typename UG_NS<dim>::Element*>(object.first)) = index;
+    });
+  compact = compact && vertexSlots_.compact([](std::pair<void*, int> object, unsigned int index) {
+    UG_NS<dim>::leafIndex(static_cast<typename UG_NS<dim>::Node*>(object.first)) = index;
+  });
+  compact = compact && edgeSlots_.compact([](std::pair<void*, int> object, unsigned int index) {
+    setEdgeLeafIndex<dim>(static_cast<typename UG_NS<dim>::Element*>(object.first), object.second/8, object.second%8, index);
+  });
+  for (auto& slots : faceSlots_)
+    compact = compact && slots.compact([](std::pair<void*, int> object, unsigned int index) {
+      setFaceLeafIndex<dim>(static_cast<typename UG_NS<dim>::Element*>(object.first), object.second, index);
+    });
+
+  if (!compact)
+  {
+    update();
+    return;
+  }
+
+  numSimplices_ = elementSlots_[0].size();
+  numPyramids_  = elementSlots_[1].size();
+  numPrisms_    = elementSlots_[2].size();
+  numCubes_     = elementSlots_[3].size();
+  numVertices_  = vertexSlots_.size();
+  numEdges_     = edgeSlots_.size();
+  numTriFaces_  = (dim==3) ? faceSlots_[0].size() : 0;
+  numQuadFaces_ = (dim==3) ? faceSlots_[1].size() : 0;
+
+  updateTypes();
+}
+
+template <class GridImp>
+void UGGridLeafIndexSet<GridImp>::updateTypes()
+{
   myTypes_[0].resize(0);
   if (numSimplices_ > 0)
     myTypes_[0].push_back(GeometryType(GeometryType::simplex,dim));
@@ -341,27 +643,21 @@ void UGGridLeafIndexSet<GridImp>::update(std::vector<unsigned int>* nodePermutat
   if (numCubes_ > 0)
     myTypes_[0].push_back(GeometryType(GeometryType::cube,dim));
 
+  myTypes_[dim-1].resize(0);
+  myTypes_[dim-1].push_back(GeometryType(GeometryType::cube,1));
 
-  // //////////////////////////////
-  //   Init the vertex indices
-  // //////////////////////////////
-  // leaf index in node writes through to vertex !
-  numVertices_ = 0;
+  if (dim==3) {
+
+    myTypes_[1].resize(0);
+    if (numTriFaces_ > 0)
+      myTypes_[1].push_back(GeometryType(GeometryType::simplex,dim-1));
+    if (numQuadFaces_ > 0)
+      myTypes_[1].push_back(GeometryType(GeometryType::cube,dim-1));
 
-  if (nodePermutation!=0 and grid_.maxLevel()==0)
-  {
-    for (const auto& vertex : vertices(grid_.leafGridView()))
-      UG_NS<dim>::leafIndex(grid_.getRealImplementation(vertex).target_) = (*nodePermutation)[numVertices_++];
-  }
-  else
-  {
-    for (const auto& vertex : vertices(grid_.leafGridView()))
-      UG_NS<dim>::leafIndex(grid_.getRealImplementation(vertex).target_) = numVertices_++;
   }
 
   myTypes_[dim].resize(0);
   myTypes_[dim].push_back(GeometryType(0));
-
 }
 
 // Explicit template instantiations to compile the stuff in this file
@@ -7,6 +7,11 @@
     \brief The index and id sets for the UGGrid class
  */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <utility>
 #include <vector>
 #include <set>
 
@@ -40,13 +45,15 @@ namespace Dune {
         numVertices_(0),
         numEdges_(0),
         numTriFaces_(0),
-        numQuadFaces_(0)
+        numQuadFaces_(0),
+        valid_(false)
     {}
 
     //! get index of an entity
     template<int cd>
     unsigned int index (const typename GridImp::Traits::template Codim<cd>::Entity& e) const
     {
+      ensureValid();
       return UG_NS<dim>::levelIndex(grid_->getRealImplementation(e).getTarget());
     }
 
@@ -58,6 +65,8 @@ namespace Dune {
                            int i,
                            unsigned int codim) const
     {
+      ensureValid();
+
       // The entity is a vertex, so each subentity must be a vertex too (anything else is not supported)
       if (cc==dim)
       {
@@ -154,6 +163,7 @@ namespace Dune {
 
     //! get number of entities of given codim, type and on this level
     int size (int codim) const {
+      ensureValid();
       if (codim==0)
         return numSimplices_+numPyramids_+numPrisms_+numCubes_;
       if (codim==dim)
@@ -168,6 +178,7 @@ namespace Dune {
     //! get number of entities of given codim, type and on this level
     int size (GeometryType type) const
     {
+      ensureValid();
       int codim = GridImp::dimension-type.dim();
 
       if (codim==0) {
@@ -202,11 +213,12 @@ namespace Dune {
       DUNE_THROW(NotImplemented, "Wrong codim!");
     }
 
-    std::vector< GeometryType > types ( int codim ) const { return myTypes_[ codim ]; }
+    std::vector< GeometryType > types ( int codim ) const { ensureValid(); return myTypes_[ codim ]; }
 
     /** \brief Deliver all geometry types used in this grid */
     const std::vector<GeometryType>& geomTypes (int codim) const
     {
+      ensureValid();
       return myTypes_[codim];
     }
 
@@ -224,6 +236,18 @@ namespace Dune {
     /** \brief Update the level indices.  This method is called after each grid change */
     void update(const GridImp& grid, int level, std::vector<unsigned int>* nodePermutation=0);
 
+    /** \brief Mark the level indices as outdated after a grid change
+
+        They are recomputed when the index set is used next, references to the
+        index set (e.g., in mappers) stay valid.
+     */
+    void invalidate(const GridImp& grid, int level)
+    {
+      grid_ = &grid;
+      level_ = level;
+      valid_.store(false, std::memory_order_release);
+    }
+
     const GridImp* grid_;
     int level_;
 
@@ -237,6 +261,181 @@ namespace Dune {
     int numQuadFaces_;
 
     std::vector<GeometryType> myTypes_[dim+1];
+
+  private:
+    // Recompute the indices if they are outdated
+    void ensureValid() const
+    {
+      if (!valid_.load(std::memory_order_acquire))
+        makeValid();
+    }
+
+    void makeValid() const;
+
+    std::atomic<bool> valid_;
+    mutable std::mutex updateMutex_;
+  };
+
+  /** \brief The owners of the leaf indices of one geometry type of a UGGrid
+
+     UGGridLeafIndexSet::updateIncremental renumbers only the entities
+     contained in leaf elements of the levels changed by an adaptation step.
+     To this end this class remembers, for each index, the entity holding it
+     and the coarsest level of a leaf element containing that entity.  An
+     entity is identified by its UG object or by its corner vertices, which
+     are shared by all levels.
+
+     \tparam n The number of pointers identifying an entity
+   */
+  template <int n>
+  class UGGridIndexSlots
+  {
+  public:
+    typedef std::array<const void*, n> Key;
+
+    //! Forget all indices, before a full renumbering
+    void clear()
+    {
+      key_.clear();
+      level_.clear();
+    }
+
+    //! The number of indices
+    unsigned int size() const
+    {
+      return level_.size();
+    }
+
+    //! Hand an index to an entity in a full renumbering
+    void set(unsigned int index, const Key& key, int level)
+    {
+      if (index >= level_.size())
+      {
+        key_.resize(index+1);
+        level_.resize(index+1);
+      }
+      key_[index] = key;
+      level_[index] = level;
+    }
+
+    //! The entity with the given index is contained in a leaf element of the given level
+    void visit(unsigned int index, int level)
+    {
+      level_[index] = std::min(level_[index], level);
+    }
+
+    /** \brief Start an incremental renumbering
+
+       The indices of entities not contained in leaf elements of the given
+       level or finer are kept, all others are released.
+     */
+    void begin(int firstLevel)
+    {
+      firstLevel_ = firstLevel;
+      taken_.assign(level_.size(), false);
+      object_.assign(level_.size(), std::make_pair(nullptr, 0));
+      used_ = 0;
+      nextFree_ = 0;
+      for (std::size_t i=0; i<level_.size(); i++)
+        if (level_[i] < firstLevel)
+        {
+          taken_[i] = true;
+          used_++;
+        }
+    }
+
+    //! Return true if the index is kept and held by the entity with the given key
+    bool isKept(unsigned int index, const Key& key) const
+    {
+      return index < level_.size() && level_[index] < firstLevel_ && key_[index] == key;
+    }
+
+    //! Return true if the index has been handed to the entity with the given key in this renumbering
+    bool isOwnedBy(unsigned int index, const Key& key) const
+    {
+      return index < level_.size() && taken_[index] && level_[index] >= firstLevel_ && key_[index] == key;
+    }
+
+    /** \brief Try to hand a released index to an entity
+
+       \param object The UG object of the entity and a local number, to write a new index on compaction
+       \return true if the index was released and not taken yet
+     */
+    bool claim(unsigned int index, const Key& key, int level, std::pair<void*, int> object)
+    {
+      if (index >= level_.size() || taken_[index])
+        return false;
+      take(index, key, level, object);
+      return true;
+    }
+
+    //! Hand the lowest free index to an entity
+    unsigned int assign(const Key& key, int level, std::pair<void*, int> object)
+    {
+      while (nextFree_ < level_.size() && taken_[nextFree_])
+        nextFree_++;
+      if (nextFree_ == level_.size())
+      {
+        key_.emplace_back();
+        level_.push_back(level);
+        taken_.push_back(false);
+        object_.emplace_back();
+      }
+      take(nextFree_, key, level, object);
+      return nextFree_;
+    }
+
+    /** \brief Finish the renumbering by moving the entities with the largest indices into the holes
+
+       \param move Called with the object and the new index of each moved entity
+       \return false if an entity whose index is kept would have to be moved.
+       Nothing is moved then, and the index set needs a full renumbering.
+     */
+    template <class Move>
+    bool compact(Move&& move)
+    {
+      for (std::size_t i=used_; i<level_.size(); i++)
+        if (taken_[i] && level_[i] < firstLevel_)
+          return false;
+
+      std::size_t hole = 0;
+      for (std::size_t i=used_; i<level_.size(); i++)
+        if (taken_[i])
+        {
+          while (taken_[hole])
+            hole++;
+          key_[hole] = key_[i];
+          level_[hole] = level_[i];
+          taken_[hole] = true;
+          move(object_[i], hole);
+        }
+
+      key_.resize(used_);
+      level_.resize(used_);
+      taken_.clear();
+      object_.clear();
+      return true;
+    }
+
+  private:
+    void take(unsigned int index, const Key& key, int level, std::pair<void*, int> object)
+    {
+      key_[index] = key;
+      level_[index] = level;
+      taken_[index] = true;
+      object_[index] = object;
+      used_++;
+    }
+
+    std::vector<Key> key_;
+    std::vector<int> level_;
+
+    // The state of an incremental renumbering
+    int firstLevel_;
+    std::vector<bool> taken_;
+    std::vector<std::pair<void*, int> > object_;
+    std::size_t used_;
+    std::size_t nextFree_;
   };
 
   template<class GridImp>
@@ -431,6 +630,25 @@ namespace Dune {
     /** \brief Update the leaf indices.  This method is called after each grid change. */
     void update(std::vector<unsigned int>* nodePermutation=0);
 
+    /** \brief Update the leaf indices after an adaptation step that changed only the given level and finer ones
+
+       Entities contained in leaf elements of coarser levels keep their
+       indices, and so do unchanged elements and vertices of the finer levels
+       whenever possible.  The indices of removed entities are handed to new
+       ones, and the largest indices are moved into the remaining holes.  If
+       that would move a kept index, all indices are recomputed by update().
+     */
+    void updateIncremental(int firstChangedLevel);
+
+    //! Update the lists of geometry types present from the numbers of entities
+    void updateTypes();
+
+    //! The position of an element type in elementSlots_
+    static int typeSlot(const GeometryType& type)
+    {
+      return type.isSimplex() ? 0 : type.isPyramid() ? 1 : type.isPrism() ? 2 : 3;
+    }
+
     const GridImp& grid_;
 
     /** \brief The lowest level that contains leaf elements
@@ -453,6 +671,13 @@ namespace Dune {
     int numQuadFaces_;
 
     std::vector<GeometryType> myTypes_[dim+1];
+
+    // The owners of the indices of the simplices, pyramids, prisms and cubes
+    UGGridIndexSlots<1> elementSlots_[4];
+    UGGridIndexSlots<1> vertexSlots_;
+    UGGridIndexSlots<2> edgeSlots_;
+    // The owners of the indices of the triangular and quadrilateral faces
+    UGGridIndexSlots<4> faceSlots_[2];
   };
 
 
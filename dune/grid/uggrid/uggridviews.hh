@@ -208,6 +208,16 @@ namespace Dune
                            return grid().communicate( data, iftype, dir, level_ );
                          }
 
+      /** start a split-phase communication on this view, UGGrid communicates immediately */
+      template< class DataHandleImp, class DataType >
+      CompletedCommunication communicateBegin ( CommDataHandleIF< DataHandleImp, DataType > &data,
+                                                InterfaceType iftype,
+                                                CommunicationDirection dir ) const
+      {
+        grid().communicate( data, iftype, dir, level_ );
+        return CompletedCommunication();
+      }
+
     private:
       const Grid *grid_;
       int level_;
@@ -389,6 +399,16 @@ namespace Dune
                            return grid().communicate( data, iftype, dir );
                          }
 
+      /** start a split-phase communication on this view, UGGrid communicates immediately */
+      template< class DataHandleImp, class DataType >
+      CompletedCommunication communicateBegin ( CommDataHandleIF< DataHandleImp, DataType > &data,
+                                                InterfaceType iftype,
+                                                CommunicationDirection dir ) const
+      {
+        grid().communicate( data, iftype, dir );
+        return CompletedCommunication();
+      }
+
     private:
       const Grid *grid_;
     };
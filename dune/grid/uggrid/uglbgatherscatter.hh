@@ -3,123 +3,421 @@
 #ifndef DUNE_UGLBGATHERSCATTER_HH
 #define DUNE_UGLBGATHERSCATTER_HH
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <dune/common/hybridutilities.hh>
+
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+
 namespace Dune {
 
   /** \brief Gather/scatter methods for dynamic loadbalancing with UGGrid
+
+      The data of the vertices travels with the UG nodes: it is written into their
+      message buffers, which DDD sends along when it migrates the nodes.  The UG
+      objects of elements, edges and faces have no such buffer.  Their data is
+      collected into records identified by the global ids before the load balancing,
+      and sent in one exchange to the processes that own the entities afterwards.
+
+      Each entity carries the number of its data items, hence data handles with
+      variable size are supported for all codims.
    */
   class UGLBGatherScatter
   {
+    /** \brief The message buffer handed to the data handle, for the data of a single entity */
+    template <class DataType>
     class LBMessageBuffer
     {
     public:
-      template <class DataType>
-      void read(DataType& x)
+      template <class T>
+      void read(T& x)
+      {
+        x = data_[position_++];
+      }
+
+      template <class T>
+      void write(const T& x)
       {
-        count_--;
-        memcpy(&x, data_ + count_*sizeof(DataType), sizeof(DataType));
-        if (!count_)
-          free(data_);
+        data_.push_back(x);
       }
 
-      template <class DataType>
-      void write(const DataType& x)
+      std::vector<DataType>& data()
       {
-        count_++;
-        char* moreData_ = (char*)realloc(data_, count_*sizeof(DataType));
-        if (moreData_)
-          data_ = moreData_;
-        memcpy(data_ + (count_-1)*sizeof(DataType), &x, sizeof(DataType));
+        return data_;
       }
 
       LBMessageBuffer()
-        : count_(0), data_(nullptr)
+        : position_(0)
       {}
 
     private:
-      int count_;
-      char* data_;
+      std::vector<DataType> data_;
+      std::size_t position_;
     };
 
+    // Append n objects to a byte array
+    template <class T>
+    static void append(std::vector<char>& bytes, const T* x, std::size_t n = 1)
+    {
+      const char* begin = reinterpret_cast<const char*>(x);
+      bytes.insert(bytes.end(), begin, begin + n*sizeof(T));
+    }
+
+    // Read n objects from a byte array, and return the position behind them
+    template <class T>
+    static const char* extract(const char* bytes, T* x, std::size_t n = 1)
+    {
+      memcpy(x, bytes, n*sizeof(T));
+      return bytes + n*sizeof(T);
+    }
+
+    // Append the number of data items of the entity and the items themselves
+    template <class DataHandle, class Entity>
+    static void gatherEntity(DataHandle& dataHandle, const Entity& entity, std::vector<char>& bytes)
+    {
+      LBMessageBuffer<typename DataHandle::DataType> lbMessageBuffer;
+      if (dataHandle.size(entity) > 0)
+        dataHandle.gather(lbMessageBuffer, entity);
+
+      const int numberOfParams = lbMessageBuffer.data().size();
+      append(bytes, &numberOfParams);
+      append(bytes, lbMessageBuffer.data().data(), numberOfParams);
+    }
+
+    // Hand the data written by gatherEntity to the data handle, and return the position behind it
+    template <class DataHandle, class Entity>
+    static const char* scatterEntity(DataHandle& dataHandle, const Entity& entity, const char* bytes)
+    {
+      int numberOfParams;
+      bytes = extract(bytes, &numberOfParams);
+
+      LBMessageBuffer<typename DataHandle::DataType> lbMessageBuffer;
+      lbMessageBuffer.data().resize(numberOfParams);
+      bytes = extract(bytes, lbMessageBuffer.data().data(), numberOfParams);
+
+      if (numberOfParams > 0)
+        dataHandle.scatter(lbMessageBuffer, entity, numberOfParams);
+      return bytes;
+    }
+
+    // Call f(codim) for all codims below the vertices that the data handle contains
+    template <int dim, class DataHandle, class F>
+    static void forEachElementCodim(const DataHandle& dataHandle, F&& f)
+    {
+      Hybrid::forEach(Hybrid::integralRange(std::integral_constant<int,0>(), std::integral_constant<int,dim>()),
+                      [&](auto codim)
+        {
+          if (dataHandle.contains(dim, codim))
+            f(codim);
+        });
+    }
+
+#ifdef ModelP
+    /** \brief Send a byte array to each process, and receive the byte arrays that the processes send to this one
+     *
+     * \param[out] offsets The data from process p is at the positions offsets[p] to offsets[p+1]-1 of the result
+     */
+    template <class Communication>
+    static std::vector<char> exchange(const Communication& comm,
+                                      const std::vector<std::vector<char> >& send,
+                                      std::vector<int>& offsets)
+    {
+      const int size = comm.size();
+      std::vector<int> sendCounts(size), sendOffsets(size+1, 0), receiveCounts(size);
+      for (int p = 0; p < size; p++)
+      {
+        sendCounts[p] = send[p].size();
+        sendOffsets[p+1] = sendOffsets[p] + sendCounts[p];
+      }
+
+      MPI_Alltoall(sendCounts.data(), 1, MPI_INT, receiveCounts.data(), 1, MPI_INT, comm);
+
+      offsets.assign(size+1, 0);
+      for (int p = 0; p < size; p++)
+        offsets[p+1] = offsets[p] + receiveCounts[p];
+
+      std::vector<char> sendBytes(sendOffsets[size]);
+      for (int p = 0; p < size; p++)
+        std::copy(send[p].begin(), send[p].end(), sendBytes.begin() + sendOffsets[p]);
+
+      std::vector<char> received(offsets[size]);
+      MPI_Alltoallv(sendBytes.data(), sendCounts.data(), sendOffsets.data(), MPI_BYTE,
+                    received.data(), receiveCounts.data(), offsets.data(), MPI_BYTE, comm);
+      return received;
+    }
+#endif
+
   public:
 
-    /** \brief Gather data before load balancing
+    /** \brief The data of the elements, edges and faces between gatherElements() and scatterElements()
+     *
+     * The record k, of the entity with codimension and global id keys[k], is stored at the
+     * positions offsets[k] to offsets[k+1]-1 of data, and is sent to the ranks in destinations[k].
      */
-    template <int codim, class GridView, class DataHandle>
-    static void gather(const GridView& gridView, DataHandle& dataHandle)
+    template <class IdType>
+    struct Records
+    {
+      typedef std::pair<int, IdType> Key;
+
+      std::map<Key, std::size_t> index;
+      std::vector<Key> keys;
+      std::vector<std::size_t> offsets = std::vector<std::size_t>(1, 0);
+      std::vector<char> data;
+      std::vector<std::vector<int> > destinations;
+    };
+
+    /** \brief Write the vertex data into the UG node message buffers before load balancing
+     */
+    template <class GridView, class DataHandle>
+    static void gatherVertices(const GridView& gridView, DataHandle& dataHandle)
     {
       const int dim = GridView::dimension;
 
       // do nothing if nothing has to be done
-      if (!dataHandle.contains(dim, codim))
+      if (!dataHandle.contains(dim, dim))
         return;
 
-      // write the data into a global vector on process 0
-      // write the macrogrid index of each entity into the corresponding UG vector
-      for (const auto entity : entities(gridView, Codim<codim>()))
+      for (const auto& vertex : vertices(gridView))
       {
-        int numberOfParams = dataHandle.size(entity);
-        if (!numberOfParams)
-          continue;
+        std::vector<char> bytes;
+        gatherEntity(dataHandle, vertex, bytes);
 
-        // obtain data from DUNE handle and write it into the UG message buffer
-        LBMessageBuffer lbMessageBuffer;
-        dataHandle.gather(lbMessageBuffer, entity);
-
-        char*& buffer = gridView.grid().getRealImplementation(entity).getTarget()->message_buffer;
+        char*& buffer = gridView.grid().getRealImplementation(vertex).getTarget()->message_buffer;
         assert(not buffer);
 
-        typedef typename DataHandle::DataType DataType;
-        buffer = (char*)malloc(sizeof(int) + numberOfParams*sizeof(DataType));
-        *((int*)buffer) = numberOfParams*sizeof(DataType);       // Size of the actual payload
-
-        for (int paramIdx = 0; paramIdx < numberOfParams; paramIdx++)
-        {
-          DataType *dataPointer = (DataType*)(buffer + sizeof(int) + paramIdx*sizeof(DataType));
-          lbMessageBuffer.read(*dataPointer);
-        }
+        const int payload = bytes.size();
+        buffer = (char*)malloc(sizeof(int) + payload);
+        memcpy(buffer, &payload, sizeof(int));       // Size of the actual payload
+        memcpy(buffer + sizeof(int), bytes.data(), payload);
       }
     }
 
-    /** \brief Scatter data after load balancing
+    /** \brief Hand the vertex data in the UG node message buffers to the data handle after load balancing
      */
-    template <int codim, class GridView, class DataHandle>
-    static void scatter(const GridView& gridView, DataHandle& dataHandle)
+    template <class GridView, class DataHandle>
+    static void scatterVertices(const GridView& gridView, DataHandle& dataHandle)
     {
       const int dim = GridView::dimension;
 
       // do nothing if nothing has to be done
-      if (!dataHandle.contains(dim, codim))
+      if (!dataHandle.contains(dim, dim))
         return;
 
-      // obtain the data from the global vector with help of
-      // the macro index and scatter it
-      for (const auto entity : entities(gridView, Codim<codim>()))
+      for (const auto& vertex : vertices(gridView))
+      {
+        char*& buffer = gridView.grid().getRealImplementation(vertex).getTarget()->message_buffer;
+        assert(buffer);
+
+        scatterEntity(dataHandle, vertex, buffer + sizeof(int));
+
+        // free object's local message buffer
+        free (buffer);
+        buffer = nullptr;
+      }
+    }
+
+    /** \brief Collect the data of the elements, edges and faces before load balancing
+     *
+     * Each process collects the data of its interior leaf elements and their
+     * subentities.  If targetProcessors is given, the records are sent to the
+     * targets of the elements containing the entities, as documented for
+     * UGGrid::loadBalance(targetProcessors, fromLevel).  Otherwise the
+     * destinations are found by findDestinations() after load balancing.
+     */
+    template <class GridView, class DataHandle, class Rank>
+    static Records<typename GridView::Grid::GlobalIdSet::IdType>
+    gatherElements(const GridView& gridView, DataHandle& dataHandle, const std::vector<Rank>* targetProcessors)
+    {
+      const int dim = GridView::dimension;
+      typedef Records<typename GridView::Grid::GlobalIdSet::IdType> RecordsType;
+      typedef typename RecordsType::Key Key;
+
+      RecordsType records;
+      const auto& idSet = gridView.grid().globalIdSet();
+      MultipleCodimMultipleGeomTypeMapper<GridView, MCMGElementLayout> elementMapper(gridView);
+
+      for (const auto& element : elements(gridView, Partitions::interior))
       {
-        int numberOfParams = dataHandle.size(entity);
-        if (!numberOfParams)
+        const int target = targetProcessors ? int((*targetProcessors)[elementMapper.index(element)]) : -1;
+
+        forEachElementCodim<dim>(dataHandle, [&](auto codim)
+          {
+            for (unsigned int i = 0; i < element.subEntities(codim); i++)
+            {
+              const auto inserted = records.index.insert(std::make_pair(Key(codim, idSet.subId(element, i, codim)),
+                                                                        records.keys.size()));
+              if (inserted.second)
+              {
+                records.keys.push_back(inserted.first->first);
+                gatherEntity(dataHandle, element.template subEntity<codim>(i), records.data);
+                records.offsets.push_back(records.data.size());
+                records.destinations.emplace_back();
+              }
+
+              auto& destinations = records.destinations[inserted.first->second];
+              if (target >= 0 && std::find(destinations.begin(), destinations.end(), target) == destinations.end())
+                destinations.push_back(target);
+            }
+          });
+      }
+
+      return records;
+    }
+
+#ifdef ModelP
+    /** \brief Find the processes that own the entities of the records after load balancing
+     *
+     * Used if the records were collected without target processors.  The records
+     * and the entities owned now are announced to a directory process chosen by
+     * the id, which asks one holder of each record to send it to all new owners.
+     */
+    template <class GridView, class DataHandle, class IdType>
+    static void findDestinations(const GridView& gridView, const DataHandle& dataHandle, Records<IdType>& records)
+    {
+      const int dim = GridView::dimension;
+      typedef typename Records<IdType>::Key Key;
+      const int size = gridView.comm().size();
+
+      // Spread the ids evenly over the directory processes
+      auto directory = [size](const Key& key) {
+        return int(((std::uint64_t(key.second) * 0x9E3779B97F4A7C15ull) >> 32) % size);
+      };
+
+      std::vector<std::vector<char> > announcements(size);
+      auto announce = [&](int owned, const Key& key) {
+        std::vector<char>& bytes = announcements[directory(key)];
+        append(bytes, &owned);
+        append(bytes, &key.first);
+        append(bytes, &key.second);
+      };
+
+      for (const auto& key : records.keys)
+        announce(0, key);
+
+      std::set<Key> owned;
+      const auto& idSet = gridView.grid().globalIdSet();
+      for (const auto& element : elements(gridView, Partitions::interior))
+        forEachElementCodim<dim>(dataHandle, [&](auto codim)
+          {
+            for (unsigned int i = 0; i < element.subEntities(codim); i++)
+              owned.insert(Key(codim, idSet.subId(element, i, codim)));
+          });
+      for (const auto& key : owned)
+        announce(1, key);
+
+      std::vector<int> offsets;
+      std::vector<char> received = exchange(gridView.comm(), announcements, offsets);
+
+      // For each entity, the lowest rank holding its record and the ranks owning it now
+      std::map<Key, std::pair<int, std::vector<int> > > entries;
+      for (int p = 0; p < size; p++)
+        for (const char* bytes = received.data() + offsets[p]; bytes < received.data() + offsets[p+1]; )
+        {
+          int isOwned;
+          Key key;
+          bytes = extract(bytes, &isOwned);
+          bytes = extract(bytes, &key.first);
+          bytes = extract(bytes, &key.second);
+
+          auto& entry = entries.insert(std::make_pair(key, std::make_pair(size, std::vector<int>()))).first->second;
+          if (isOwned)
+            entry.second.push_back(p);
+          else
+            entry.first = std::min(entry.first, p);
+        }
+
+      std::vector<std::vector<char> > requests(size);
+      for (const auto& entry : entries)
+      {
+        const int holder = entry.second.first;
+        if (holder == size)
           continue;
+        for (int owner : entry.second.second)
+        {
+          append(requests[holder], &entry.first.first);
+          append(requests[holder], &entry.first.second);
+          append(requests[holder], &owner);
+        }
+      }
 
-        // get data from UG message buffer and write to DUNE message buffer
-        char*& buffer = gridView.grid().getRealImplementation(entity).getTarget()->message_buffer;
-        assert(buffer);
+      received = exchange(gridView.comm(), requests, offsets);
+
+      for (const char* bytes = received.data(); bytes < received.data() + received.size(); )
+      {
+        Key key;
+        int owner;
+        bytes = extract(bytes, &key.first);
+        bytes = extract(bytes, &key.second);
+        bytes = extract(bytes, &owner);
+        records.destinations[records.index.at(key)].push_back(owner);
+      }
+    }
 
-        LBMessageBuffer lbMessageBuffer;
+    /** \brief Send the records to their destinations, and hand the data to the data handle after load balancing
+     */
+    template <class GridView, class DataHandle, class IdType>
+    static void scatterElements(const GridView& gridView, DataHandle& dataHandle, const Records<IdType>& records)
+    {
+      const int dim = GridView::dimension;
+      typedef typename Records<IdType>::Key Key;
+      typedef typename DataHandle::DataType DataType;
 
-        for(int paramIdx = 0; paramIdx < numberOfParams; paramIdx++)
+      std::vector<std::vector<char> > send(gridView.comm().size());
+      for (std::size_t k = 0; k < records.keys.size(); k++)
+        for (int rank : records.destinations[k])
         {
-          typedef typename DataHandle::DataType DataType;
-          DataType *dataPointer = (DataType*)(buffer + sizeof(int) + paramIdx*sizeof(DataType));
-          lbMessageBuffer.write(*dataPointer);
+          append(send[rank], &records.keys[k].first);
+          append(send[rank], &records.keys[k].second);
+          send[rank].insert(send[rank].end(),
+                            records.data.begin() + records.offsets[k],
+                            records.data.begin() + records.offsets[k+1]);
         }
 
-        // call the data handle with the message buffer
-        dataHandle.scatter(lbMessageBuffer, entity, numberOfParams);
+      std::vector<int> offsets;
+      const std::vector<char> received = exchange(gridView.comm(), send, offsets);
 
-        // free object's local message buffer
-        free (buffer);
-        buffer = nullptr;
+      // An entity may arrive from several processes, the first record is used
+      std::map<Key, const char*> position;
+      for (const char* bytes = received.data(); bytes < received.data() + received.size(); )
+      {
+        Key key;
+        bytes = extract(bytes, &key.first);
+        bytes = extract(bytes, &key.second);
+        position.insert(std::make_pair(key, bytes));
+
+        int numberOfParams;
+        bytes = extract(bytes, &numberOfParams) + numberOfParams*sizeof(DataType);
       }
+
+      // Scatter each entity once, mark it by clearing its position
+      const auto& idSet = gridView.grid().globalIdSet();
+      for (const auto& element : elements(gridView, Partitions::interior))
+        forEachElementCodim<dim>(dataHandle, [&](auto codim)
+          {
+            for (unsigned int i = 0; i < element.subEntities(codim); i++)
+            {
+              auto it = position.find(Key(codim, idSet.subId(element, i, codim)));
+              if (it == position.end())
+                DUNE_THROW(GridError, "No data for the codim " << int(codim) << " entity "
+                           << idSet.subId(element, i, codim) << " arrived during load balancing!");
+              if (!it->second)
+                continue;
+
+              scatterEntity(dataHandle, element.template subEntity<codim>(i), it->second);
+              it->second = nullptr;
+            }
+          });
     }
+#endif
   };
 
 } // namespace Dune
@@ -4,13 +4,20 @@
 #define UG_MESSAGE_BUFFER_HH
 
 #include <algorithm>
+#include <array>
+#include <tuple>
 
+#include <dune/common/hybridutilities.hh>
 #include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/std/utility.hh>
 
 #include <dune/grid/common/gridenums.hh>
 
 namespace Dune {
 
+  template <int GridDim, int codim, class... DataHandles>
+  class UGFusedMessageBuffer;
+
   /** converts the UG speak message buffers to DUNE speak and vice-versa */
   template <class DataHandle, int GridDim, int codim>
   class UGMessageBufferBase {
@@ -37,6 +44,7 @@ namespace Dune {
 
   protected:
     friend class Dune::UGGrid<dim>;
+    template <int, int, class...> friend class UGFusedMessageBuffer;
 
     template <class ValueType>
     void writeRaw_(const ValueType &v)
@@ -124,6 +132,7 @@ namespace Dune {
 
   protected:
     friend class Dune::UGGrid<dim>;
+    template <int, int, class...> friend class UGFusedMessageBuffer;
 
     UGMessageBuffer(void *ugData)
       : Base(ugData)
@@ -174,6 +183,7 @@ namespace Dune {
     typedef UGMessageBufferBase<DataHandle, GridDim, codim> Base;
   protected:
     friend class Dune::UGGrid<dim>;
+    template <int, int, class...> friend class UGFusedMessageBuffer;
 
     UGEdgeAndFaceMessageBuffer(void *ugData)
       : Base(ugData)
@@ -240,6 +250,93 @@ namespace Dune {
     : public UGEdgeAndFaceMessageBuffer<DataHandle, 3, 1>
   {};
 
+  /** \brief Packs the data of several data handles for one codim into a single DDD interface sweep
+   *
+   * Every handle gets its own slot in the message buffer DDD provides per
+   * entity. Gather and scatter call the functions of UGMessageBuffer for the
+   * slots in turn, so the layout of each slot is that of a single handle.
+   */
+  template <int GridDim, int codim, class... DataHandles>
+  class UGFusedMessageBuffer
+  {
+    enum { dim = GridDim };
+    typedef Std::make_index_sequence<sizeof...(DataHandles)> Indices;
+
+  protected:
+    friend class Dune::UGGrid<dim>;
+
+    // computes the slots of the handles, returns the number of bytes per entity
+    template <class GridView>
+    static unsigned setup_(const GridView &gv, const std::tuple<DataHandles&...> &handles, int level)
+    {
+      level_ = level;
+      unsigned bufSize = 0;
+      Hybrid::forEach(Indices{}, [&](auto i) {
+        typedef typename std::tuple_element<i, std::tuple<DataHandles...> >::type DataHandle;
+        typedef typename DataHandle::DataType DataType;
+
+        std::get<i>(handles_) = &std::get<i>(handles);
+        sizes_[i] = 0;
+        if (std::get<i>(handles).contains(dim, codim))
+        {
+          select_<i>();
+          sizes_[i] = UGMessageBuffer<DataHandle,dim,codim>::ugBufferSize_(gv);
+        }
+
+        // keep the data of each slot aligned
+        const unsigned alignment = std::max(alignof(DataType), alignof(unsigned));
+        offsets_[i] = (bufSize + alignment - 1) / alignment * alignment;
+        if (sizes_[i] > 0)
+          bufSize = offsets_[i] + sizes_[i];
+      });
+      return bufSize;
+    }
+
+    // called by DDD_IFOneway to serialize the data of all handles
+    static int ugGather_(typename UG_NS<dim>::DDD_OBJ obj, void* data)
+    {
+      Hybrid::forEach(Indices{}, [&](auto i) {
+        typedef typename std::tuple_element<i, std::tuple<DataHandles...> >::type DataHandle;
+        if (sizes_[i] > 0)
+        {
+          select_<i>();
+          UGMessageBuffer<DataHandle,dim,codim>::ugGather_(obj, static_cast<char*>(data) + offsets_[i]);
+        }
+      });
+      return 0;
+    }
+
+    // called by DDD_IFOneway to deserialize the data of all handles
+    static int ugScatter_(typename UG_NS<dim>::DDD_OBJ obj, void* data)
+    {
+      Hybrid::forEach(Indices{}, [&](auto i) {
+        typedef typename std::tuple_element<i, std::tuple<DataHandles...> >::type DataHandle;
+        if (sizes_[i] > 0)
+        {
+          select_<i>();
+          UGMessageBuffer<DataHandle,dim,codim>::ugScatter_(obj, static_cast<char*>(data) + offsets_[i]);
+        }
+      });
+      return 0;
+    }
+
+    // makes the i-th handle the current one of its message buffer type,
+    // several handles may have the same type
+    template <std::size_t i>
+    static void select_()
+    {
+      typedef typename std::tuple_element<i, std::tuple<DataHandles...> >::type DataHandle;
+      typedef UGMessageBuffer<DataHandle,dim,codim> UGMsgBuf;
+      UGMsgBuf::duneDataHandle_ = std::get<i>(handles_);
+      UGMsgBuf::level = level_;
+    }
+
+    static std::tuple<DataHandles*...> handles_;
+    static std::array<unsigned, sizeof...(DataHandles)> offsets_;
+    static std::array<unsigned, sizeof...(DataHandles)> sizes_;
+    static int level_;
+  };
+
 }   // end namespace Dune
 
 #endif  // UG_MESSAGE_BUFFER_HH
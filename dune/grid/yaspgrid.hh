@@ -6,7 +6,14 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
 #include <stack>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
 
 // either include stdint.h or provide fallback for uint8_t
 #if HAVE_STDINT_H
@@ -20,6 +27,8 @@ typedef unsigned char uint8_t;
 #include <dune/grid/common/capabilities.hh> // the capabilities
 #include <dune/common/power.hh>
 #include <dune/common/bigunsignedint.hh>
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/std/utility.hh>
 #include <dune/common/typetraits.hh>
 #include <dune/common/reservedvector.hh>
 #include <dune/common/parallel/collectivecommunication.hh>
@@ -49,6 +58,29 @@ namespace Dune {
   const int yaspgrid_dim_bits = 24; // bits for encoding each dimension
   const int yaspgrid_level_bits = 5; // bits for encoding level number
 
+  /* integer type for global sizes and indices, which may exceed the range of
+   * int on large grids; local sizes and indices are int.
+   * Define DUNE_YASPGRID_GLOBAL_INDEX_TYPE to change it.
+   */
+#ifdef DUNE_YASPGRID_GLOBAL_INDEX_TYPE
+  typedef DUNE_YASPGRID_GLOBAL_INDEX_TYPE yaspgrid_global_index_type;
+#else
+  typedef std::int64_t yaspgrid_global_index_type;
+#endif
+
+  /** \brief Partition type of the halo cells of a YaspGrid
+   *
+   *  - overlap: the halo cells are OverlapEntity, their vertices, edges and
+   *    faces are overlap or front entities. This is the default.
+   *  - ghost: the halo cells are GhostEntity and all their subentities that
+   *    are not interior or border entities are ghosts, too. There are no
+   *    overlap and front entities, so the overlap interfaces are empty and
+   *    InteriorBorder_All_Interface carries the data of the ghost cells.
+   *
+   *  The width of the halo is the overlap given at construction in both cases.
+   */
+  enum class YaspHalo { overlap, ghost };
+
 
   //************************************************************************
   // forward declaration of templates
@@ -64,11 +96,14 @@ namespace Dune {
   template<class GridImp, bool isLeafIndexSet>                     class YaspIndexSet;
   template<class GridImp>            class YaspGlobalIdSet;
   template<class GridImp>            class YaspPersistentContainerIndex;
+  template<class GridImp, class DataHandle> class YaspCommunication;
+  template<int dim, int codim>       struct YaspCommunicateMeta;
 
 } // namespace Dune
 
 #include <dune/grid/yaspgrid/coordinates.hh>
 #include <dune/grid/yaspgrid/torus.hh>
+#include <dune/grid/yaspgrid/spacefillingcurve.hh>
 #include <dune/grid/yaspgrid/ygrid.hh>
 #include <dune/grid/yaspgrid/yaspgridgeometry.hh>
 #include <dune/grid/yaspgrid/yaspgridentity.hh>
@@ -80,9 +115,39 @@ namespace Dune {
 #include <dune/grid/yaspgrid/yaspgridindexsets.hh>
 #include <dune/grid/yaspgrid/yaspgrididset.hh>
 #include <dune/grid/yaspgrid/yaspgridpersistentcontainer.hh>
+#include <dune/grid/yaspgrid/yaspgridcommunication.hh>
+#include <dune/grid/yaspgrid/yaspgridstructuredaccess.hh>
+#include <dune/grid/yaspgrid/yaspgridpatchhierarchy.hh>
+#include <dune/grid/yaspgrid/yaspgridleveltransfer.hh>
 
 namespace Dune {
 
+  /** \brief Options of the YaspGrid constructors besides the grid itself
+   *
+   *  Only the members that differ from the defaults need to be set:
+   *  \code
+   *  Dune::YaspGridOptions<2> options;
+   *  options.threads = 4;
+   *  Dune::YaspGrid<2> grid(L, s, periodic, overlap, comm, options);
+   *  \endcode
+   */
+  template<int dim>
+  struct YaspGridOptions
+  {
+    //! load balancer, nullptr for YaspGrid::defaultLoadbalancer(); it is used again by YaspGrid::loadBalance()
+    const YLoadBalance<dim>* lb = nullptr;
+    //! implementation of the nearest neighbor exchange, see TorusBackend
+    TorusBackend backend = TorusBackend::pointToPoint;
+    //! placement of the ranks on the process grid, see TorusMapping
+    TorusMapping mapping = TorusMapping::lexicographic;
+    //! numbering of the cells and vertices in the index sets, see YaspOrdering
+    YaspOrdering ordering = YaspOrdering::lexicographic;
+    //! partition type of the halo cells, see YaspHalo
+    YaspHalo halo = YaspHalo::overlap;
+    //! number of threads used to build the levels with a space filling curve ordering, see YaspGrid::setThreads()
+    int threads = 1;
+  };
+
   template<int dim, class Coordinates>
   struct YaspGridFamily
   {
@@ -127,6 +192,52 @@ namespace Dune {
       }
       YaspCommunicateMeta<dim,codim-1>::comm(g,data,iftype,dir,level);
     }
+
+    template<class G, class DataHandle, class Plans>
+    static void begin (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Plans& plans)
+    {
+      g.template communicateCodimBegin<DataHandle,codim>(data,iftype,dir,level,plans[codim]);
+      YaspCommunicateMeta<dim,codim-1>::begin(g,data,iftype,dir,level,plans);
+    }
+
+    template<class G, class DataHandle, class Plans>
+    static bool finish (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Plans& plans, bool block)
+    {
+      bool done = g.template communicateCodimFinish<DataHandle,codim>(data,iftype,dir,level,plans[codim],block);
+      return YaspCommunicateMeta<dim,codim-1>::finish(g,data,iftype,dir,level,plans,block) && done;
+    }
+
+    template<class G, class DataHandle, class Migration>
+    static void migrateGather (const G& g, DataHandle& data, Migration& m)
+    {
+      if (data.contains(dim,codim))
+        g.template migrateGatherCodim<DataHandle,codim>(data,m);
+      YaspCommunicateMeta<dim,codim-1>::migrateGather(g,data,m);
+    }
+
+    template<class G, class DataHandle, class Migration>
+    static void migrateScatter (const G& g, DataHandle& data, Migration& m)
+    {
+      if (data.contains(dim,codim))
+        g.template migrateScatterCodim<DataHandle,codim>(data,m);
+      YaspCommunicateMeta<dim,codim-1>::migrateScatter(g,data,m);
+    }
+
+    template<class G, class DataHandle, class Messages>
+    static void fusedGather (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Messages& m)
+    {
+      if (data.contains(dim,codim))
+        g.template fusedGatherCodim<DataHandle,codim>(data,iftype,dir,level,m);
+      YaspCommunicateMeta<dim,codim-1>::fusedGather(g,data,iftype,dir,level,m);
+    }
+
+    template<class G, class DataHandle, class Messages>
+    static void fusedScatter (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Messages& m)
+    {
+      if (data.contains(dim,codim))
+        g.template fusedScatterCodim<DataHandle,codim>(data,iftype,dir,level,m);
+      YaspCommunicateMeta<dim,codim-1>::fusedScatter(g,data,iftype,dir,level,m);
+    }
   };
 
   template<int dim>
@@ -137,6 +248,46 @@ namespace Dune {
       if (data.contains(dim,0))
         g.template communicateCodim<DataHandle,0>(data,iftype,dir,level);
     }
+
+    template<class G, class DataHandle, class Plans>
+    static void begin (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Plans& plans)
+    {
+      g.template communicateCodimBegin<DataHandle,0>(data,iftype,dir,level,plans[0]);
+    }
+
+    template<class G, class DataHandle, class Plans>
+    static bool finish (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Plans& plans, bool block)
+    {
+      return g.template communicateCodimFinish<DataHandle,0>(data,iftype,dir,level,plans[0],block);
+    }
+
+    template<class G, class DataHandle, class Migration>
+    static void migrateGather (const G& g, DataHandle& data, Migration& m)
+    {
+      if (data.contains(dim,0))
+        g.template migrateGatherCodim<DataHandle,0>(data,m);
+    }
+
+    template<class G, class DataHandle, class Migration>
+    static void migrateScatter (const G& g, DataHandle& data, Migration& m)
+    {
+      if (data.contains(dim,0))
+        g.template migrateScatterCodim<DataHandle,0>(data,m);
+    }
+
+    template<class G, class DataHandle, class Messages>
+    static void fusedGather (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Messages& m)
+    {
+      if (data.contains(dim,0))
+        g.template fusedGatherCodim<DataHandle,0>(data,iftype,dir,level,m);
+    }
+
+    template<class G, class DataHandle, class Messages>
+    static void fusedScatter (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, Messages& m)
+    {
+      if (data.contains(dim,0))
+        g.template fusedScatterCodim<DataHandle,0>(data,iftype,dir,level,m);
+    }
   };
 #endif
 
@@ -168,6 +319,9 @@ namespace Dune {
     template<typename>
     friend class YaspHierarchicIterator;
 
+    template<int, int>
+    friend struct YaspCommunicateMeta;
+
   protected:
 
     using GridDefaultImplementation<dim,dim,typename Coordinates::ctype,YaspGridFamily<dim, Coordinates> >::getRealImplementation;
@@ -206,30 +360,67 @@ namespace Dune {
       std::array<YGrid, dim+1> interior;
       std::array<YGridComponent<Coordinates>, StaticPower<2,dim>::power> interior_data;
 
-      std::array<YGridList<Coordinates>,dim+1> send_overlapfront_overlapfront;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_overlapfront_overlapfront_data;
-      std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_overlapfront;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_overlapfront_data;
+      // the send and receive lists of the interfaces are built on first use, see interfaceLists()
+      mutable std::array<std::bitset<4>,dim+1> builtInterfaces;
+      mutable std::array<YGridList<Coordinates>,dim+1> send_overlapfront_overlapfront;
+      mutable std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_overlapfront_overlapfront_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_overlapfront;
+      mutable std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_overlapfront_data;
+
+      mutable std::array<YGridList<Coordinates>,dim+1> send_overlap_overlapfront;
+      mutable std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_overlap_overlapfront_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_overlap;
+      mutable std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_overlap_data;
+
+      mutable std::array<YGridList<Coordinates>,dim+1> send_interiorborder_interiorborder;
+      mutable std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_interiorborder_interiorborder_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> recv_interiorborder_interiorborder;
+      mutable std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_interiorborder_interiorborder_data;
+
+      mutable std::array<YGridList<Coordinates>,dim+1> send_interiorborder_overlapfront;
+      mutable std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_interiorborder_overlapfront_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_interiorborder;
+      mutable std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_interiorborder_data;
+
+      // persistent communication plans for fixed size data, keyed by
+      // (codim, interface, direction, bytes per entity)
+      mutable std::map<std::array<int,4>, std::shared_ptr<typename Torus<CollectiveCommunicationType,dim>::CommPlan> > commplans;
+#if HAVE_MPI
+      // datatype based exchanges for communicateVector, keyed by
+      // (codim, interface, direction, bytes per entity)
+      mutable std::map<std::array<int,4>, std::shared_ptr<typename Torus<CollectiveCommunicationType,dim>::DatatypeExchange> > vectorexchanges;
+#endif
 
-      std::array<YGridList<Coordinates>,dim+1> send_overlap_overlapfront;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_overlap_overlapfront_data;
-      std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_overlap;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_overlap_data;
+      // space filling curve numbering of cells (0) and vertices (1), empty if lexicographic:
+      // curve[c][p] is the superindex of the p-th entity on the curve, position[c] its inverse
+      std::array<std::vector<int>, 2> curve;
+      std::array<std::vector<int>, 2> position;
 
-      std::array<YGridList<Coordinates>,dim+1> send_interiorborder_interiorborder;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_interiorborder_interiorborder_data;
-      std::array<YGridList<Coordinates>,dim+1> recv_interiorborder_interiorborder;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_interiorborder_interiorborder_data;
+      /** \brief Index of the entity with the given superindex in the index sets */
+      int index (int codim, int superindex) const
+      {
+        if (codim == 0 && !position[0].empty())
+          return position[0][superindex];
+        if (codim == dim && !position[1].empty())
+          return position[1][superindex];
+        return superindex;
+      }
 
-      std::array<YGridList<Coordinates>,dim+1> send_interiorborder_overlapfront;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_interiorborder_overlapfront_data;
-      std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_interiorborder;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_interiorborder_data;
+      /** \brief The entities of codim ordered along a space filling curve, or 0 if lexicographic */
+      const std::vector<int>* curveOrder (int codim) const
+      {
+        if (codim == 0 && !curve[0].empty())
+          return &curve[0];
+        if (codim == dim && !curve[1].empty())
+          return &curve[1];
+        return 0;
+      }
 
       // general
       YaspGrid<dim,Coordinates>* mg;  // each grid level knows its multigrid
       int overlapSize;           // in mesh cells on this level
       bool keepOverlap;
+      bool ghosts;               // the halo consists of ghost entities, see YaspHalo
 
       /** \brief The level number within the YaspGrid level hierarchy */
       int level_;
@@ -249,6 +440,40 @@ namespace Dune {
       return _torus;
     }
 
+    //! return the numbering of the cells and vertices in the index sets, see YaspOrdering
+    YaspOrdering ordering () const
+    {
+      return _ordering;
+    }
+
+    //! return the partition type of the halo cells, see YaspHalo
+    YaspHalo halo () const
+    {
+      return _halo;
+    }
+
+    //! return the number of threads used to build the levels
+    int threads () const
+    {
+      return _threads;
+    }
+
+    /** \brief set the number of threads used to build new levels in globalRefine()
+
+       The work of building a level that grows with the number of cells, the
+       numbering along a space filling curve (see YaspOrdering), is split
+       among the threads. The grid is not accessed concurrently otherwise.
+
+       \note The threads are only used with YaspOrdering::morton and
+       YaspOrdering::hilbert. With the default lexicographic ordering the
+       levels are set up in a time independent of the number of cells, and
+       this setting has no effect.
+     */
+    void setThreads (int threads)
+    {
+      _threads = std::max(1, threads);
+    }
+
     //! return number of cells on finest level in given direction on all processors
     int globalSize(int i) const
     {
@@ -276,6 +501,51 @@ namespace Dune {
       return s;
     }
 
+    //! type for global sizes and indices, see yaspgrid_global_index_type
+    typedef yaspgrid_global_index_type GlobalIndexType;
+
+    //! return the number of entities of a codim on level l on all processors, periodic copies are counted once
+    GlobalIndexType globalCount(int l, int codim) const
+    {
+      GlobalIndexType count = 0;
+      for (unsigned long s=0; s<(1ul<<dim); s++)
+        if (std::bitset<dim>(s).count() == std::size_t(dim-codim))
+          count += globalComponentCount(l,std::bitset<dim>(s));
+      return count;
+    }
+
+    /** \brief return a consecutive index of an entity among all entities of its codim on its level
+
+       The index runs from 0 to globalCount()-1 and does not depend on the
+       partitioning, it is the same on all processes that have the entity.
+       Periodic copies of an entity get the same index.
+     */
+    template<class Entity>
+    GlobalIndexType globalIndex(const Entity& e) const
+    {
+      const typename YGrid::Iterator& it = this->getRealImplementation(e).transformingsubiterator();
+      const int l = e.level();
+      const std::bitset<dim> shift = it.shift();
+
+      // the components with a smaller shift come first
+      GlobalIndexType index = 0;
+      for (unsigned long s=0; s<shift.to_ulong(); s++)
+        if (std::bitset<dim>(s).count() == shift.count())
+          index += globalComponentCount(l,std::bitset<dim>(s));
+
+      GlobalIndexType stride = 1;
+      for (int i=0; i<dim; i++)
+      {
+        const int n = levelSize(l,i);
+        int c = it.coord(i);
+        if (_periodic[i])
+          c = ((c%n)+n)%n;
+        index += stride*c;
+        stride *= (shift[i] || _periodic[i]) ? n : n+1;
+      }
+      return index;
+    }
+
     //! return whether the grid is periodic in direction i
     bool isPeriodic(int i) const
     {
@@ -318,6 +588,46 @@ namespace Dune {
     }
 
   protected:
+    // a copy of the load balancer given at construction, which may be a temporary,
+    // or nullptr if it cannot be copied. A derived class that does not override
+    // clone() would be copied as its base class, it is not kept either.
+    static std::shared_ptr<const YLoadBalance<dim> > keepLoadbalancer (const YLoadBalance<dim>* lb)
+    {
+      std::shared_ptr<const YLoadBalance<dim> > copy(lb->clone());
+      if (copy && typeid(*copy) != typeid(*lb))
+        copy.reset();
+      return copy;
+    }
+
+    // the options given positionally to the constructors
+    static YaspGridOptions<dim> makeOptions (const YLoadBalance<dim>* lb, TorusBackend backend, TorusMapping mapping,
+                                             YaspOrdering ordering, YaspHalo halo, int threads)
+    {
+      YaspGridOptions<dim> options;
+      options.lb = lb;
+      options.backend = backend;
+      options.mapping = mapping;
+      options.ordering = ordering;
+      options.halo = halo;
+      options.threads = threads;
+      return options;
+    }
+
+    // the load balancer of the options
+    static const YLoadBalance<dim>* loadbalancer (const YaspGridOptions<dim>& options)
+    {
+      return options.lb ? options.lb : defaultLoadbalancer();
+    }
+
+    // the kept load balancer, loadBalance() must not silently use a different one
+    const YLoadBalance<dim>& keptLoadbalancer () const
+    {
+      if (!_lb)
+        DUNE_THROW(GridError, "The load balancer given at construction does not implement clone(), "
+                   "call repartition() with it instead of loadBalance()");
+      return *_lb;
+    }
+
     /** \brief Make a new YGridLevel structure
      *
      * \param coords      the coordinate container
@@ -333,6 +643,7 @@ namespace Dune {
       g.level_ = maxLevel();
       g.coords = coords;
       g.keepOverlap = keep_ovlp;
+      g.ghosts = (_halo == YaspHalo::ghost);
 
       // set the inserting positions in the corresponding arrays of YGridLevelStructure
       typename std::array<YGridComponent<Coordinates>, StaticPower<2,dim>::power>::iterator overlapfront_it = g.overlapfront_data.begin();
@@ -340,26 +651,6 @@ namespace Dune {
       typename std::array<YGridComponent<Coordinates>, StaticPower<2,dim>::power>::iterator interiorborder_it = g.interiorborder_data.begin();
       typename std::array<YGridComponent<Coordinates>, StaticPower<2,dim>::power>::iterator interior_it = g.interior_data.begin();
 
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        send_overlapfront_overlapfront_it = g.send_overlapfront_overlapfront_data.begin();
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        recv_overlapfront_overlapfront_it = g.recv_overlapfront_overlapfront_data.begin();
-
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        send_overlap_overlapfront_it = g.send_overlap_overlapfront_data.begin();
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        recv_overlapfront_overlap_it = g.recv_overlapfront_overlap_data.begin();
-
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        send_interiorborder_interiorborder_it = g.send_interiorborder_interiorborder_data.begin();
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        recv_interiorborder_interiorborder_it = g.recv_interiorborder_interiorborder_data.begin();
-
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        send_interiorborder_overlapfront_it = g.send_interiorborder_overlapfront_data.begin();
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        recv_overlapfront_interiorborder_it = g.recv_overlapfront_interiorborder_data.begin();
-
       // have a null array for constructor calls around
       std::array<int,dim> n;
       std::fill(n.begin(), n.end(), 0);
@@ -409,14 +700,6 @@ namespace Dune {
         g.overlap[codim].setBegin(overlap_it);
         g.interiorborder[codim].setBegin(interiorborder_it);
         g.interior[codim].setBegin(interior_it);
-        g.send_overlapfront_overlapfront[codim].setBegin(send_overlapfront_overlapfront_it);
-        g.recv_overlapfront_overlapfront[codim].setBegin(recv_overlapfront_overlapfront_it);
-        g.send_overlap_overlapfront[codim].setBegin(send_overlap_overlapfront_it);
-        g.recv_overlapfront_overlap[codim].setBegin(recv_overlapfront_overlap_it);
-        g.send_interiorborder_interiorborder[codim].setBegin(send_interiorborder_interiorborder_it);
-        g.recv_interiorborder_interiorborder[codim].setBegin(recv_interiorborder_interiorborder_it);
-        g.send_interiorborder_overlapfront[codim].setBegin(send_interiorborder_overlapfront_it);
-        g.recv_overlapfront_interiorborder[codim].setBegin(recv_overlapfront_interiorborder_it);
 
         // find all combinations of unit vectors that span entities of the given codimension
         for (unsigned int index = 0; index < (1<<dim); index++)
@@ -491,39 +774,62 @@ namespace Dune {
           }
           *interior_it = YGridComponent<Coordinates>(origin, size, *overlapfront_it);
 
-          intersections(*overlapfront_it,*overlapfront_it,*send_overlapfront_overlapfront_it, *recv_overlapfront_overlapfront_it);
-          intersections(*overlap_it,*overlapfront_it,*send_overlap_overlapfront_it, *recv_overlapfront_overlap_it);
-          intersections(*interiorborder_it,*interiorborder_it,*send_interiorborder_interiorborder_it,*recv_interiorborder_interiorborder_it);
-          intersections(*interiorborder_it,*overlapfront_it,*send_interiorborder_overlapfront_it,*recv_overlapfront_interiorborder_it);
-
           // advance all iterators pointing to the next insertion point
           ++overlapfront_it;
           ++overlap_it;
           ++interiorborder_it;
           ++interior_it;
-          ++send_overlapfront_overlapfront_it;
-          ++recv_overlapfront_overlapfront_it;
-          ++send_overlap_overlapfront_it;
-          ++recv_overlapfront_overlap_it;
-          ++send_interiorborder_interiorborder_it;
-          ++recv_interiorborder_interiorborder_it;
-          ++send_interiorborder_overlapfront_it;
-          ++recv_overlapfront_interiorborder_it;
         }
 
+        // local indices are int, make sure that they do not overflow
+        GlobalIndexType count = 0;
+        for (typename YGrid::DAI c = g.overlapfront[codim].dataBegin(); c != overlapfront_it; ++c)
+        {
+          GlobalIndexType size = 1;
+          for (int i=0; i<dim; i++)
+            size *= c->size(i);
+          count += size;
+        }
+        if (count > std::numeric_limits<int>::max())
+          DUNE_THROW(GridError, "YaspGrid: " << count << " entities of codim " << codim
+                     << " on one process exceed the range of the local indices, use more processes");
+
         // set end iterators in the corresonding ygrids
         g.overlapfront[codim].finalize(overlapfront_it);
         g.overlap[codim].finalize(overlap_it);
         g.interiorborder[codim].finalize(interiorborder_it);
         g.interior[codim].finalize(interior_it);
-        g.send_overlapfront_overlapfront[codim].finalize(send_overlapfront_overlapfront_it,g.overlapfront[codim]);
-        g.recv_overlapfront_overlapfront[codim].finalize(recv_overlapfront_overlapfront_it,g.overlapfront[codim]);
-        g.send_overlap_overlapfront[codim].finalize(send_overlap_overlapfront_it,g.overlapfront[codim]);
-        g.recv_overlapfront_overlap[codim].finalize(recv_overlapfront_overlap_it,g.overlapfront[codim]);
-        g.send_interiorborder_interiorborder[codim].finalize(send_interiorborder_interiorborder_it,g.overlapfront[codim]);
-        g.recv_interiorborder_interiorborder[codim].finalize(recv_interiorborder_interiorborder_it,g.overlapfront[codim]);
-        g.send_interiorborder_overlapfront[codim].finalize(send_interiorborder_overlapfront_it,g.overlapfront[codim]);
-        g.recv_overlapfront_interiorborder[codim].finalize(recv_overlapfront_interiorborder_it,g.overlapfront[codim]);
+
+        // the send and receive lists start out empty
+        g.builtInterfaces[codim].reset();
+        int first = g.overlapfront[codim].dataBegin() - g.overlapfront_data.data();
+        emptyInterfaceList(g, codim, first, g.send_overlapfront_overlapfront, g.send_overlapfront_overlapfront_data);
+        emptyInterfaceList(g, codim, first, g.recv_overlapfront_overlapfront, g.recv_overlapfront_overlapfront_data);
+        emptyInterfaceList(g, codim, first, g.send_overlap_overlapfront, g.send_overlap_overlapfront_data);
+        emptyInterfaceList(g, codim, first, g.recv_overlapfront_overlap, g.recv_overlapfront_overlap_data);
+        emptyInterfaceList(g, codim, first, g.send_interiorborder_interiorborder, g.send_interiorborder_interiorborder_data);
+        emptyInterfaceList(g, codim, first, g.recv_interiorborder_interiorborder, g.recv_interiorborder_interiorborder_data);
+        emptyInterfaceList(g, codim, first, g.send_interiorborder_overlapfront, g.send_interiorborder_overlapfront_data);
+        emptyInterfaceList(g, codim, first, g.recv_overlapfront_interiorborder, g.recv_overlapfront_interiorborder_data);
+      }
+
+      // number cells and vertices along the space filling curve
+      for (int c=0; c<2; c++)
+      {
+        g.curve[c].clear();
+        g.position[c].clear();
+        if (_ordering == YaspOrdering::lexicographic)
+          continue;
+
+        // cells and vertices consist of a single component covering the whole box
+        const YGridComponent<Coordinates>& box = *g.overlapfront[c*dim].dataBegin();
+        Dune::Yasp::spaceFillingCurve<dim>(box.size(), _ordering, g.curve[c], _threads);
+        g.position[c].resize(g.curve[c].size());
+        Dune::Yasp::forEachChunk(_threads, g.curve[c].size(), [&g, c] (std::size_t begin, std::size_t end)
+        {
+          for (std::size_t p=begin; p<end; p++)
+            g.position[c][g.curve[c][p]] = p;
+        });
       }
     }
 
@@ -559,7 +865,7 @@ namespace Dune {
      * \returns two lists: Intersections to be sent and Intersections to be received
      */
     void intersections(const YGridComponent<Coordinates>& sendgrid, const YGridComponent<Coordinates>& recvgrid,
-                        std::deque<Intersection>& sendlist, std::deque<Intersection>& recvlist)
+                        std::deque<Intersection>& sendlist, std::deque<Intersection>& recvlist) const
     {
       iTupel size = globalSize();
 
@@ -670,6 +976,54 @@ namespace Dune {
       }
     }
 
+    //! let an interface list of a codim point to the right part of its data array without any intersections
+    void emptyInterfaceList (const YGridLevel& g, int codim, int first,
+                             std::array<YGridList<Coordinates>,dim+1>& lists,
+                             std::array<std::deque<Intersection>, StaticPower<2,dim>::power>& data) const
+    {
+      lists[codim].setBegin(data.begin() + first);
+      lists[codim].finalize(data.begin() + first, g.overlapfront[codim]);
+    }
+
+    /** \brief Construct the send and receive lists of an interface, unless this has been done before
+     *
+     * The lists are only needed for communication, so they are built when an
+     * interface is used the first time on a level for a codim. This exchanges
+     * data with the neighbors, so it has to happen on all processes, which is
+     * the case as communication is collective.
+     *
+     * \param interface bit of the interface in YGridLevel::builtInterfaces
+     */
+    void makeInterfaceLists (const YGridLevel& g, int codim, int interface,
+                             const YGrid& sendgrid, const YGrid& recvgrid,
+                             std::array<YGridList<Coordinates>,dim+1>& sendlists,
+                             std::array<std::deque<Intersection>, StaticPower<2,dim>::power>& senddata,
+                             std::array<YGridList<Coordinates>,dim+1>& recvlists,
+                             std::array<std::deque<Intersection>, StaticPower<2,dim>::power>& recvdata) const
+    {
+      if (g.builtInterfaces[codim][interface])
+        return;
+
+      // one deque per component of the codim, i.e. per shift
+      int first = g.overlapfront[codim].dataBegin() - g.overlapfront_data.data();
+      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator sendit = senddata.begin() + first;
+      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator recvit = recvdata.begin() + first;
+      sendlists[codim].setBegin(sendit);
+      recvlists[codim].setBegin(recvit);
+
+      typename YGrid::DAI r = recvgrid.dataBegin();
+      for (typename YGrid::DAI s = sendgrid.dataBegin(); s != sendgrid.dataEnd(); ++s, ++r, ++sendit, ++recvit)
+      {
+        sendit->clear();
+        recvit->clear();
+        intersections(*s, *r, *sendit, *recvit);
+      }
+
+      sendlists[codim].finalize(sendit, g.overlapfront[codim]);
+      recvlists[codim].finalize(recvit, g.overlapfront[codim]);
+      g.builtInterfaces[codim][interface] = true;
+    }
+
   protected:
 
     typedef const YaspGrid<dim,Coordinates> GridImp;
@@ -709,6 +1063,90 @@ namespace Dune {
       }
     }
 
+    //! check on all processes that the interior of this process is larger than the overlap
+    void checkOverlapping (const iTupel& s_interior) const
+    {
+#if HAVE_MPI
+      for (int i=0; i<dim; i++)
+      {
+        // find out whether the grid is too small to
+        int toosmall = (s_interior[i] <= _overlap) &&               // interior is very small
+            (_periodic[i] || (s_interior[i] != _coarseSize[i]));     // there is an overlap in that direction
+        // communicate the result to all those processes to have all processors error out if one process failed.
+        int global = 0;
+        MPI_Allreduce(&toosmall, &global, 1, MPI_INT, MPI_LOR, ccobj);
+        if (global)
+          DUNE_THROW(Dune::GridError,"YaspGrid is too small to be overlapping");
+      }
+#endif // #if HAVE_MPI
+    }
+
+    //! number of coarse cells of this process including the overlap, for equidistant coordinates
+    iTupel coarseOverlapSize (const iTupel& o_interior, const iTupel& s_interior) const
+    {
+      iTupel s_overlap(s_interior);
+      for (int i=0; i<dim; i++)
+      {
+        if ((o_interior[i] - _overlap > 0) || (_periodic[i]))
+          s_overlap[i] += _overlap;
+        if ((o_interior[i] + s_interior[i] + _overlap <= _coarseSize[i]) || (_periodic[i]))
+          s_overlap[i] += _overlap;
+      }
+      return s_overlap;
+    }
+
+    //! the part of the global coarse coordinates needed by this process, including the overlap
+    TensorProductCoordinates<ctype,dim> tensorCoordinates (const std::array<std::vector<ctype>,dim>& coords,
+                                                           const iTupel& o_interior, const iTupel& s_interior) const
+    {
+      std::array<std::vector<ctype>,dim> newcoords;
+      std::array<int, dim> offset(o_interior);
+
+      // find the relevant part of the coords vector for this processor and copy it to newcoords
+      for (int i=0; i<dim; ++i)
+      {
+        //define iterators on coords that specify the coordinate range to be used
+        typename std::vector<ctype>::const_iterator begin = coords[i].begin() + o_interior[i];
+        typename std::vector<ctype>::const_iterator end = begin + s_interior[i] + 1;
+
+        // check whether we are not at the physical boundary. In that case overlap is a simple
+        // extension of the coordinate range to be used
+        if (o_interior[i] - _overlap > 0)
+        {
+          begin = begin - _overlap;
+          offset[i] -= _overlap;
+        }
+        if (o_interior[i] + s_interior[i] + _overlap < _coarseSize[i])
+          end = end + _overlap;
+
+        //copy the selected part in the new coord vector
+        newcoords[i].resize(end-begin);
+        std::copy(begin, end, newcoords[i].begin());
+
+        // check whether we are at the physical boundary and a have a periodic grid.
+        // In this case the coordinate vector has to be tweaked manually.
+        if ((_periodic[i]) && (o_interior[i] + s_interior[i] + _overlap >= _coarseSize[i]))
+        {
+          // we need to add the first <overlap> cells to the end of newcoords
+          typename std::vector<ctype>::const_iterator it = coords[i].begin();
+          for (int j=0; j<_overlap; ++j)
+            newcoords[i].push_back(newcoords[i].back() - *it + *(++it));
+        }
+
+        if ((_periodic[i]) && (o_interior[i] - _overlap <= 0))
+        {
+          offset[i] -= _overlap;
+
+          // we need to add the last <overlap> cells to the begin of newcoords
+          typename std::vector<ctype>::const_iterator it = coords[i].end() - 1;
+          for (int j=0; j<_overlap; ++j)
+            newcoords[i].insert(newcoords[i].begin(), newcoords[i].front() - *it + *(--it));
+        }
+      }
+
+      return TensorProductCoordinates<ctype,dim>(newcoords, offset);
+    }
+
   public:
 
     // define the persistent index type
@@ -730,15 +1168,45 @@ namespace Dune {
      *  @param periodic tells if direction is periodic or not
      *  @param overlap size of overlap on coarsest grid (same in all directions)
      *  @param comm the collective communication object for this grid. An MPI communicator can be given here.
-     *  @param lb pointer to an overloaded YLoadBalance instance
+     *  @param lb pointer to an overloaded YLoadBalance instance, it is used again by loadBalance()
+     *  @param backend implementation of the nearest neighbor exchange, see TorusBackend
+     *  @param mapping placement of the ranks on the process grid, see TorusMapping
+     *  @param ordering numbering of the cells and vertices in the index sets, see YaspOrdering
+     *  @param halo partition type of the halo cells, see YaspHalo
+     *  @param threads number of threads used to build the levels with a space filling curve ordering, see setThreads()
+     *
+     *  The overload with a YaspGridOptions argument avoids spelling out the defaults of the earlier options.
      */
     YaspGrid (Dune::FieldVector<ctype, dim> L,
               std::array<int, dim> s,
               std::bitset<dim> periodic = std::bitset<dim>(0ULL),
               int overlap = 1,
               CollectiveCommunicationType comm = CollectiveCommunicationType(),
-              const YLoadBalance<dim>* lb = defaultLoadbalancer())
-      : ccobj(comm), _torus(comm,tag,s,lb), leafIndexSet_(*this),
+              const YLoadBalance<dim>* lb = defaultLoadbalancer(),
+              TorusBackend backend = TorusBackend::pointToPoint,
+              TorusMapping mapping = TorusMapping::lexicographic,
+              YaspOrdering ordering = YaspOrdering::lexicographic,
+              YaspHalo halo = YaspHalo::overlap,
+              int threads = 1)
+      : YaspGrid(L, s, periodic, overlap, comm, makeOptions(lb, backend, mapping, ordering, halo, threads))
+    {}
+
+    /** Constructor for an equidistant YaspGrid with the options in one object
+     *  @param L extension of the domain
+     *  @param s number of cells on coarse mesh in each direction
+     *  @param periodic tells if direction is periodic or not
+     *  @param overlap size of overlap on coarsest grid (same in all directions)
+     *  @param comm the collective communication object for this grid. An MPI communicator can be given here.
+     *  @param options load balancer, backend, mapping, ordering, halo and threads, see YaspGridOptions
+     */
+    YaspGrid (Dune::FieldVector<ctype, dim> L,
+              std::array<int, dim> s,
+              std::bitset<dim> periodic,
+              int overlap,
+              CollectiveCommunicationType comm,
+              const YaspGridOptions<dim>& options)
+      : ccobj(comm), _torus(comm,tag,s,loadbalancer(options),options.backend,options.mapping), _lb(keepLoadbalancer(loadbalancer(options))),
+        _ordering(options.ordering), _halo(options.halo), _threads(std::max(1, options.threads)), leafIndexSet_(*this),
         _L(L), _periodic(periodic), _coarseSize(s), _overlap(overlap),
         keep_ovlp(true), adaptRefCount(0), adaptActive(false)
     {
@@ -755,35 +1223,13 @@ namespace Dune {
 
       _torus.partition(_torus.rank(),o,s,o_interior,s_interior);
 
-#if HAVE_MPI
-      // check whether the grid is large enough to be overlapping
-      for (int i=0; i<dim; i++)
-      {
-        // find out whether the grid is too small to
-        int toosmall = (s_interior[i] <= overlap) &&    // interior is very small
-            (periodic[i] || (s_interior[i] != s[i]));    // there is an overlap in that direction
-        // communicate the result to all those processes to have all processors error out if one process failed.
-        int global = 0;
-        MPI_Allreduce(&toosmall, &global, 1, MPI_INT, MPI_LOR, comm);
-        if (global)
-          DUNE_THROW(Dune::GridError,"YaspGrid is too small to be overlapping");
-      }
-#endif // #if HAVE_MPI
+      checkOverlapping(s_interior);
 
       fTupel h(L);
       for (int i=0; i<dim; i++)
         h[i] /= s[i];
 
-      iTupel s_overlap(s_interior);
-      for (int i=0; i<dim; i++)
-      {
-        if ((o_interior[i] - overlap > 0) || (periodic[i]))
-          s_overlap[i] += overlap;
-        if ((o_interior[i] + s_interior[i] + overlap <= _coarseSize[i]) || (periodic[i]))
-          s_overlap[i] += overlap;
-      }
-
-      EquidistantCoordinates<ctype,dim> cc(h,s_overlap);
+      EquidistantCoordinates<ctype,dim> cc(h,coarseOverlapSize(o_interior,s_interior));
 
       // add level
       makelevel(cc,periodic,o_interior,overlap);
@@ -798,7 +1244,14 @@ namespace Dune {
      *  @param periodic tells if direction is periodic or not
      *  @param overlap size of overlap on coarsest grid (same in all directions)
      *  @param comm the collective communication object for this grid. An MPI communicator can be given here.
-     *  @param lb pointer to an overloaded YLoadBalance instance
+     *  @param lb pointer to an overloaded YLoadBalance instance, it is used again by loadBalance()
+     *  @param backend implementation of the nearest neighbor exchange, see TorusBackend
+     *  @param mapping placement of the ranks on the process grid, see TorusMapping
+     *  @param ordering numbering of the cells and vertices in the index sets, see YaspOrdering
+     *  @param halo partition type of the halo cells, see YaspHalo
+     *  @param threads number of threads used to build the levels with a space filling curve ordering, see setThreads()
+     *
+     *  The overload with a YaspGridOptions argument avoids spelling out the defaults of the earlier options.
      */
     YaspGrid (Dune::FieldVector<ctype, dim> lowerleft,
               Dune::FieldVector<ctype, dim> upperright,
@@ -806,8 +1259,33 @@ namespace Dune {
               std::bitset<dim> periodic = std::bitset<dim>(0ULL),
               int overlap = 1,
               CollectiveCommunicationType comm = CollectiveCommunicationType(),
-              const YLoadBalance<dim>* lb = defaultLoadbalancer())
-      : ccobj(comm), _torus(comm,tag,s,lb), leafIndexSet_(*this),
+              const YLoadBalance<dim>* lb = defaultLoadbalancer(),
+              TorusBackend backend = TorusBackend::pointToPoint,
+              TorusMapping mapping = TorusMapping::lexicographic,
+              YaspOrdering ordering = YaspOrdering::lexicographic,
+              YaspHalo halo = YaspHalo::overlap,
+              int threads = 1)
+      : YaspGrid(lowerleft, upperright, s, periodic, overlap, comm, makeOptions(lb, backend, mapping, ordering, halo, threads))
+    {}
+
+    /** Constructor for an equidistant YaspGrid with non-trivial origin and the options in one object
+     *  @param lowerleft Lower left corner of the domain
+     *  @param upperright Upper right corner of the domain
+     *  @param s number of cells on coarse mesh in each direction
+     *  @param periodic tells if direction is periodic or not
+     *  @param overlap size of overlap on coarsest grid (same in all directions)
+     *  @param comm the collective communication object for this grid. An MPI communicator can be given here.
+     *  @param options load balancer, backend, mapping, ordering, halo and threads, see YaspGridOptions
+     */
+    YaspGrid (Dune::FieldVector<ctype, dim> lowerleft,
+              Dune::FieldVector<ctype, dim> upperright,
+              std::array<int, dim> s,
+              std::bitset<dim> periodic,
+              int overlap,
+              CollectiveCommunicationType comm,
+              const YaspGridOptions<dim>& options)
+      : ccobj(comm), _torus(comm,tag,s,loadbalancer(options),options.backend,options.mapping), _lb(keepLoadbalancer(loadbalancer(options))),
+        _ordering(options.ordering), _halo(options.halo), _threads(std::max(1, options.threads)), leafIndexSet_(*this),
         _L(upperright - lowerleft),
         _periodic(periodic), _coarseSize(s), _overlap(overlap),
         keep_ovlp(true), adaptRefCount(0), adaptActive(false)
@@ -825,20 +1303,7 @@ namespace Dune {
 
       _torus.partition(_torus.rank(),o,s,o_interior,s_interior);
 
-#if HAVE_MPI
-      // check whether the grid is large enough to be overlapping
-      for (int i=0; i<dim; i++)
-      {
-        // find out whether the grid is too small to
-        int toosmall = (s_interior[i] <= overlap) &&    // interior is very small
-            (periodic[i] || (s_interior[i] != s[i]));    // there is an overlap in that direction
-        // communicate the result to all those processes to have all processors error out if one process failed.
-        int global = 0;
-        MPI_Allreduce(&toosmall, &global, 1, MPI_INT, MPI_LOR, comm);
-        if (global)
-          DUNE_THROW(Dune::GridError,"YaspGrid is too small to be overlapping");
-      }
-#endif // #if HAVE_MPI
+      checkOverlapping(s_interior);
 
       Dune::FieldVector<ctype,dim> extension(upperright);
       Dune::FieldVector<ctype,dim> h;
@@ -848,16 +1313,7 @@ namespace Dune {
         h[i] = extension[i] / s[i];
       }
 
-      iTupel s_overlap(s_interior);
-      for (int i=0; i<dim; i++)
-      {
-        if ((o_interior[i] - overlap > 0) || (periodic[i]))
-          s_overlap[i] += overlap;
-        if ((o_interior[i] + s_interior[i] + overlap <= _coarseSize[i]) || (periodic[i]))
-          s_overlap[i] += overlap;
-      }
-
-      EquidistantOffsetCoordinates<ctype,dim> cc(lowerleft,h,s_overlap);
+      EquidistantOffsetCoordinates<ctype,dim> cc(lowerleft,h,coarseOverlapSize(o_interior,s_interior));
 
       // add level
       makelevel(cc,periodic,o_interior,overlap);
@@ -870,15 +1326,43 @@ namespace Dune {
      *  @param periodic tells if direction is periodic or not
      *  @param overlap size of overlap on coarsest grid (same in all directions)
      *  @param comm the collective communication object for this grid. An MPI communicator can be given here.
-     *  @param lb pointer to an overloaded YLoadBalance instance
+     *  @param lb pointer to an overloaded YLoadBalance instance, it is used again by loadBalance()
+     *  @param backend implementation of the nearest neighbor exchange, see TorusBackend
+     *  @param mapping placement of the ranks on the process grid, see TorusMapping
+     *  @param ordering numbering of the cells and vertices in the index sets, see YaspOrdering
+     *  @param halo partition type of the halo cells, see YaspHalo
+     *  @param threads number of threads used to build the levels with a space filling curve ordering, see setThreads()
+     *
+     *  The overload with a YaspGridOptions argument avoids spelling out the defaults of the earlier options.
      */
     YaspGrid (std::array<std::vector<ctype>, dim> coords,
               std::bitset<dim> periodic = std::bitset<dim>(0ULL),
               int overlap = 1,
               CollectiveCommunicationType comm = CollectiveCommunicationType(),
-              const YLoadBalance<dim>* lb = defaultLoadbalancer())
-      : ccobj(comm), _torus(comm,tag,Dune::Yasp::sizeArray<dim>(coords),lb),
-        leafIndexSet_(*this), _periodic(periodic), _overlap(overlap),
+              const YLoadBalance<dim>* lb = defaultLoadbalancer(),
+              TorusBackend backend = TorusBackend::pointToPoint,
+              TorusMapping mapping = TorusMapping::lexicographic,
+              YaspOrdering ordering = YaspOrdering::lexicographic,
+              YaspHalo halo = YaspHalo::overlap,
+              int threads = 1)
+      : YaspGrid(coords, periodic, overlap, comm, makeOptions(lb, backend, mapping, ordering, halo, threads))
+    {}
+
+    /** @brief Constructor for a tensorproduct YaspGrid with the options in one object
+     *  @param coords coordinate vectors to be used for coarse grid
+     *  @param periodic tells if direction is periodic or not
+     *  @param overlap size of overlap on coarsest grid (same in all directions)
+     *  @param comm the collective communication object for this grid. An MPI communicator can be given here.
+     *  @param options load balancer, backend, mapping, ordering, halo and threads, see YaspGridOptions
+     */
+    YaspGrid (std::array<std::vector<ctype>, dim> coords,
+              std::bitset<dim> periodic,
+              int overlap,
+              CollectiveCommunicationType comm,
+              const YaspGridOptions<dim>& options)
+      : ccobj(comm), _torus(comm,tag,Dune::Yasp::sizeArray<dim>(coords),loadbalancer(options),options.backend,options.mapping),
+        _lb(keepLoadbalancer(loadbalancer(options))), _ordering(options.ordering), _halo(options.halo),
+        _threads(std::max(1, options.threads)), leafIndexSet_(*this), _periodic(periodic), _overlap(overlap),
         keep_ovlp(true), adaptRefCount(0), adaptActive(false)
     {
       if (!Dune::Yasp::checkIfMonotonous(coords))
@@ -903,68 +1387,8 @@ namespace Dune {
 
       _torus.partition(_torus.rank(),o,_coarseSize,o_interior,s_interior);
 
-#if HAVE_MPI
-      // check whether the grid is large enough to be overlapping
-      for (int i=0; i<dim; i++)
-      {
-        // find out whether the grid is too small to
-        int toosmall = (s_interior[i] <= overlap) &&               // interior is very small
-             (periodic[i] || (s_interior[i] != _coarseSize[i]));    // there is an overlap in that direction
-        // communicate the result to all those processes to have all processors error out if one process failed.
-        int global = 0;
-        MPI_Allreduce(&toosmall, &global, 1, MPI_INT, MPI_LOR, comm);
-        if (global)
-          DUNE_THROW(Dune::GridError,"YaspGrid is too small to be overlapping");
-      }
-#endif // #if HAVE_MPI
-
-
-      std::array<std::vector<ctype>,dim> newcoords;
-      std::array<int, dim> offset(o_interior);
-
-      // find the relevant part of the coords vector for this processor and copy it to newcoords
-      for (int i=0; i<dim; ++i)
-      {
-        //define iterators on coords that specify the coordinate range to be used
-        typename std::vector<ctype>::iterator begin = coords[i].begin() + o_interior[i];
-        typename std::vector<ctype>::iterator end = begin + s_interior[i] + 1;
-
-        // check whether we are not at the physical boundary. In that case overlap is a simple
-        // extension of the coordinate range to be used
-        if (o_interior[i] - overlap > 0)
-        {
-          begin = begin - overlap;
-          offset[i] -= overlap;
-        }
-        if (o_interior[i] + s_interior[i] + overlap < _coarseSize[i])
-          end = end + overlap;
-
-        //copy the selected part in the new coord vector
-        newcoords[i].resize(end-begin);
-        std::copy(begin, end, newcoords[i].begin());
-
-        // check whether we are at the physical boundary and a have a periodic grid.
-        // In this case the coordinate vector has to be tweaked manually.
-        if ((periodic[i]) && (o_interior[i] + s_interior[i] + overlap >= _coarseSize[i]))
-        {
-          // we need to add the first <overlap> cells to the end of newcoords
-          typename std::vector<ctype>::iterator it = coords[i].begin();
-          for (int j=0; j<overlap; ++j)
-            newcoords[i].push_back(newcoords[i].back() - *it + *(++it));
-        }
-
-        if ((periodic[i]) && (o_interior[i] - overlap <= 0))
-        {
-          offset[i] -= overlap;
-
-          // we need to add the last <overlap> cells to the begin of newcoords
-          typename std::vector<ctype>::iterator it = coords[i].end() - 1;
-          for (int j=0; j<overlap; ++j)
-            newcoords[i].insert(newcoords[i].begin(), newcoords[i].front() - *it + *(--it));
-        }
-      }
-
-      TensorProductCoordinates<ctype,dim> cc(newcoords, offset);
+      checkOverlapping(s_interior);
+      TensorProductCoordinates<ctype,dim> cc(tensorCoordinates(coords,o_interior,s_interior));
 
       // add level
       makelevel(cc,periodic,o_interior,overlap);
@@ -980,7 +1404,7 @@ namespace Dune {
      *  @param periodic tells if direction is periodic or not
      *  @param overlap size of overlap on coarsest grid (same in all directions)
      *  @param coarseSize the coarse size of the global grid
-     *  @param lb pointer to an overloaded YLoadBalance instance
+     *  @param options load balancer, backend, mapping, ordering, halo and threads, see YaspGridOptions
      *
      *  @warning The construction of overlapping coordinate ranges is
      *           an error-prone procedure. For this reason, it is kept private.
@@ -992,8 +1416,10 @@ namespace Dune {
               int overlap,
               CollectiveCommunicationType comm,
               std::array<int,dim> coarseSize,
-              const YLoadBalance<dim>* lb = defaultLoadbalancer())
-      : ccobj(comm), _torus(comm,tag,coarseSize,lb), leafIndexSet_(*this),
+              const YaspGridOptions<dim>& options = YaspGridOptions<dim>())
+      : ccobj(comm), _torus(comm,tag,coarseSize,loadbalancer(options),options.backend,options.mapping),
+        _lb(keepLoadbalancer(loadbalancer(options))), _ordering(options.ordering), _halo(options.halo),
+        _threads(std::max(1, options.threads)), leafIndexSet_(*this),
         _periodic(periodic), _coarseSize(coarseSize), _overlap(overlap),
         keep_ovlp(true), adaptRefCount(0), adaptActive(false)
     {
@@ -1233,26 +1659,26 @@ namespace Dune {
     int overlapSize (int level, int codim) const
     {
       YGridLevelIterator g = begin(level);
-      return g->overlapSize;
+      return g->ghosts ? 0 : g->overlapSize;
     }
 
     //! return size (= distance in graph) of overlap region
     int overlapSize (int codim) const
     {
-      YGridLevelIterator g = begin(maxLevel());
-      return g->overlapSize;
+      return overlapSize(maxLevel(), codim);
     }
 
     //! return size (= distance in graph) of ghost region
     int ghostSize (int level, int codim) const
     {
-      return 0;
+      YGridLevelIterator g = begin(level);
+      return g->ghosts ? g->overlapSize : 0;
     }
 
     //! return size (= distance in graph) of ghost region
     int ghostSize (int codim) const
     {
-      return 0;
+      return ghostSize(maxLevel(), codim);
     }
 
     //! number of entities per level and codim in this process
@@ -1334,141 +1760,51 @@ namespace Dune {
       // access to grid level
       YGridLevelIterator g = begin(level);
 
-      // find send/recv lists or throw error
+      // find send/recv lists
       const YGridList<Coordinates>* sendlist = 0;
       const YGridList<Coordinates>* recvlist = 0;
+      interfaceLists(g,codim,iftype,dir,sendlist,recvlist);
 
-      if (iftype==InteriorBorder_InteriorBorder_Interface)
-      {
-        sendlist = &g->send_interiorborder_interiorborder[codim];
-        recvlist = &g->recv_interiorborder_interiorborder[codim];
-      }
-      if (iftype==InteriorBorder_All_Interface)
-      {
-        sendlist = &g->send_interiorborder_overlapfront[codim];
-        recvlist = &g->recv_overlapfront_interiorborder[codim];
-      }
-      if (iftype==Overlap_OverlapFront_Interface || iftype==Overlap_All_Interface)
+      // fixed size data is sent through a persistent communication plan
+      if (data.fixedSize(dim,codim) && std::is_trivially_copyable<DataType>::value)
       {
-        sendlist = &g->send_overlap_overlapfront[codim];
-        recvlist = &g->recv_overlapfront_overlap[codim];
+        communicateCodimPersistent<DataHandle,codim>(data,g,*sendlist,*recvlist,iftype,dir);
+        return;
       }
-      if (iftype==All_All_Interface)
+
+      // variable size data is sent together with its sizes in a single exchange
+      if (!data.fixedSize(dim,codim))
       {
-        sendlist = &g->send_overlapfront_overlapfront[codim];
-        recvlist = &g->recv_overlapfront_overlapfront[codim];
+        communicateCodimVariable<DataHandle,codim>(data,g,*sendlist,*recvlist);
+        return;
       }
 
-      // change communication direction?
-      if (dir==BackwardCommunication)
-        std::swap(sendlist,recvlist);
-
       int cnt;
 
-      // Size computation (requires communication if variable size)
+      // Size computation, a dummy entity suffices for fixed size data
       std::vector<int> send_size(sendlist->size(),-1);    // map rank to total number of objects (of type DataType) to be sent
       std::vector<int> recv_size(recvlist->size(),-1);    // map rank to total number of objects (of type DataType) to be recvd
-      std::vector<size_t*> send_sizes(sendlist->size(),static_cast<size_t*>(0)); // map rank to array giving number of objects per entity to be sent
-      std::vector<size_t*> recv_sizes(recvlist->size(),static_cast<size_t*>(0)); // map rank to array giving number of objects per entity to be recvd
 
       // define type to iterate over send and recv lists
       typedef typename YGridList<Coordinates>::Iterator ListIt;
 
-      if (data.fixedSize(dim,codim))
+      cnt=0;
+      for (ListIt is=sendlist->begin(); is!=sendlist->end(); ++is)
       {
-        // fixed size: just take a dummy entity, size can be computed without communication
-        cnt=0;
-        for (ListIt is=sendlist->begin(); is!=sendlist->end(); ++is)
-        {
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
-          send_size[cnt] = is->grid.totalsize() * data.size(*it);
-          cnt++;
-        }
-        cnt=0;
-        for (ListIt is=recvlist->begin(); is!=recvlist->end(); ++is)
-        {
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
-          recv_size[cnt] = is->grid.totalsize() * data.size(*it);
-          cnt++;
-        }
+        typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
+        it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
+        send_size[cnt] = is->grid.totalsize() * data.size(*it);
+        cnt++;
       }
-      else
+      cnt=0;
+      for (ListIt is=recvlist->begin(); is!=recvlist->end(); ++is)
       {
-        // variable size case: sender side determines the size
-        cnt=0;
-        for (ListIt is=sendlist->begin(); is!=sendlist->end(); ++is)
-        {
-          // allocate send buffer for sizes per entitiy
-          size_t *buf = new size_t[is->grid.totalsize()];
-          send_sizes[cnt] = buf;
-
-          // loop over entities and ask for size
-          int i=0; size_t n=0;
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg,true)));
-          for ( ; it!=itend; ++it)
-          {
-            buf[i] = data.size(*it);
-            n += buf[i];
-            i++;
-          }
-
-          // now we know the size for this rank
-          send_size[cnt] = n;
-
-          // hand over send request to torus class
-          torus().send(is->rank,buf,is->grid.totalsize()*sizeof(size_t));
-          cnt++;
-        }
-
-        // allocate recv buffers for sizes and store receive request
-        cnt=0;
-        for (ListIt is=recvlist->begin(); is!=recvlist->end(); ++is)
-        {
-          // allocate recv buffer
-          size_t *buf = new size_t[is->grid.totalsize()];
-          recv_sizes[cnt] = buf;
-
-          // hand over recv request to torus class
-          torus().recv(is->rank,buf,is->grid.totalsize()*sizeof(size_t));
-          cnt++;
-        }
-
-        // exchange all size buffers now
-        torus().exchange();
-
-        // release send size buffers
-        cnt=0;
-        for (ListIt is=sendlist->begin(); is!=sendlist->end(); ++is)
-        {
-          delete[] send_sizes[cnt];
-          send_sizes[cnt] = 0;
-          cnt++;
-        }
-
-        // process receive size buffers
-        cnt=0;
-        for (ListIt is=recvlist->begin(); is!=recvlist->end(); ++is)
-        {
-          // get recv buffer
-          size_t *buf = recv_sizes[cnt];
-
-          // compute total size
-          size_t n=0;
-          for (int i=0; i<is->grid.totalsize(); ++i)
-            n += buf[i];
-
-          // ... and store it
-          recv_size[cnt] = n;
-          ++cnt;
-        }
+        typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
+        it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
+        recv_size[cnt] = is->grid.totalsize() * data.size(*it);
+        cnt++;
       }
 
-
       // allocate & fill the send buffers & store send request
       std::vector<DataType*> sends(sendlist->size(), static_cast<DataType*>(0)); // store pointers to send buffers
       cnt=0;
@@ -1535,28 +1871,13 @@ namespace Dune {
         MessageBuffer<DataType> mb(buf);
 
         // copy data from receive buffer; iterate over cells in intersection
-        if (data.fixedSize(dim,codim))
-        {
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
-          size_t n=data.size(*it);
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg,true)));
-          for ( ; it!=itend; ++it)
-            data.scatter(mb,*it,n);
-        }
-        else
-        {
-          int i=0;
-          size_t *sbuf = recv_sizes[cnt];
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg,true)));
-          for ( ; it!=itend; ++it)
-            data.scatter(mb,*it,sbuf[i++]);
-          delete[] sbuf;
-        }
+        typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
+        it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
+        size_t n=data.size(*it);
+        typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
+        itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg,true)));
+        for ( ; it!=itend; ++it)
+          data.scatter(mb,*it,n);
 
         // delete buffer
         delete[] buf; // hier krachts !
@@ -1564,131 +1885,1274 @@ namespace Dune {
       }
     }
 
-    // The new index sets from DDM 11.07.2005
-    const typename Traits::GlobalIdSet& globalIdSet() const
+    /*! start communicating objects for one codim
+
+       Fixed size data is gathered into a persistent communication plan and the
+       messages are started. The plan is stored in the given slot and has to be
+       completed by communicateCodimFinish(). Variable size data is communicated
+       immediately with communicateCodim(), then the slot stays empty.
+     */
+    template<class DataHandle, int codim>
+    void communicateCodimBegin (DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level,
+                                typename Torus<CollectiveCommunicationType,dim>::CommPlan*& slot) const
     {
-      return theglobalidset;
+      typedef typename DataHandle::DataType DataType;
+
+      slot = 0;
+      if (!data.contains(dim,codim)) return;
+
+      if (!(data.fixedSize(dim,codim) && std::is_trivially_copyable<DataType>::value))
+      {
+        communicateCodim<DataHandle,codim>(data,iftype,dir,level);
+        return;
+      }
+
+      YGridLevelIterator g = begin(level);
+      const YGridList<Coordinates>* sendlist = 0;
+      const YGridList<Coordinates>* recvlist = 0;
+      interfaceLists(g,codim,iftype,dir,sendlist,recvlist);
+
+      const std::size_t n = fixedCommSize<DataHandle,codim>(data,g);
+      typename Torus<CollectiveCommunicationType,dim>::CommPlan& plan = commPlan<DataType>(g,codim,*sendlist,*recvlist,iftype,dir,n);
+      gatherPlan<DataHandle,codim>(data,g,*sendlist,plan);
+      plan.start();
+      slot = &plan;
     }
 
-    const typename Traits::LocalIdSet& localIdSet() const
+    /*! complete the communication started by communicateCodimBegin()
+
+       Received messages are scattered one by one as they arrive. If block is
+       false, only the messages that have already arrived are processed.
+       Returns true when the communication of this codim is complete.
+     */
+    template<class DataHandle, int codim>
+    bool communicateCodimFinish (DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level,
+                                 typename Torus<CollectiveCommunicationType,dim>::CommPlan*& slot, bool block) const
     {
-      return theglobalidset;
+      if (!slot) return true;
+
+      YGridLevelIterator g = begin(level);
+      const YGridList<Coordinates>* sendlist = 0;
+      const YGridList<Coordinates>* recvlist = 0;
+      interfaceLists(g,codim,iftype,dir,sendlist,recvlist);
+
+      const std::size_t n = fixedCommSize<DataHandle,codim>(data,g);
+      do
+      {
+        const std::vector<int>& done = block ? slot->waitsome() : slot->testsome();
+        for (std::size_t k=0; k<done.size(); k++)
+          scatterPlan<DataHandle,codim>(data,g,*recvlist,*slot,done[k],n);
+      }
+      while (block && slot->active());
+
+      if (slot->active())
+        return false;
+      slot = 0;
+      return true;
     }
 
-    const typename Traits::LevelIndexSet& levelIndexSet(int level) const
+    /*! The split-phase communication interface
+
+       start communicating objects for all codims on a given level. The returned
+       object completes the communication with wait() or test().
+     */
+    template<class DataHandleImp, class DataType>
+    YaspCommunication<GridImp, CommDataHandleIF<DataHandleImp,DataType> >
+    communicateBegin (CommDataHandleIF<DataHandleImp,DataType> & data, InterfaceType iftype, CommunicationDirection dir, int level) const
     {
-      if (level<0 || level>maxLevel()) DUNE_THROW(RangeError, "level out of range");
-      return *(indexsets[level]);
+      return YaspCommunication<GridImp, CommDataHandleIF<DataHandleImp,DataType> >(*this,data,iftype,dir,level);
     }
 
-    const typename Traits::LeafIndexSet& leafIndexSet() const
+    /*! The split-phase communication interface
+
+       start communicating objects for all codims on the leaf grid
+     */
+    template<class DataHandleImp, class DataType>
+    YaspCommunication<GridImp, CommDataHandleIF<DataHandleImp,DataType> >
+    communicateBegin (CommDataHandleIF<DataHandleImp,DataType> & data, InterfaceType iftype, CommunicationDirection dir) const
     {
-      return leafIndexSet_;
+      return communicateBegin(data,iftype,dir,this->maxLevel());
     }
 
-    /*! @brief return a collective communication object
+    /*! \brief communicate several data handles together on a given level
+
+       The data of all handles, for all their codims, is packed into one
+       message per neighbor, which are sent in a single exchange. The handles
+       may have different data types and codims. Variable size data carries
+       the sizes of its entities in the same message. Handles whose data type
+       is not trivially copyable can not be
+       packed and are communicated separately afterwards.
+
+       \code
+       grid.communicate(std::tie(pressure, velocity, levelset), InteriorBorder_All_Interface, ForwardCommunication, level);
+       \endcode
      */
-    const CollectiveCommunicationType& comm () const
+    template<class... DataHandles>
+    void communicate (const std::tuple<DataHandles&...>& handles, InterfaceType iftype, CommunicationDirection dir, int level) const
     {
-      return ccobj;
+      typedef Std::make_index_sequence<sizeof...(DataHandles)> Indices;
+
+      FusedMessages m;
+      Hybrid::forEach(Indices{}, [&](auto i){
+          YaspCommunicateMeta<dim,dim>::fusedGather(*this,std::get<i>(handles),iftype,dir,level,m);
+        });
+
+      // the receivers take the size of the messages from the messages if they can not compute it
+      for (auto& r : m.recvSize)
+      {
+        std::vector<char>& buf = m.recv[r.first];
+        if (m.variable)
+          torus().recv(r.first,buf);
+        else
+        {
+          buf.resize(r.second);
+          torus().recv(r.first,buf.data(),buf.size());
+        }
+      }
+      for (auto& s : m.send)
+        torus().send(s.first,s.second.data(),s.second.size());
+      torus().exchange();
+
+      Hybrid::forEach(Indices{}, [&](auto i){
+          YaspCommunicateMeta<dim,dim>::fusedScatter(*this,std::get<i>(handles),iftype,dir,level,m);
+        });
+
+      Hybrid::forEach(Indices{}, [&](auto i){
+          typedef typename std::decay_t<decltype(std::get<i>(handles))>::DataType DataType;
+          if (!std::is_trivially_copyable<DataType>::value)
+            this->communicate(std::get<i>(handles),iftype,dir,level);
+        });
     }
 
-  private:
+    /*! \brief communicate several data handles together on the leaf grid
 
-    // number of boundary segments of the level 0 grid
-    int nBSegments;
+       \sa communicate(const std::tuple<DataHandles&...>&,InterfaceType,CommunicationDirection,int)
+     */
+    template<class... DataHandles>
+    void communicate (const std::tuple<DataHandles&...>& handles, InterfaceType iftype, CommunicationDirection dir) const
+    {
+      communicate(handles,iftype,dir,this->maxLevel());
+    }
 
-    // Index classes need access to the real entity
-    friend class Dune::YaspIndexSet<const Dune::YaspGrid<dim, Coordinates>, true >;
-    friend class Dune::YaspIndexSet<const Dune::YaspGrid<dim, Coordinates>, false >;
-    friend class Dune::YaspGlobalIdSet<const Dune::YaspGrid<dim, Coordinates> >;
-    friend class Dune::YaspPersistentContainerIndex<const Dune::YaspGrid<dim, Coordinates> >;
+    /*! \brief communicate an array indexed by the level index set
+
+       This is a fast path for data that is stored contiguously in an array
+       indexed by the level index set of the given codim, with blocksize objects
+       of the trivially copyable type T per entity. The messages to the neighbors
+       are described by MPI subarray datatypes taken from the intersections of
+       the communication interface. Data is thus sent directly from and received
+       directly into the array, no data handle and no intermediate buffers are
+       involved. The datatypes are built on first use and cached in the grid level.
+       For cells and vertices numbered along a space filling curve, see YaspOrdering,
+       indexed datatypes with one displacement per entity are used instead.
+
+       \param data pointer to the first entry of the array
+       \param blocksize number of objects per entity
+       \param codim codimension of the entities the array is attached to
+       \param iftype the communication interface
+       \param dir the communication direction
+       \param level the grid level
+     */
+    template<class T>
+    void communicateVector (T* data, int blocksize, int codim, InterfaceType iftype, CommunicationDirection dir, int level) const
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "communicateVector requires trivially copyable data");
 
-    friend class Dune::YaspIntersectionIterator<const Dune::YaspGrid<dim, Coordinates> >;
-    friend class Dune::YaspIntersection<const Dune::YaspGrid<dim, Coordinates> >;
-    friend class Dune::YaspEntity<0, dim, const Dune::YaspGrid<dim, Coordinates> >;
+      YGridLevelIterator g = begin(level);
+      const YGridList<Coordinates>* sendlist = 0;
+      const YGridList<Coordinates>* recvlist = 0;
+      interfaceLists(g,codim,iftype,dir,sendlist,recvlist);
 
-    template<int codim_, int dim_, class GridImp_, template<int,int,class> class EntityImp_>
-    friend class Entity;
+      typedef typename YGridList<Coordinates>::Iterator ListIt;
 
-    template<class DT>
-    class MessageBuffer {
-    public:
-      // Constructor
-      MessageBuffer (DT *p)
-      {
-        a=p;
-        i=0;
-        j=0;
-      }
+#if HAVE_MPI
+      typedef typename Torus<CollectiveCommunicationType,dim>::DatatypeExchange DatatypeExchange;
 
-      // write data to message buffer, acts like a stream !
-      template<class Y>
-      void write (const Y& data)
+      const int bytes = blocksize*sizeof(T);
+      const std::array<int,4> key = {{ codim, iftype, dir, bytes }};
+      std::shared_ptr<DatatypeExchange>& exchange = g->vectorexchanges[key];
+      if (!exchange)
       {
-        static_assert(( std::is_same<DT,Y>::value ), "DataType mismatch");
-        a[i++] = data;
-      }
+        exchange = std::make_shared<DatatypeExchange>(torus());
 
-      // read data from message buffer, acts like a stream !
-      template<class Y>
-      void read (Y& data) const
+        // the objects of one entity
+        MPI_Datatype entity;
+        MPI_Type_contiguous(bytes, MPI_BYTE, &entity);
+
+        if (g->curveOrder(codim))
+        {
+          for (ListIt is=sendlist->begin(); is!=sendlist->end(); ++is)
+            exchange->send(is->rank, indexedType(g,codim,is->yg,entity), 0);
+          for (ListIt is=recvlist->begin(); is!=recvlist->end(); ++is)
+            exchange->recv(is->rank, indexedType(g,codim,is->yg,entity), 0);
+        }
+        else
+        {
+          for (ListIt is=sendlist->begin(); is!=sendlist->end(); ++is)
+            exchange->send(is->rank, subarrayType(is->grid,entity), std::ptrdiff_t(componentOffset(*is))*bytes);
+          for (ListIt is=recvlist->begin(); is!=recvlist->end(); ++is)
+            exchange->recv(is->rank, subarrayType(is->grid,entity), std::ptrdiff_t(componentOffset(*is))*bytes);
+        }
+
+        MPI_Type_free(&entity);
+      }
+      exchange->exchange(data);
+#else
+      // sequential case: all messages are local (periodic) and matched in order
+      ListIt ir=recvlist->begin();
+      for (ListIt is=sendlist->begin(); is!=sendlist->end(); ++is, ++ir)
       {
-        static_assert(( std::is_same<DT,Y>::value ), "DataType mismatch");
-        data = a[j++];
+        typename YGrid::Iterator send(is->yg), recv(ir->yg), sendend(is->yg,true);
+        for ( ; send!=sendend; ++send, ++recv)
+        {
+          const int s = g->index(codim, send.superindex());
+          std::copy(data+s*blocksize, data+(s+1)*blocksize, data+g->index(codim, recv.superindex())*blocksize);
+        }
       }
+#endif
+    }
 
-    private:
-      DT *a;
-      int i;
-      mutable int j;
-    };
+    /*! \brief communicate an array indexed by the leaf index set
 
-    //! one past the end on this level
-    template<int cd, PartitionIteratorType pitype>
-    YaspLevelIterator<cd,pitype,GridImp> levelbegin (int level) const
+       \sa communicateVector(T*,int,int,InterfaceType,CommunicationDirection,int)
+     */
+    template<class T>
+    void communicateVector (T* data, int blocksize, int codim, InterfaceType iftype, CommunicationDirection dir) const
     {
-      YGridLevelIterator g = begin(level);
-      if (level<0 || level>maxLevel()) DUNE_THROW(RangeError, "level out of range");
+      communicateVector(data,blocksize,codim,iftype,dir,this->maxLevel());
+    }
 
-      if (pitype==Interior_Partition)
-        return YaspLevelIterator<cd,pitype,GridImp>(g,g->interior[cd].begin());
-      if (pitype==InteriorBorder_Partition)
-        return YaspLevelIterator<cd,pitype,GridImp>(g,g->interiorborder[cd].begin());
-      if (pitype==Overlap_Partition)
-        return YaspLevelIterator<cd,pitype,GridImp>(g,g->overlap[cd].begin());
-      if (pitype<=All_Partition)
-        return YaspLevelIterator<cd,pitype,GridImp>(g,g->overlapfront[cd].begin());
-      if (pitype==Ghost_Partition)
-        return levelend <cd, pitype> (level);
+    /*! \brief repartition the grid with the load balancer given at construction
 
-      DUNE_THROW(GridError, "YaspLevelIterator with this codim or partition type not implemented");
-    }
+       This is useful if the load balancer depends on data that changes during
+       the simulation, e.g. a user defined YLoadBalance with a time dependent
+       cost. No user data is migrated.
 
-    //! Iterator to one past the last entity of given codim on level for partition type
-    template<int cd, PartitionIteratorType pitype>
-    YaspLevelIterator<cd,pitype,GridImp> levelend (int level) const
-    {
-      YGridLevelIterator g = begin(level);
-      if (level<0 || level>maxLevel()) DUNE_THROW(RangeError, "level out of range");
+       The grid keeps a copy of the load balancer made by YLoadBalance::clone().
 
-      if (pitype==Interior_Partition)
-        return YaspLevelIterator<cd,pitype,GridImp>(g,g->interior[cd].end());
-      if (pitype==InteriorBorder_Partition)
-        return YaspLevelIterator<cd,pitype,GridImp>(g,g->interiorborder[cd].end());
-      if (pitype==Overlap_Partition)
-        return YaspLevelIterator<cd,pitype,GridImp>(g,g->overlap[cd].end());
-      if (pitype<=All_Partition || pitype == Ghost_Partition)
-        return YaspLevelIterator<cd,pitype,GridImp>(g,g->overlapfront[cd].end());
+       \throws GridError if the load balancer does not implement clone()
 
-      DUNE_THROW(GridError, "YaspLevelIterator with this codim or partition type not implemented");
+       \returns true if the partition has changed
+       \sa repartition(const YLoadBalance<dim>&,DataHandle&)
+     */
+    bool loadBalance ()
+    {
+      return repartition(keptLoadbalancer());
     }
 
-    CollectiveCommunicationType ccobj;
+    /*! \brief repartition the grid with the load balancer given at construction and migrate data
 
-    Torus<CollectiveCommunicationType,dim> _torus;
+       \throws GridError if the load balancer does not implement clone()
+       \sa repartition(const YLoadBalance<dim>&,DataHandle&)
+     */
+    template<class DataHandle>
+    bool loadBalance (DataHandle& data)
+    {
+      return repartition(keptLoadbalancer(), data);
+    }
 
-    std::vector< std::shared_ptr< YaspIndexSet<const YaspGrid<dim,Coordinates>, false > > > indexsets;
+    /*! \brief repartition the grid with the given load balancer
+
+       \sa repartition(const YLoadBalance<dim>&,DataHandle&)
+     */
+    bool repartition (const YLoadBalance<dim>& lb)
+    {
+      NoMigrationData data;
+      return repartition(lb, data);
+    }
+
+    /*! \brief repartition the grid with the given load balancer and migrate data
+
+       A new torus is set up for the coarse grid with the given load balancer
+       and all levels are rebuilt with the same refinement and overlap as before.
+       The data of every entity contained in the data handle is gathered on the
+       process that owned it before (the lowest one in case of border entities)
+       and scattered on all processes that have the entity afterwards, including
+       their overlap and front entities. The data handle is used with
+       CommDataHandleIF::gather() before and CommDataHandleIF::scatter() after
+       the grid has been modified, so it has to refer to containers indexed by
+       ids, not by indices. All iterators, entities and index sets are invalid
+       afterwards. This is collective on all processes of the grid.
+
+       \returns true if the partition has changed. If it has not, neither the grid nor the data are touched.
+     */
+    template<class DataHandle>
+    bool repartition (const YLoadBalance<dim>& lb, DataHandle& data)
+    {
+      typedef typename DataHandle::DataType DataType;
+
+      Torus<CollectiveCommunicationType,dim> torus(ccobj,tag,_coarseSize,&lb,_torus.backend(),_torus.mapping());
+      if (samePartition(torus))
+        return false;
+
+      iTupel o, o_interior, s_interior;
+      std::fill(o.begin(), o.end(), 0);
+      torus.partition(torus.rank(),o,_coarseSize,o_interior,s_interior);
+      checkOverlapping(s_interior);
+
+      // send the data of all entities to their new processes
+      Migration<DataType> migration(torus);
+      YaspCommunicateMeta<dim,dim>::migrateGather(*this,data,migration);
+      migrationExchange(migration);
+
+      // the coarse grid coordinates of the new partition, uses the old one
+      Coordinates coarse(coarseCoordinates(_levels[0].coords,o_interior,s_interior));
+
+      // remember how the levels have been refined
+      std::vector<bool> keep;
+      for (int l=0; l<=maxLevel(); l++)
+        keep.push_back(_levels[l].keepOverlap);
+      bool keepOverlap = keep_ovlp;
+
+      // rebuild the hierarchy on the new torus
+      globalRefine(-maxLevel());
+      YGridLevel empty;
+      _levels.back() = empty;
+      _levels.pop_back();
+      indexsets.clear();
+
+      _torus = torus;
+      _levels.resize(1);
+      keep_ovlp = keep[0];
+      makelevel(coarse,_periodic,o_interior,_overlap);
+      init();
+
+      for (std::size_t l=1; l<keep.size(); l++)
+      {
+        keep_ovlp = keep[l];
+        globalRefine(1);
+      }
+      keep_ovlp = keepOverlap;
+
+      YaspCommunicateMeta<dim,dim>::migrateScatter(*this,data,migration);
+      return true;
+    }
+
+  private:
+
+    //! find the send and receive lists for a codim, interface and direction
+    void interfaceLists (YGridLevelIterator g, int codim, InterfaceType iftype, CommunicationDirection dir,
+                         const YGridList<Coordinates>*& sendlist, const YGridList<Coordinates>*& recvlist) const
+    {
+      if (iftype==InteriorBorder_InteriorBorder_Interface)
+      {
+        makeInterfaceLists(*g,codim,0,g->interiorborder[codim],g->interiorborder[codim],
+                           g->send_interiorborder_interiorborder,g->send_interiorborder_interiorborder_data,
+                           g->recv_interiorborder_interiorborder,g->recv_interiorborder_interiorborder_data);
+        sendlist = &g->send_interiorborder_interiorborder[codim];
+        recvlist = &g->recv_interiorborder_interiorborder[codim];
+      }
+      if (iftype==InteriorBorder_All_Interface)
+      {
+        makeInterfaceLists(*g,codim,1,g->interiorborder[codim],g->overlapfront[codim],
+                           g->send_interiorborder_overlapfront,g->send_interiorborder_overlapfront_data,
+                           g->recv_overlapfront_interiorborder,g->recv_overlapfront_interiorborder_data);
+        sendlist = &g->send_interiorborder_overlapfront[codim];
+        recvlist = &g->recv_overlapfront_interiorborder[codim];
+      }
+      if (iftype==Overlap_OverlapFront_Interface || iftype==Overlap_All_Interface)
+      {
+        // with a ghost halo there are no overlap entities and the lists stay empty
+        if (!g->ghosts)
+          makeInterfaceLists(*g,codim,2,g->overlap[codim],g->overlapfront[codim],
+                             g->send_overlap_overlapfront,g->send_overlap_overlapfront_data,
+                             g->recv_overlapfront_overlap,g->recv_overlapfront_overlap_data);
+        sendlist = &g->send_overlap_overlapfront[codim];
+        recvlist = &g->recv_overlapfront_overlap[codim];
+      }
+      if (iftype==All_All_Interface)
+      {
+        makeInterfaceLists(*g,codim,3,g->overlapfront[codim],g->overlapfront[codim],
+                           g->send_overlapfront_overlapfront,g->send_overlapfront_overlapfront_data,
+                           g->recv_overlapfront_overlapfront,g->recv_overlapfront_overlapfront_data);
+        sendlist = &g->send_overlapfront_overlapfront[codim];
+        recvlist = &g->recv_overlapfront_overlapfront[codim];
+      }
+
+      // change communication direction?
+      if (dir==BackwardCommunication)
+        std::swap(sendlist,recvlist);
+    }
+
+    //! index of the first entity of the component an intersection lies in
+    int componentOffset (const Intersection& i) const
+    {
+      typename YGrid::Iterator it(i.yg);
+      return it.superindex() - i.grid.superindex(i.grid.origin());
+    }
+
+#if HAVE_MPI
+    //! MPI datatype selecting the entities of a grid component from the enclosing index range
+    MPI_Datatype subarrayType (const YGridComponent<Coordinates>& grid, MPI_Datatype entity) const
+    {
+      // the index sets number lexicographically with direction 0 running fastest
+      int sizes[dim], subsizes[dim], starts[dim];
+      for (int i=0; i<dim; i++)
+      {
+        sizes[i] = grid.supersize(i);
+        subsizes[i] = grid.size(i);
+        starts[i] = grid.offset(i);
+      }
+      MPI_Datatype type;
+      MPI_Type_create_subarray(dim, sizes, subsizes, starts, MPI_ORDER_FORTRAN, entity, &type);
+      return type;
+    }
+
+    //! MPI datatype selecting the entities of an intersection from an array ordered along a space filling curve
+    MPI_Datatype indexedType (YGridLevelIterator g, int codim, const YGrid& yg, MPI_Datatype entity) const
+    {
+      // both sides traverse the intersection lexicographically in global coordinates
+      std::vector<int> displacements;
+      typename YGrid::Iterator it(yg), end(yg,true);
+      for ( ; it!=end; ++it)
+        displacements.push_back(g->index(codim, it.superindex()));
+      MPI_Datatype type;
+      MPI_Type_create_indexed_block(displacements.size(), 1, displacements.data(), entity, &type);
+      return type;
+    }
+#endif
+
+    //! number of objects per entity for fixed size data, taken from a dummy entity
+    template<class DataHandle, int codim>
+    std::size_t fixedCommSize (DataHandle& data, YGridLevelIterator g) const
+    {
+      typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
+      dummy(YaspLevelIterator<codim,All_Partition,GridImp>(g, g->overlapfront[codim].begin()));
+      return data.size(*dummy);
+    }
+
+    /*! return the persistent communication plan for fixed size data
+
+       The plan (message sizes, buffers and persistent requests) only depends on the
+       level, codim, interface, direction and the number of bytes per entity. It is
+       built on first use and stored in the grid level, such that subsequent calls
+       only gather, exchange and scatter without allocating memory. Throws if the
+       plan is still in flight, before any data is gathered into it.
+     */
+    template<class DataType>
+    typename Torus<CollectiveCommunicationType,dim>::CommPlan&
+    commPlan (YGridLevelIterator g, int codim,
+              const YGridList<Coordinates>& sendlist, const YGridList<Coordinates>& recvlist,
+              InterfaceType iftype, CommunicationDirection dir, std::size_t n) const
+    {
+      typedef typename YGridList<Coordinates>::Iterator ListIt;
+      typedef typename Torus<CollectiveCommunicationType,dim>::CommPlan CommPlan;
+
+      const std::array<int,4> key = {{ codim, iftype, dir, int(n*sizeof(DataType)) }};
+      std::shared_ptr<CommPlan>& plan = g->commplans[key];
+      if (!plan)
+      {
+        plan = std::make_shared<CommPlan>(torus());
+        for (ListIt is=sendlist.begin(); is!=sendlist.end(); ++is)
+          plan->send(is->rank, is->grid.totalsize()*n*sizeof(DataType));
+        for (ListIt is=recvlist.begin(); is!=recvlist.end(); ++is)
+          plan->recv(is->rank, is->grid.totalsize()*n*sizeof(DataType));
+        plan->commit();
+      }
+
+      // the buffers of a plan in flight must not be overwritten by another gather
+      if (plan->active())
+        DUNE_THROW(InvalidStateException, "communication with codim " << codim << ", interface " << iftype
+                   << " and direction " << dir << " started while a previous one is still in flight");
+      return *plan;
+    }
+
+    //! fill the send buffers of a plan; iterate over cells in intersection
+    template<class DataHandle, int codim>
+    void gatherPlan (DataHandle& data, YGridLevelIterator g, const YGridList<Coordinates>& sendlist,
+                     typename Torus<CollectiveCommunicationType,dim>::CommPlan& plan) const
+    {
+      typedef typename DataHandle::DataType DataType;
+      typedef typename YGridList<Coordinates>::Iterator ListIt;
+      typedef typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator LevelIterator;
+
+      int cnt=0;
+      for (ListIt is=sendlist.begin(); is!=sendlist.end(); ++is)
+      {
+        MessageBuffer<DataType> mb(static_cast<DataType*>(plan.sendBuffer(cnt)));
+        LevelIterator it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
+        LevelIterator itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg,true)));
+        for ( ; it!=itend; ++it)
+          data.gather(mb,*it);
+        cnt++;
+      }
+    }
+
+    //! copy data from receive buffer i of a plan; iterate over cells in intersection
+    template<class DataHandle, int codim>
+    void scatterPlan (DataHandle& data, YGridLevelIterator g, const YGridList<Coordinates>& recvlist,
+                      typename Torus<CollectiveCommunicationType,dim>::CommPlan& plan, int i, std::size_t n) const
+    {
+      typedef typename DataHandle::DataType DataType;
+      typedef typename YGridList<Coordinates>::Iterator ListIt;
+      typedef typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator LevelIterator;
+
+      ListIt is=recvlist.begin();
+      for (int k=0; k<i; k++)
+        ++is;
+
+      MessageBuffer<DataType> mb(static_cast<DataType*>(plan.recvBuffer(i)));
+      LevelIterator it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
+      LevelIterator itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg,true)));
+      for ( ; it!=itend; ++it)
+        data.scatter(mb,*it,n);
+    }
+
+    //! communicate fixed size data for one codim using a persistent communication plan
+    template<class DataHandle, int codim>
+    void communicateCodimPersistent (DataHandle& data, YGridLevelIterator g,
+                                     const YGridList<Coordinates>& sendlist, const YGridList<Coordinates>& recvlist,
+                                     InterfaceType iftype, CommunicationDirection dir) const
+    {
+      typedef typename DataHandle::DataType DataType;
+
+      const std::size_t n = fixedCommSize<DataHandle,codim>(data,g);
+      typename Torus<CollectiveCommunicationType,dim>::CommPlan& plan = commPlan<DataType>(g,codim,sendlist,recvlist,iftype,dir,n);
+
+      gatherPlan<DataHandle,codim>(data,g,sendlist,plan);
+      plan.exchange();
+      for (int i=0; i<plan.recvs(); i++)
+        scatterPlan<DataHandle,codim>(data,g,recvlist,plan,i,n);
+    }
+
+    //! a data handle without any data, for repartitioning without migration
+    struct NoMigrationData
+      : public CommDataHandleIF<NoMigrationData,char>
+    {
+      bool contains (int, int) const { return false; }
+      bool fixedSize (int, int) const { return true; }
+      template<class Entity>
+      std::size_t size (const Entity&) const { return 0; }
+      template<class Buffer, class Entity>
+      void gather (Buffer&, const Entity&) const {}
+      template<class Buffer, class Entity>
+      void scatter (Buffer&, const Entity&, std::size_t) {}
+    };
+
+    //! message buffer appending to or reading from a vector, used for the data migration
+    template<class DT>
+    class VectorMessageBuffer {
+    public:
+      VectorMessageBuffer (std::vector<DT>& v, std::size_t pos = 0)
+        : _v(v), _pos(pos)
+      {}
+
+      template<class Y>
+      void write (const Y& data)
+      {
+        static_assert(( std::is_same<DT,Y>::value ), "DataType mismatch");
+        _v.push_back(data);
+      }
+
+      template<class Y>
+      void read (Y& data) const
+      {
+        static_assert(( std::is_same<DT,Y>::value ), "DataType mismatch");
+        data = _v[_pos++];
+      }
+
+    private:
+      std::vector<DT>& _v;
+      mutable std::size_t _pos;
+    };
+
+    /*! append the numbers of data items of the entities of an intersection to a message
+
+       The sizes are stored as 32 bit words. If this is shorter, they are run
+       length encoded: the number of runs followed by pairs of length and size,
+       which is three words for uniform sizes. Otherwise a marker is followed
+       by one word per entity. The header is padded to the given alignment.
+     */
+    static void encodeSizes (const std::vector<std::size_t>& sizes, std::size_t alignment, std::vector<char>& buf)
+    {
+      std::vector<std::uint32_t> runs;
+      for (std::size_t k=0; k<sizes.size(); k++)
+      {
+        if (sizes[k] > std::numeric_limits<std::uint32_t>::max())
+          DUNE_THROW(GridError, "YaspGrid can not communicate " << sizes[k] << " data items for one entity");
+        if (!runs.empty() && runs.back() == sizes[k])
+          runs[runs.size()-2]++;
+        else
+        {
+          runs.push_back(1);
+          runs.push_back(sizes[k]);
+        }
+      }
+
+      std::vector<std::uint32_t> words;
+      if (runs.size() < sizes.size())
+      {
+        words.push_back(runs.size()/2);
+        words.insert(words.end(), runs.begin(), runs.end());
+      }
+      else
+      {
+        words.push_back(std::numeric_limits<std::uint32_t>::max());
+        words.insert(words.end(), sizes.begin(), sizes.end());
+      }
+
+      const char* p = reinterpret_cast<const char*>(words.data());
+      buf.insert(buf.end(), p, p+words.size()*sizeof(std::uint32_t));
+      buf.resize((buf.size()+alignment-1)/alignment*alignment);
+    }
+
+    //! read the sizes of n entities written by encodeSizes() at position pos, returns the position after the header
+    static std::size_t decodeSizes (const std::vector<char>& buf, std::size_t pos, std::size_t n, std::size_t alignment,
+                                    std::vector<std::size_t>& sizes)
+    {
+      auto word = [&](){
+        std::uint32_t w;
+        std::copy(buf.begin()+pos, buf.begin()+pos+sizeof(w), reinterpret_cast<char*>(&w));
+        pos += sizeof(w);
+        return w;
+      };
+
+      sizes.clear();
+      sizes.reserve(n);
+      const std::uint32_t runs = word();
+      if (runs == std::numeric_limits<std::uint32_t>::max())
+        for (std::size_t k=0; k<n; k++)
+          sizes.push_back(word());
+      else
+        for (std::uint32_t r=0; r<runs; r++)
+        {
+          const std::uint32_t length = word();
+          sizes.insert(sizes.end(), length, word());
+        }
+      return (pos+alignment-1)/alignment*alignment;
+    }
+
+    /*! communicate variable size data for one codim in a single exchange
+
+       The sizes of the entities precede the data in the same message as a
+       compact header, see encodeSizes(). The receiver takes the length of the
+       message from the message itself, so no separate exchange of the sizes
+       is needed.
+     */
+    template<class DataHandle, int codim>
+    void communicateCodimVariable (DataHandle& data, YGridLevelIterator g,
+                                   const YGridList<Coordinates>& sendlist, const YGridList<Coordinates>& recvlist) const
+    {
+      typedef typename DataHandle::DataType DataType;
+      typedef typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator Iterator;
+      typedef typename YGridList<Coordinates>::Iterator ListIt;
+
+      // fill the messages, the header is padded such that the data is aligned
+      std::vector<std::vector<char> > sends(sendlist.size());
+      std::vector<std::size_t> sizes;
+      int cnt=0;
+      for (ListIt is=sendlist.begin(); is!=sendlist.end(); ++is, ++cnt)
+      {
+        Iterator it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
+        Iterator itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg,true)));
+        sizes.clear();
+        std::size_t n = 0;
+        for (Iterator jt=it; jt!=itend; ++jt)
+        {
+          sizes.push_back(data.size(*jt));
+          n += sizes.back();
+        }
+
+        std::vector<char>& buf = sends[cnt];
+        encodeSizes(sizes,alignof(DataType),buf);
+        const std::size_t header = buf.size();
+        buf.resize(header + n*sizeof(DataType));
+        MessageBuffer<DataType> mb(reinterpret_cast<DataType*>(buf.data()+header));
+        for ( ; it!=itend; ++it)
+          data.gather(mb,*it);
+
+        torus().send(is->rank,buf.data(),buf.size());
+      }
+
+      // the receive buffers are sized by the torus
+      std::vector<std::vector<char> > recvs(recvlist.size());
+      cnt=0;
+      for (ListIt is=recvlist.begin(); is!=recvlist.end(); ++is, ++cnt)
+        torus().recv(is->rank,recvs[cnt]);
+
+      torus().exchange();
+
+      cnt=0;
+      for (ListIt is=recvlist.begin(); is!=recvlist.end(); ++is, ++cnt)
+      {
+        const std::size_t header = decodeSizes(recvs[cnt],0,is->grid.totalsize(),alignof(DataType),sizes);
+        MessageBuffer<DataType> mb(reinterpret_cast<DataType*>(recvs[cnt].data()+header));
+        Iterator it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
+        Iterator itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg,true)));
+        for (int i=0; it!=itend; ++it)
+          data.scatter(mb,*it,sizes[i++]);
+      }
+    }
+
+    //! message buffer appending to or reading from a vector of bytes, used for the fused communication
+    template<class DT>
+    class ByteMessageBuffer {
+    public:
+      ByteMessageBuffer (std::vector<char>& v, std::size_t& pos)
+        : _v(v), _pos(pos)
+      {}
+
+      template<class Y>
+      void write (const Y& data)
+      {
+        static_assert(( std::is_same<DT,Y>::value ), "DataType mismatch");
+        const char* p = reinterpret_cast<const char*>(&data);
+        _v.insert(_v.end(), p, p+sizeof(Y));
+      }
+
+      template<class Y>
+      void read (Y& data) const
+      {
+        static_assert(( std::is_same<DT,Y>::value ), "DataType mismatch");
+        std::copy(_v.begin()+_pos, _v.begin()+_pos+sizeof(Y), reinterpret_cast<char*>(&data));
+        _pos += sizeof(Y);
+      }
+
+    private:
+      std::vector<char>& _v;
+      std::size_t& _pos;
+    };
+
+    //! the messages of a fused communication, one per neighbor
+    struct FusedMessages
+    {
+      //! the message to each rank
+      std::map<int,std::vector<char> > send;
+      //! the message from each rank
+      std::map<int,std::vector<char> > recv;
+      //! the size in bytes of the message from each rank
+      std::map<int,std::size_t> recvSize;
+      //! the read position in the message from each rank
+      std::map<int,std::size_t> position;
+      //! true if some data has variable size, the receivers do not know the message sizes then
+      bool variable = false;
+    };
+
+    /*! pack the data of one handle and codim into the messages of a fused communication
+
+       The data of the intersections is appended to the message to their rank
+       in the order of the send list. For variable size data the sizes of the
+       entities precede the data of an intersection, see encodeSizes().
+     */
+    template<class DataHandle, int codim>
+    void fusedGatherCodim (DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, FusedMessages& m) const
+    {
+      typedef typename DataHandle::DataType DataType;
+      typedef typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator Iterator;
+      typedef typename YGridList<Coordinates>::Iterator ListIt;
+
+      // communicated separately
+      if (!std::is_trivially_copyable<DataType>::value) return;
+
+      YGridLevelIterator g = begin(level);
+      const YGridList<Coordinates>* sendlist = 0;
+      const YGridList<Coordinates>* recvlist = 0;
+      interfaceLists(g,codim,iftype,dir,sendlist,recvlist);
+
+      const bool fixed = data.fixedSize(dim,codim);
+      m.variable = m.variable || !fixed;
+
+      for (ListIt is=sendlist->begin(); is!=sendlist->end(); ++is)
+      {
+        std::vector<char>& buf = m.send[is->rank];
+        std::size_t pos = 0;
+        Iterator it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
+        Iterator itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg,true)));
+        if (!fixed)
+        {
+          std::vector<std::size_t> sizes;
+          for (Iterator jt=it; jt!=itend; ++jt)
+            sizes.push_back(data.size(*jt));
+          encodeSizes(sizes,1,buf);
+        }
+        ByteMessageBuffer<DataType> mb(buf,pos);
+        for ( ; it!=itend; ++it)
+          data.gather(mb,*it);
+      }
+
+      for (ListIt is=recvlist->begin(); is!=recvlist->end(); ++is)
+      {
+        std::size_t& size = m.recvSize[is->rank];
+        if (fixed)
+        {
+          Iterator it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
+          size += is->grid.totalsize() * data.size(*it) * sizeof(DataType);
+        }
+      }
+    }
+
+    //! unpack the data of one handle and codim from the messages of a fused communication
+    template<class DataHandle, int codim>
+    void fusedScatterCodim (DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level, FusedMessages& m) const
+    {
+      typedef typename DataHandle::DataType DataType;
+      typedef typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator Iterator;
+      typedef typename YGridList<Coordinates>::Iterator ListIt;
+
+      if (!std::is_trivially_copyable<DataType>::value) return;
+
+      YGridLevelIterator g = begin(level);
+      const YGridList<Coordinates>* sendlist = 0;
+      const YGridList<Coordinates>* recvlist = 0;
+      interfaceLists(g,codim,iftype,dir,sendlist,recvlist);
+
+      for (ListIt is=recvlist->begin(); is!=recvlist->end(); ++is)
+      {
+        std::vector<char>& buf = m.recv[is->rank];
+        std::size_t& pos = m.position[is->rank];
+        Iterator it(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg)));
+        Iterator itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, typename YGrid::Iterator(is->yg,true)));
+        if (data.fixedSize(dim,codim))
+        {
+          ByteMessageBuffer<DataType> mb(buf,pos);
+          const std::size_t n = data.size(*it);
+          for ( ; it!=itend; ++it)
+            data.scatter(mb,*it,n);
+        }
+        else
+        {
+          std::vector<std::size_t> n;
+          pos = decodeSizes(buf,pos,is->grid.totalsize(),1,n);
+          ByteMessageBuffer<DataType> mb(buf,pos);
+          for (int i=0; it!=itend; ++it)
+            data.scatter(mb,*it,n[i++]);
+        }
+      }
+    }
+
+    //! identifies an entity independent of the partition: level, shift and coordinates with periodic ones wrapped
+    typedef std::array<int,dim+2> MigrationKey;
+
+    //! the data to be migrated during repartition()
+    template<class DataType>
+    struct Migration
+    {
+      Migration (const Torus<CollectiveCommunicationType,dim>& t)
+        : torus(t), headers(t.procs()), data(t.procs())
+      {}
+
+      //! the new torus
+      const Torus<CollectiveCommunicationType,dim>& torus;
+      //! per destination the key and number of data items of each entity
+      std::vector<std::vector<int> > headers;
+      //! per destination the data of the entities
+      std::vector<std::vector<DataType> > data;
+      //! all received data
+      std::vector<DataType> received;
+      //! position and number of the received data items of each entity
+      std::map<MigrationKey, std::pair<std::size_t,std::size_t> > entries;
+    };
+
+    //! true if the given torus partitions the grid like the current one
+    bool samePartition (const Torus<CollectiveCommunicationType,dim>& torus) const
+    {
+      if (torus.dims() != _torus.dims())
+        return false;
+      for (int i=0; i<dim; i++)
+        if (torus.offsets(i) != _torus.offsets(i))
+          return false;
+      for (int r=0; r<torus.procs(); r++)
+        if (torus.rank_to_coord(r) != _torus.rank_to_coord(r))
+          return false;
+      return true;
+    }
+
+    //! coarse coordinates of this process for a new partition
+    EquidistantCoordinates<ctype,dim> coarseCoordinates (const EquidistantCoordinates<ctype,dim>& coords,
+                                                         const iTupel& o_interior, const iTupel& s_interior) const
+    {
+      Dune::FieldVector<ctype,dim> h;
+      for (int i=0; i<dim; i++)
+        h[i] = coords.meshsize(i,0);
+      return EquidistantCoordinates<ctype,dim>(h,coarseOverlapSize(o_interior,s_interior));
+    }
+
+    //! coarse coordinates of this process for a new partition
+    EquidistantOffsetCoordinates<ctype,dim> coarseCoordinates (const EquidistantOffsetCoordinates<ctype,dim>& coords,
+                                                               const iTupel& o_interior, const iTupel& s_interior) const
+    {
+      Dune::FieldVector<ctype,dim> lowerleft, h;
+      for (int i=0; i<dim; i++)
+      {
+        lowerleft[i] = coords.origin(i);
+        h[i] = coords.meshsize(i,0);
+      }
+      return EquidistantOffsetCoordinates<ctype,dim>(lowerleft,h,coarseOverlapSize(o_interior,s_interior));
+    }
+
+    //! coarse coordinates of this process for a new partition, the global coordinate vectors are assembled first
+    TensorProductCoordinates<ctype,dim> coarseCoordinates (const TensorProductCoordinates<ctype,dim>& coords,
+                                                           const iTupel& o_interior, const iTupel& s_interior) const
+    {
+      iTupel o, o_old, s_old;
+      std::fill(o.begin(), o.end(), 0);
+      _torus.partition(_torus.rank(),o,_coarseSize,o_old,s_old);
+
+      std::array<std::vector<ctype>,dim> global;
+      for (int i=0; i<dim; i++)
+      {
+        // every process contributes the coordinates of its interior
+        std::vector<ctype> local(s_old[i]+1);
+        for (int k=0; k<=s_old[i]; k++)
+          local[k] = coords.coordinate(i,o_old[i]+k);
+
+        int n = local.size();
+        std::vector<int> counts(_torus.procs()), origins(_torus.procs()), displ(_torus.procs(),0);
+        ccobj.allgather(&n,1,counts.data());
+        ccobj.allgather(&o_old[i],1,origins.data());
+        for (int r=1; r<_torus.procs(); r++)
+          displ[r] = displ[r-1] + counts[r-1];
+        std::vector<ctype> all(displ.back()+counts.back());
+        ccobj.allgatherv(local.data(),n,all.data(),counts.data(),displ.data());
+
+        global[i].resize(_coarseSize[i]+1);
+        for (int r=0; r<_torus.procs(); r++)
+          std::copy(all.begin()+displ[r], all.begin()+displ[r]+counts[r], global[i].begin()+origins[r]);
+      }
+
+      return tensorCoordinates(global,o_interior,s_interior);
+    }
+
+    //! compute the key of an entity, returns false if it is a periodic copy of another entity
+    template<class Entity>
+    bool migrationKey (const Entity& e, int level, MigrationKey& key) const
+    {
+      const typename YGrid::Iterator& it = this->getRealImplementation(e).transformingsubiterator();
+      key[0] = level;
+      key[1] = it.shift().to_ulong();
+      bool unique = true;
+      for (int i=0; i<dim; i++)
+      {
+        int c = it.coord(i);
+        if (_periodic[i])
+        {
+          int n = levelSize(level,i);
+          c = ((c%n)+n)%n;
+        }
+        unique = unique && (c == it.coord(i));
+        key[i+2] = c;
+      }
+      return unique;
+    }
+
+    //! the rows of processes in direction i of a torus whose partition including overlap contains the entity
+    void migrationRows (const Torus<CollectiveCommunicationType,dim>& torus, int i, int level, int overlap,
+                        int c, bool shift, std::vector<int>& rows) const
+    {
+      const std::vector<int>& offsets = torus.offsets(i);
+      const int n = levelSize(level,i);
+      rows.clear();
+      for (int k=0; k<torus.dims(i); k++)
+      {
+        int lower = (offsets[k] << level) - overlap;
+        int upper = (offsets[k+1] << level) + overlap;
+        if (!_periodic[i])
+        {
+          lower = std::max(lower,0);
+          upper = std::min(upper,n);
+        }
+        for (int p=(_periodic[i] ? -1 : 0); p<=(_periodic[i] ? 1 : 0); p++)
+          if (lower <= c+p*n && c+p*n+shift <= upper)
+          {
+            rows.push_back(k);
+            break;
+          }
+      }
+    }
+
+    //! gather the data of the entities owned by this process and sort it by destination
+    template<class DataHandle, int codim>
+    void migrateGatherCodim (DataHandle& data, Migration<typename DataHandle::DataType>& m) const
+    {
+      typedef typename DataHandle::DataType DataType;
+      typedef typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator LevelIterator;
+
+      std::vector<DataType> buffer;
+      std::array<std::vector<int>,dim> rows;
+      for (YGridLevelIterator g=begin(); g!=end(); ++g)
+      {
+        LevelIterator it(YaspLevelIterator<codim,All_Partition,GridImp>(g, g->interiorborder[codim].begin()));
+        LevelIterator itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, g->interiorborder[codim].end()));
+        for ( ; it!=itend; ++it)
+        {
+          MigrationKey key;
+          if (!migrationKey(*it,g->level(),key))
+            continue;
+
+          // border entities are sent by the process owning the cell above them
+          iTupel coord;
+          for (int i=0; i<dim; i++)
+          {
+            int cell = key[i+2];
+            if (!(key[1] & (1<<i)))
+              cell = std::min(cell, levelSize(g->level(),i)-1);
+            const std::vector<int>& offsets = _torus.offsets(i);
+            coord[i] = std::upper_bound(offsets.begin(), offsets.end(), cell >> g->level()) - offsets.begin() - 1;
+          }
+          if (_torus.coord_to_rank(coord) != _torus.rank())
+            continue;
+
+          buffer.clear();
+          VectorMessageBuffer<DataType> mb(buffer);
+          data.gather(mb,*it);
+
+          for (int i=0; i<dim; i++)
+            migrationRows(m.torus,i,g->level(),g->overlapSize,key[i+2],key[1] & (1<<i),rows[i]);
+
+          // send to all processes in the tensor product of the rows
+          std::fill(coord.begin(), coord.end(), 0);
+          for (int i=0; i<dim; )
+          {
+            iTupel dest;
+            for (int j=0; j<dim; j++)
+              dest[j] = rows[j][coord[j]];
+            int rank = m.torus.coord_to_rank(dest);
+            m.headers[rank].insert(m.headers[rank].end(), key.begin(), key.end());
+            m.headers[rank].push_back(buffer.size());
+            m.data[rank].insert(m.data[rank].end(), buffer.begin(), buffer.end());
+
+            for (i=0; i<dim; i++)
+            {
+              if (++coord[i] < int(rows[i].size()))
+                break;
+              coord[i] = 0;
+            }
+          }
+        }
+      }
+    }
+
+    //! scatter the migrated data on all entities of this process
+    template<class DataHandle, int codim>
+    void migrateScatterCodim (DataHandle& data, Migration<typename DataHandle::DataType>& m) const
+    {
+      typedef typename DataHandle::DataType DataType;
+      typedef typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator LevelIterator;
+
+      for (YGridLevelIterator g=begin(); g!=end(); ++g)
+      {
+        LevelIterator it(YaspLevelIterator<codim,All_Partition,GridImp>(g, g->overlapfront[codim].begin()));
+        LevelIterator itend(YaspLevelIterator<codim,All_Partition,GridImp>(g, g->overlapfront[codim].end()));
+        for ( ; it!=itend; ++it)
+        {
+          MigrationKey key;
+          migrationKey(*it,g->level(),key);
+          typename std::map<MigrationKey, std::pair<std::size_t,std::size_t> >::const_iterator entry = m.entries.find(key);
+          if (entry == m.entries.end())
+            DUNE_THROW(GridError, "YaspGrid: no data has been migrated for an entity on level " << g->level());
+          VectorMessageBuffer<DataType> mb(m.received, entry->second.first);
+          data.scatter(mb,*it,entry->second.second);
+        }
+      }
+    }
+
+    //! send the gathered data to the new processes and index the received data
+    template<class DataType>
+    void migrationExchange (Migration<DataType>& m) const
+    {
+      std::vector<int> headers;
+#if HAVE_MPI
+      const int P = _torus.procs();
+
+      // number of header entries and bytes for each process
+      std::vector<int> sendcounts(2*P), recvcounts(2*P);
+      for (int r=0; r<P; r++)
+      {
+        sendcounts[2*r] = m.headers[r].size();
+        sendcounts[2*r+1] = m.data[r].size()*sizeof(DataType);
+      }
+      MPI_Alltoall(sendcounts.data(), 2, MPI_INT, recvcounts.data(), 2, MPI_INT, ccobj);
+
+      std::vector<int> hsend, hcounts(P), hdispl(P), hrcounts(P), hrdispl(P);
+      std::vector<DataType> dsend;
+      std::vector<int> dcounts(P), ddispl(P), drcounts(P), drdispl(P);
+      int hr = 0, dr = 0;
+      for (int r=0; r<P; r++)
+      {
+        hdispl[r] = hsend.size();
+        hcounts[r] = sendcounts[2*r];
+        hsend.insert(hsend.end(), m.headers[r].begin(), m.headers[r].end());
+        ddispl[r] = dsend.size()*sizeof(DataType);
+        dcounts[r] = sendcounts[2*r+1];
+        dsend.insert(dsend.end(), m.data[r].begin(), m.data[r].end());
+
+        hrdispl[r] = hr;
+        hrcounts[r] = recvcounts[2*r];
+        hr += hrcounts[r];
+        drdispl[r] = dr;
+        drcounts[r] = recvcounts[2*r+1];
+        dr += drcounts[r];
+      }
+
+      headers.resize(hr);
+      m.received.resize(dr/sizeof(DataType));
+      MPI_Alltoallv(hsend.data(), hcounts.data(), hdispl.data(), MPI_INT,
+                    headers.data(), hrcounts.data(), hrdispl.data(), MPI_INT, ccobj);
+      MPI_Alltoallv(dsend.data(), dcounts.data(), ddispl.data(), MPI_BYTE,
+                    m.received.data(), drcounts.data(), drdispl.data(), MPI_BYTE, ccobj);
+#else
+      headers.swap(m.headers[0]);
+      m.received.swap(m.data[0]);
+#endif
+      m.headers.clear();
+      m.data.clear();
+
+      // the data of all sources is stored in the order of the headers
+      std::size_t pos = 0;
+      for (std::size_t h=0; h<headers.size(); h+=dim+3)
+      {
+        MigrationKey key;
+        std::copy(headers.begin()+h, headers.begin()+h+dim+2, key.begin());
+        m.entries[key] = std::make_pair(pos, std::size_t(headers[h+dim+2]));
+        pos += headers[h+dim+2];
+      }
+    }
+
+  public:
+
+    // The new index sets from DDM 11.07.2005
+    const typename Traits::GlobalIdSet& globalIdSet() const
+    {
+      return theglobalidset;
+    }
+
+    const typename Traits::LocalIdSet& localIdSet() const
+    {
+      return theglobalidset;
+    }
+
+    const typename Traits::LevelIndexSet& levelIndexSet(int level) const
+    {
+      if (level<0 || level>maxLevel()) DUNE_THROW(RangeError, "level out of range");
+      return *(indexsets[level]);
+    }
+
+    const typename Traits::LeafIndexSet& leafIndexSet() const
+    {
+      return leafIndexSet_;
+    }
+
+    /*! @brief return a collective communication object
+     */
+    const CollectiveCommunicationType& comm () const
+    {
+      return ccobj;
+    }
+
+  private:
+
+    // number of boundary segments of the level 0 grid
+    int nBSegments;
+
+    // Index classes need access to the real entity
+    friend class Dune::YaspIndexSet<const Dune::YaspGrid<dim, Coordinates>, true >;
+    friend class Dune::YaspIndexSet<const Dune::YaspGrid<dim, Coordinates>, false >;
+    friend class Dune::YaspGlobalIdSet<const Dune::YaspGrid<dim, Coordinates> >;
+    friend class Dune::YaspPersistentContainerIndex<const Dune::YaspGrid<dim, Coordinates> >;
+
+    friend class Dune::YaspIntersectionIterator<const Dune::YaspGrid<dim, Coordinates> >;
+    friend class Dune::YaspIntersection<const Dune::YaspGrid<dim, Coordinates> >;
+    friend class Dune::YaspEntity<0, dim, const Dune::YaspGrid<dim, Coordinates> >;
+
+    template<int codim_, int dim_, class GridImp_, template<int,int,class> class EntityImp_>
+    friend class Entity;
+
+    template<class DT>
+    class MessageBuffer {
+    public:
+      // Constructor
+      MessageBuffer (DT *p)
+      {
+        a=p;
+        i=0;
+        j=0;
+      }
+
+      // write data to message buffer, acts like a stream !
+      template<class Y>
+      void write (const Y& data)
+      {
+        static_assert(( std::is_same<DT,Y>::value ), "DataType mismatch");
+        a[i++] = data;
+      }
+
+      // read data from message buffer, acts like a stream !
+      template<class Y>
+      void read (Y& data) const
+      {
+        static_assert(( std::is_same<DT,Y>::value ), "DataType mismatch");
+        data = a[j++];
+      }
+
+    private:
+      DT *a;
+      int i;
+      mutable int j;
+    };
+
+    //! the entities of codim cd traversed for a partition, for Ghost_Partition a superset
+    const YGrid& partitionGrid (YGridLevelIterator g, int cd, PartitionIteratorType pitype) const
+    {
+      if (pitype==Interior_Partition)
+        return g->interior[cd];
+      // with a ghost halo the overlap partitions consist of the interior and border entities
+      if (pitype==InteriorBorder_Partition || (g->ghosts && pitype!=All_Partition && pitype!=Ghost_Partition))
+        return g->interiorborder[cd];
+      if (pitype==Overlap_Partition)
+        return g->overlap[cd];
+      return g->overlapfront[cd];
+    }
+
+    //! one past the end on this level
+    template<int cd, PartitionIteratorType pitype>
+    YaspLevelIterator<cd,pitype,GridImp> levelbegin (int level) const
+    {
+      YGridLevelIterator g = begin(level);
+      if (level<0 || level>maxLevel()) DUNE_THROW(RangeError, "level out of range");
+
+      if (pitype==Ghost_Partition && !g->ghosts)
+        return levelend <cd, pitype> (level);
+
+      // the ghosts are the entities of the halo that are neither interior nor border entities
+      const YGrid& yg = partitionGrid(g,cd,pitype);
+      const YGrid* exclude = (pitype==Ghost_Partition) ? &g->interiorborder[cd] : 0;
+
+      // traverse cells and vertices in the order of the index sets
+      const std::vector<int>* curve = g->curveOrder(cd);
+
+      if (curve || exclude)
+        return YaspLevelIterator<cd,pitype,GridImp>(g,yg,exclude,curve);
+      return YaspLevelIterator<cd,pitype,GridImp>(g,yg.begin());
+    }
+
+    //! Iterator to one past the last entity of given codim on level for partition type
+    template<int cd, PartitionIteratorType pitype>
+    YaspLevelIterator<cd,pitype,GridImp> levelend (int level) const
+    {
+      YGridLevelIterator g = begin(level);
+      if (level<0 || level>maxLevel()) DUNE_THROW(RangeError, "level out of range");
+
+      return YaspLevelIterator<cd,pitype,GridImp>(g,partitionGrid(g,cd,pitype).end());
+    }
+
+    //! number of entities with the given shift on level l of the global grid
+    GlobalIndexType globalComponentCount (int l, const std::bitset<dim>& shift) const
+    {
+      GlobalIndexType count = 1;
+      for (int i=0; i<dim; i++)
+        count *= (shift[i] || _periodic[i]) ? levelSize(l,i) : levelSize(l,i)+1;
+      return count;
+    }
+
+    CollectiveCommunicationType ccobj;
+
+    Torus<CollectiveCommunicationType,dim> _torus;
+    std::shared_ptr<const YLoadBalance<dim> > _lb;
+    YaspOrdering _ordering;
+    YaspHalo _halo;
+    int _threads;
+
+    std::vector< std::shared_ptr< YaspIndexSet<const YaspGrid<dim,Coordinates>, false > > > indexsets;
     YaspIndexSet<const YaspGrid<dim,Coordinates>, true> leafIndexSet_;
     YaspGlobalIdSet<const YaspGrid<dim,Coordinates> > theglobalidset;
 
@@ -1703,8 +3167,10 @@ namespace Dune {
     bool adaptActive;
   };
 
-  //! Output operator for multigrids
-
+  /** \brief Output operator for multigrids
+   *
+   *  Interface lists that have not been built yet by a communication are printed as not built.
+   */
   template <int d, class CC>
   std::ostream& operator<< (std::ostream& s, const YaspGrid<d,CC>& grid)
   {
@@ -1728,46 +3194,33 @@ namespace Dune {
         s << "[" << rank << "]:   " << "interiorborder[" << codim << "]:    " << g->interiorborder[codim] << std::endl;
         s << "[" << rank << "]:   " << "interior[" << codim << "]:    " << g->interior[codim] << std::endl;
 
+        // the lists of an interface are built on its first use, building them here would communicate
         typedef typename YGridList<CC>::Iterator I;
-        for (I i=g->send_overlapfront_overlapfront[codim].begin();
-                 i!=g->send_overlapfront_overlapfront[codim].end(); ++i)
-          s << "[" << rank << "]:    " << " s_of_of[" << codim << "] to rank "
-                   << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->recv_overlapfront_overlapfront[codim].begin();
-                 i!=g->recv_overlapfront_overlapfront[codim].end(); ++i)
-          s << "[" << rank << "]:    " << " r_of_of[" << codim << "] to rank "
-                   << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->send_overlap_overlapfront[codim].begin();
-                 i!=g->send_overlap_overlapfront[codim].end(); ++i)
-          s << "[" << rank << "]:    " << " s_o_of[" << codim << "] to rank "
-                   << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->recv_overlapfront_overlap[codim].begin();
-                 i!=g->recv_overlapfront_overlap[codim].end(); ++i)
-          s << "[" << rank << "]:    " << " r_of_o[" << codim << "] to rank "
-                   << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->send_interiorborder_interiorborder[codim].begin();
-                 i!=g->send_interiorborder_interiorborder[codim].end(); ++i)
-          s << "[" << rank << "]:    " << " s_ib_ib[" << codim << "] to rank "
-          << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->recv_interiorborder_interiorborder[codim].begin();
-                 i!=g->recv_interiorborder_interiorborder[codim].end(); ++i)
-             s << "[" << rank << "]:    " << " r_ib_ib[" << codim << "] to rank "
-             << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->send_interiorborder_overlapfront[codim].begin();
-                 i!=g->send_interiorborder_overlapfront[codim].end(); ++i)
-             s << "[" << rank << "]:    " << " s_ib_of[" << codim << "] to rank "
-             << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->recv_overlapfront_interiorborder[codim].begin();
-                 i!=g->recv_overlapfront_interiorborder[codim].end(); ++i)
-             s << "[" << rank << "]:    " << " r_of_ib[" << codim << "] to rank "
-             << i->rank << " " << i->grid << std::endl;
+        auto printLists = [&](int interface, const char* sendname, const YGridList<CC>& sendlist,
+                              const char* recvname, const YGridList<CC>& recvlist)
+        {
+          if (!g->builtInterfaces[codim][interface])
+          {
+            s << "[" << rank << "]:    " << " " << sendname << "[" << codim << "] and "
+              << recvname << "[" << codim << "] not built" << std::endl;
+            return;
+          }
+          for (I i=sendlist.begin(); i!=sendlist.end(); ++i)
+            s << "[" << rank << "]:    " << " " << sendname << "[" << codim << "] to rank "
+              << i->rank << " " << i->grid << std::endl;
+          for (I i=recvlist.begin(); i!=recvlist.end(); ++i)
+            s << "[" << rank << "]:    " << " " << recvname << "[" << codim << "] to rank "
+              << i->rank << " " << i->grid << std::endl;
+        };
+
+        printLists(3, "s_of_of", g->send_overlapfront_overlapfront[codim],
+                   "r_of_of", g->recv_overlapfront_overlapfront[codim]);
+        printLists(2, "s_o_of", g->send_overlap_overlapfront[codim],
+                   "r_of_o", g->recv_overlapfront_overlap[codim]);
+        printLists(0, "s_ib_ib", g->send_interiorborder_interiorborder[codim],
+                   "r_ib_ib", g->recv_interiorborder_interiorborder[codim]);
+        printLists(1, "s_ib_of", g->send_interiorborder_overlapfront[codim],
+                   "r_of_ib", g->recv_overlapfront_interiorborder[codim]);
       }
     }
 
@@ -1855,5 +3308,7 @@ namespace Dune {
 #include <dune/grid/yaspgrid/structuredyaspgridfactory.hh>
 // Include the specialization of the BackupRestoreFacility class for YaspGrid
 #include <dune/grid/yaspgrid/backuprestore.hh>
+// Include the YaspGrid variant with extents known at compile time
+#include <dune/grid/yaspgrid/yaspgridstatic.hh>
 
 #endif
@@ -14,7 +14,7 @@
 
 // bump this version number up if you introduce any changes
 // to the outout format of the YaspGrid BackupRestoreFacility.
-#define YASPGRID_BACKUPRESTORE_FORMAT_VERSION 2
+#define YASPGRID_BACKUPRESTORE_FORMAT_VERSION 4
 
 namespace Dune
 {
@@ -109,7 +109,7 @@ namespace Dune
       stream << "Periodicity: ";
       for (int i=0; i<dim; i++)
         stream << (grid.isPeriodic(i) ? "1 " : "0 ");
-      stream << std::endl << "Overlap: " << grid.overlapSize(0,0) << std::endl;
+      stream << std::endl << "Overlap: " << grid.begin()->overlapSize << std::endl;
       stream << "KeepPhysicalOverlap: ";
       for (typename Grid::YGridLevelIterator i=++grid.begin(); i != grid.end(); ++i)
         stream << (i->keepOverlap ? "1" : "0") << " ";
@@ -118,6 +118,8 @@ namespace Dune
       for (int i=0; i<dim; i++)
         stream << grid.levelSize(0,i) << " ";
       stream << std::endl;
+      stream << "Halo: " << static_cast<int>(grid.halo()) << std::endl;
+      stream << "Ordering: " << static_cast<int>(grid.ordering()) << std::endl;
       stream << "Meshsize: " ;
       for (int i=0; i<dim; i++)
         stream << grid.begin()->coords.meshsize(i,0) << " ";
@@ -185,6 +187,14 @@ namespace Dune
       for (int i=0; i<dim; i++)
         stream >> coarseSize[i];
 
+      int halo;
+      stream >> input;
+      stream >> halo;
+
+      int ordering;
+      stream >> input;
+      stream >> ordering;
+
       Dune::FieldVector<ctype,dim> h;
       stream >>  input;
       for (int i=0; i<dim; i++)
@@ -199,8 +209,12 @@ namespace Dune
         length[i] *= coarseSize[i];
 
       YaspFixedSizePartitioner<dim> lb(torus_dims);
+      YaspGridOptions<dim> options;
+      options.lb = &lb;
+      options.halo = static_cast<YaspHalo>(halo);
+      options.ordering = static_cast<YaspOrdering>(ordering);
 
-      Grid* grid = MaybeHaveOrigin<Coordinates>::createGrid(origin, length, coarseSize, periodic, overlap, comm, &lb);
+      Grid* grid = MaybeHaveOrigin<Coordinates>::createGrid(origin, length, coarseSize, periodic, overlap, comm, options);
 
       for (int i=0; i<refinement; ++i)
       {
@@ -238,6 +252,12 @@ namespace Dune
     /** \copydoc Dune::BackupRestoreFacility::backup(grid,stream)  */
     static void backup ( const Grid &grid, std::ostream &stream )
     {
+      // the restored grid places the per process pieces lexicographically and evenly
+      if (grid.torus().mapping() != TorusMapping::lexicographic)
+        DUNE_THROW(Dune::NotImplemented, "Backup of a tensor product YaspGrid with a node mapping of the ranks");
+      if (!grid.torus().uniform())
+        DUNE_THROW(Dune::NotImplemented, "Backup of a tensor product YaspGrid with a nonuniform partition");
+
       stream << "YaspGrid BackupRestore Format Version: " << YASPGRID_BACKUPRESTORE_FORMAT_VERSION << std::endl;
       stream << "Torus structure: ";
       for (int i=0; i<dim; i++)
@@ -246,7 +266,7 @@ namespace Dune
       stream << "Periodicity: ";
       for (int i=0; i<dim; i++)
         stream << (grid.isPeriodic(i) ? "1 " : "0 ");
-      stream << std::endl << "Overlap: " << grid.overlapSize(0,0) << std::endl;
+      stream << std::endl << "Overlap: " << grid.begin()->overlapSize << std::endl;
       stream << "KeepPhysicalOverlap: ";
       for (typename Grid::YGridLevelIterator i=++grid.begin(); i != grid.end(); ++i)
         stream << (i->keepOverlap ? "1" : "0") << " ";
@@ -255,6 +275,8 @@ namespace Dune
       for (int i=0; i<dim; i++)
         stream << grid.levelSize(0,i) << " ";
       stream << std::endl;
+      stream << "Halo: " << static_cast<int>(grid.halo()) << std::endl;
+      stream << "Ordering: " << static_cast<int>(grid.ordering()) << std::endl;
 
       grid.begin()->coords.print(stream);
     }
@@ -323,6 +345,14 @@ namespace Dune
       for (int i=0; i<dim; i++)
         stream >> coarseSize[i];
 
+      int halo;
+      stream >> input;
+      stream >> halo;
+
+      int ordering;
+      stream >> input;
+      stream >> ordering;
+
       std::array<std::vector<ctype>,dim> coords;
       stream >> input >> input >> input >> input;
       for (int d=0; d<dim; d++)
@@ -341,7 +371,11 @@ namespace Dune
       }
 
       YaspFixedSizePartitioner<dim> lb(torus_dims);
-      Grid* grid = new Grid(coords, periodic, overlap, comm, coarseSize, &lb);
+      YaspGridOptions<dim> options;
+      options.lb = &lb;
+      options.halo = static_cast<YaspHalo>(halo);
+      options.ordering = static_cast<YaspOrdering>(ordering);
+      Grid* grid = new Grid(coords, periodic, overlap, comm, coarseSize, options);
 
       for (int i=0; i<refinement; ++i)
       {
@@ -8,7 +8,11 @@
  *  for already available useful partitioners, like YaspFixedSizePartitioner.
  */
 
+#include<algorithm>
 #include<array>
+#include<cmath>
+#include<cstddef>
+#include<vector>
 
 #include<dune/common/power.hh>
 
@@ -26,6 +30,39 @@ namespace Dune
     typedef std::array<int, d> iTupel;
     virtual ~YLoadBalance() {}
     virtual void loadbalance(const iTupel&, int, iTupel&) const = 0;
+
+    /** \brief Return a copy allocated with new, or nullptr if the partitioner cannot be copied
+     *
+     * YaspGrid keeps such a copy for loadBalance() without arguments. Partitioners
+     * that do not override this method are not kept, and loadBalance() throws a
+     * GridError for them; use YaspGrid::repartition() with the partitioner instead.
+     */
+    virtual YLoadBalance* clone () const
+    {
+      return nullptr;
+    }
+
+    /** \brief Split the cells in each direction into slabs, one per process row
+     *
+     * The default splits as evenly as possible, the last size[i]%dims[i] slabs
+     * get one cell more.
+     *
+     * \param [in] size Number of elements in each coordinate direction, for the entire grid
+     * \param [in] dims Number of processes in each coordinate direction
+     * \param [out] offsets offsets[i][k] is the first cell of slab k in direction i,
+     *                      offsets[i][dims[i]] is size[i]
+     */
+    virtual void split (const iTupel& size, const iTupel& dims, std::array<std::vector<int>, d>& offsets) const
+    {
+      for (int i=0; i<d; i++)
+      {
+        int m = size[i]/dims[i];
+        int r = size[i]%dims[i];
+        offsets[i].resize(dims[i]+1);
+        for (int k=0; k<=dims[i]; k++)
+          offsets[i][k] = k*m + std::max(0, k-(dims[i]-r));
+      }
+    }
   };
 
   /** \brief Implement the default load balance strategy of yaspgrid
@@ -37,6 +74,11 @@ namespace Dune
     typedef std::array<int, d> iTupel;
     virtual ~YLoadBalanceDefault() {}
 
+    virtual YLoadBalanceDefault* clone () const
+    {
+      return new YLoadBalanceDefault(*this);
+    }
+
     /** \brief Distribute a structured grid across a set of processors
      *
      * \param [in] size Number of elements in each coordinate direction, for the entire grid
@@ -95,6 +137,11 @@ namespace Dune
     typedef std::array<int, d> iTupel;
     virtual ~YLoadBalancePowerD() {}
 
+    virtual YLoadBalancePowerD* clone () const
+    {
+      return new YLoadBalancePowerD(*this);
+    }
+
     virtual void loadbalance (const iTupel& size, int P, iTupel& dims) const
     {
       for(int i=1; i<=P; ++i)
@@ -119,6 +166,11 @@ namespace Dune
 
     virtual ~YaspFixedSizePartitioner() {}
 
+    virtual YaspFixedSizePartitioner* clone () const
+    {
+      return new YaspFixedSizePartitioner(*this);
+    }
+
     virtual void loadbalance(const std::array<int,d>&, int P, std::array<int,d>& dims) const
     {
       int prod = 1;
@@ -133,6 +185,239 @@ namespace Dune
     std::array<int,d> _dims;
   };
 
+  /** \brief Partitioner balancing a nonuniform cost per cell
+   *
+   * The cost is given either per cell of the global grid or per slab of cells in
+   * each direction, in which case the cost of a cell is the product of the costs
+   * of its slabs. The process grid keeps the tensor product structure of YaspGrid,
+   * but the slabs get different widths: in each direction the slab boundaries
+   * balance the cost summed over the other directions. Among all factorizations
+   * of the number of processes the one with the smallest maximum cost per process
+   * is chosen.
+   */
+  template<int d>
+  class YaspWeightedPartitioner : public YLoadBalance<d>
+  {
+  public:
+    typedef std::array<int, d> iTupel;
+
+    /** \brief make a partitioner from a cost per cell
+     *
+     * \param size Number of elements in each coordinate direction, for the entire grid
+     * \param cost Cost of each cell, in lexicographic order with direction 0 running fastest
+     */
+    YaspWeightedPartitioner (const iTupel& size, const std::vector<double>& cost)
+      : _size(size), _separable(false)
+    {
+      // prefix sums over all directions, such that the cost of a box needs 2^d entries
+      std::size_t n = 1;
+      for (int i=0; i<d; i++)
+      {
+        _stride[i] = n;
+        n *= size[i]+1;
+      }
+      std::size_t cells = 1;
+      for (int i=0; i<d; i++)
+        cells *= size[i];
+      if (cost.size() != cells)
+        DUNE_THROW(Dune::Exception, "Size of the cost field does not match the grid size");
+
+      _prefix.assign(n, 0.0);
+      for (std::size_t c=0; c<cells; c++)
+      {
+        std::size_t index = 0;
+        std::size_t cc = c;
+        for (int i=0; i<d; i++)
+        {
+          index += (cc%size[i]+1)*_stride[i];
+          cc /= size[i];
+        }
+        _prefix[index] = cost[c];
+      }
+      for (int i=0; i<d; i++)
+        for (std::size_t k=0; k<n; k++)
+          if ((k/_stride[i])%(size[i]+1) > 0)
+            _prefix[k] += _prefix[k-_stride[i]];
+
+      // costs projected onto each direction
+      for (int i=0; i<d; i++)
+      {
+        iTupel lower, upper(size);
+        std::fill(lower.begin(), lower.end(), 0);
+        _slabcost[i].resize(size[i]);
+        for (int k=0; k<size[i]; k++)
+        {
+          lower[i] = k;
+          upper[i] = k+1;
+          _slabcost[i][k] = boxcost(lower, upper);
+        }
+      }
+    }
+
+    /** \brief make a partitioner from a cost per slab in each direction
+     *
+     * \param cost cost[i][k] is the cost of the cells with coordinate k in direction i,
+     *             the cost of a cell is the product over all directions
+     */
+    YaspWeightedPartitioner (const std::array<std::vector<double>, d>& cost)
+      : _slabcost(cost), _separable(true)
+    {
+      for (int i=0; i<d; i++)
+        _size[i] = cost[i].size();
+    }
+
+    virtual ~YaspWeightedPartitioner() {}
+
+    virtual YaspWeightedPartitioner* clone () const
+    {
+      return new YaspWeightedPartitioner(*this);
+    }
+
+    virtual void loadbalance (const iTupel& size, int P, iTupel& dims) const
+    {
+      check(size);
+
+      double opt = 1E100;
+      iTupel trydims;
+      optimize_dims(d-1,P,dims,trydims,opt);
+      if (opt == 1E100)
+        DUNE_THROW(GridError, "Weighted partitioning failed: not enough cells for " << P << " processes");
+    }
+
+    virtual void split (const iTupel& size, const iTupel& dims, std::array<std::vector<int>, d>& offsets) const
+    {
+      check(size);
+      for (int i=0; i<d; i++)
+        split(i, dims[i], offsets[i]);
+    }
+
+    /** \brief return the maximum cost of a process for the given process grid
+     *  divided by the average cost
+     */
+    double imbalance (const iTupel& dims) const
+    {
+      std::array<std::vector<int>, d> offsets;
+      for (int i=0; i<d; i++)
+        split(i, dims[i], offsets[i]);
+
+      double total = 0.0;
+      double maximum = 0.0;
+      int P = 1;
+      for (int i=0; i<d; i++)
+        P *= dims[i];
+      for (int p=0; p<P; p++)
+      {
+        iTupel lower, upper;
+        int pp = p;
+        for (int i=0; i<d; i++)
+        {
+          lower[i] = offsets[i][pp%dims[i]];
+          upper[i] = offsets[i][pp%dims[i]+1];
+          pp /= dims[i];
+        }
+        double c = boxcost(lower, upper);
+        total += c;
+        maximum = std::max(maximum, c);
+      }
+      return (total > 0.0) ? maximum*P/total : 1.0;
+    }
+
+  private:
+    void check (const iTupel& size) const
+    {
+      if (size != _size)
+        DUNE_THROW(GridError, "Grid size does not match the size of the cost field of the partitioner");
+    }
+
+    //! cost of the cells in [lower,upper)
+    double boxcost (const iTupel& lower, const iTupel& upper) const
+    {
+      if (_separable)
+      {
+        double c = 1.0;
+        for (int i=0; i<d; i++)
+        {
+          double s = 0.0;
+          for (int k=lower[i]; k<upper[i]; k++)
+            s += _slabcost[i][k];
+          c *= s;
+        }
+        return c;
+      }
+
+      // inclusion-exclusion over the corners of the box
+      double c = 0.0;
+      for (int corner=0; corner<(1<<d); corner++)
+      {
+        std::size_t index = 0;
+        int sign = 1;
+        for (int i=0; i<d; i++)
+          if (corner & (1<<i))
+            index += upper[i]*_stride[i];
+          else
+          {
+            index += lower[i]*_stride[i];
+            sign = -sign;
+          }
+        c += sign*_prefix[index];
+      }
+      return c;
+    }
+
+    //! split direction i into k slabs of similar cost, each with at least one cell
+    void split (int i, int k, std::vector<int>& offsets) const
+    {
+      int n = _size[i];
+      std::vector<double> prefix(n+1, 0.0);
+      for (int j=0; j<n; j++)
+        prefix[j+1] = prefix[j] + _slabcost[i][j];
+
+      offsets.resize(k+1);
+      offsets[0] = 0;
+      offsets[k] = n;
+      for (int s=1; s<k; s++)
+      {
+        double target = prefix[n]*s/k;
+        int best = offsets[s-1]+1;
+        for (int j=best+1; j<=n-(k-s); j++)
+          if (std::abs(prefix[j]-target) < std::abs(prefix[best]-target))
+            best = j;
+        offsets[s] = best;
+      }
+    }
+
+    void optimize_dims (int i, int P, iTupel& dims, iTupel& trydims, double &opt) const
+    {
+      if (i>0) // test all subdivisions recursively
+      {
+        for (int k=1; k<=P; k++)
+          if (P%k==0 && k<=_size[i])
+          {
+            trydims[i] = k;
+            optimize_dims(i-1,P/k,dims,trydims,opt);
+          }
+        return;
+      }
+
+      // found a possible combination
+      if (P>_size[0])
+        return;
+      trydims[0] = P;
+      double m = imbalance(trydims);
+      if (m<opt)
+      {
+        opt = m;
+        dims = trydims;
+      }
+    }
+
+    iTupel _size;
+    std::array<std::size_t, d> _stride;
+    std::array<std::vector<double>, d> _slabcost;
+    std::vector<double> _prefix;
+    bool _separable;
+  };
+
 }
 
 #endif
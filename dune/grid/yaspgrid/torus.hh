@@ -3,11 +3,18 @@
 #ifndef DUNE_GRID_YASPGRID_TORUS_HH
 #define DUNE_GRID_YASPGRID_TORUS_HH
 
+#include <algorithm>
 #include <array>
 #include <bitset>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <deque>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
 #include <vector>
 
 #if HAVE_MPI
@@ -26,6 +33,34 @@
 namespace Dune
 {
 
+  /** \brief Implementations of the nearest neighbor exchange in Torus
+   *
+   *  - pointToPoint: individual nonblocking sends and receives per message
+   *  - neighborhood: one MPI_Neighbor_alltoallw per exchange on a distributed
+   *    graph communicator built from the neighbor lists, which leaves the
+   *    scheduling of the messages to the MPI library. Requires MPI-3, without
+   *    it pointToPoint is used.
+   *  - sharedMemory: the persistent plans (Torus::CommPlan) place the messages
+   *    to processes on the same node in an MPI-3 shared memory window, from
+   *    which the receiver copies them directly. Only empty messages are used
+   *    for synchronization. Messages to other nodes and Torus::exchange() use
+   *    pointToPoint. The window is allocated once per torus, plans whose
+   *    messages do not fit into the rest of it use pointToPoint as well.
+   *    Requires MPI-3, without it pointToPoint is used.
+   */
+  enum class TorusBackend { pointToPoint, neighborhood, sharedMemory };
+
+  /** \brief Placement of the ranks on the process grid of Torus
+   *
+   *  - lexicographic: rank i gets the i-th coordinate in lexicographic order
+   *  - node: ranks sharing a node (MPI_COMM_TYPE_SHARED) are placed in compact
+   *    sub-boxes of the torus, such that most of the halo traffic stays within
+   *    a node. This requires MPI-3 and the same number of ranks on all nodes,
+   *    with a box shape that divides the torus. Otherwise the lexicographic
+   *    placement is kept.
+   */
+  enum class TorusMapping { lexicographic, node };
+
   /*! Torus provides all the functionality to handle a toroidal communication structure:
 
      - Map a set of processes (given by an MPI communicator) to a torus of dimension d. The "optimal"
@@ -57,6 +92,7 @@ namespace Dune
       int rank;      // process to send to / receive from
       void *buffer;  // buffer to send / receive
       int size;      // size of buffer
+      std::vector<char>* probe; // receive buffer resized to the incoming message, or 0
 #if HAVE_MPI
       MPI_Request request; // used by MPI to handle request
 #else
@@ -71,8 +107,10 @@ namespace Dune
     {}
 
     //! make partitioner from communicator and coarse mesh size
-    Torus (CollectiveCommunication comm, int tag, iTupel size, const YLoadBalance<d>* lb)
-      : _comm(comm), _tag(tag)
+    Torus (CollectiveCommunication comm, int tag, iTupel size, const YLoadBalance<d>* lb,
+           TorusBackend backend = TorusBackend::pointToPoint,
+           TorusMapping mapping = TorusMapping::lexicographic)
+      : _comm(comm), _tag(tag), _backend(backend), _mapping(mapping)
     {
       // determine dimensions
       lb->loadbalance(size, _comm.size(), _dims);
@@ -89,8 +127,25 @@ namespace Dune
       if (inc != _comm.size())
         DUNE_THROW(Dune::Exception, "Communicator size and result of the given load balancer do not match!");
 
+      // determine the slabs of cells per process row
+      _size = size;
+      lb->split(size, _dims, _offsets);
+
+      // place ranks of the same node next to each other
+      if (_mapping==TorusMapping::node)
+        nodemapping(size);
+
       // make full schedule
       proclists();
+
+      // the communication plans use their own communicator
+      plancommunicator();
+
+      // set up the neighborhood or node communicator if requested
+      if (_backend==TorusBackend::neighborhood)
+        neighborhood();
+      if (_backend==TorusBackend::sharedMemory)
+        sharedmemory();
     }
 
     //! return own rank
@@ -129,12 +184,56 @@ namespace Dune
       return _comm;
     }
 
+#if HAVE_MPI
+    //! return the duplicate of the communicator used by the communication plans
+    MPI_Comm plancomm () const
+    {
+      return *_plancomm;
+    }
+#endif
+
+    //! return the implementation used for the nearest neighbor exchange
+    TorusBackend backend () const
+    {
+      return _backend;
+    }
+
+    //! return the placement of the ranks on the torus
+    TorusMapping mapping () const
+    {
+      return _mapping;
+    }
+
+    /** \brief return the fraction of the halo bytes that is exchanged between different nodes
+     *
+     *  The halo is estimated from the sizes of the coarse partition, assuming a
+     *  non-periodic domain. The value is only known for TorusMapping::node and is
+     *  -1 otherwise.
+     *
+     *  \param lexicographic if true, return the fraction of the lexicographic placement
+     *                       for comparison
+     */
+    double internodeHaloFraction (bool lexicographic = false) const
+    {
+      return _internodeHalo[lexicographic ? 0 : 1];
+    }
+
     //! return tag used by torus
     int tag () const
     {
       return _tag;
     }
 
+    /** \brief return a fresh tag for a persistent communication plan
+     *  Plans are created collectively in the same order on all processes,
+     *  so they agree on the tag without communication. The tags are used on
+     *  plancomm(), they do not interfere with messages of the application.
+     */
+    int plantag () const
+    {
+      return _tag + 1 + (_plans++)%16384;
+    }
+
     //! return true if coordinate is inside torus
     bool inside (iTupel c) const
     {
@@ -143,11 +242,13 @@ namespace Dune
       return true;
     }
 
-    //! map rank to coordinate in torus using lexicographic ordering
+    //! map rank to coordinate in torus using lexicographic ordering (up to the node mapping)
     iTupel rank_to_coord (int rank) const
     {
       iTupel coord;
       rank = rank%_comm.size();
+      if (!_position.empty())
+        rank = _position[rank];
       for (int i=d-1; i>=0; i--)
       {
         coord[i] = rank/_increment[i];
@@ -156,13 +257,13 @@ namespace Dune
       return coord;
     }
 
-    //! map coordinate in torus to rank using lexicographic ordering
+    //! map coordinate in torus to rank using lexicographic ordering (up to the node mapping)
     int coord_to_rank (iTupel coord) const
     {
       for (int i=0; i<d; i++) coord[i] = coord[i]%_dims[i];
       int rank = 0;
       for (int i=0; i<d; i++) rank += coord[i]*_increment[i];
-      return rank;
+      return _rankat.empty() ? rank : _rankat[rank];
     }
 
     //! return rank of process where its coordinate in direction dir has offset cnt (handles periodic case)
@@ -232,6 +333,26 @@ namespace Dune
       return true;
     }
 
+    //! return the first coarse cell of each slab of process rows in direction i, followed by the coarse size
+    const std::vector<int>& offsets (int i) const
+    {
+      return _offsets[i];
+    }
+
+    //! return true if the cells of the coarse grid are split evenly among the process rows
+    bool uniform () const
+    {
+      for (int i=0; i<d; i++)
+        for (int k=0; k<=_dims[i]; k++)
+        {
+          int m = _size[i]/_dims[i];
+          int r = _size[i]%_dims[i];
+          if (_offsets[i][k] != k*m + std::max(0, k-(_dims[i]-r)))
+            return false;
+        }
+      return true;
+    }
+
     /** \brief partition the given grid onto the torus and return the piece of the process with given rank; returns load imbalance
      * @param rank rank of our processor
      * @param origin_in global origin
@@ -254,7 +375,14 @@ namespace Dune
 
         sz *= size_in[i];
 
-        if (coord[i]<_dims[i]-r)
+        // the slabs of the load balancer for the grid size given at construction
+        if (size_in[i]==_size[i] && !_offsets[i].empty())
+        {
+          origin_out[i] = origin_in[i] + _offsets[i][coord[i]];
+          size_out[i] = _offsets[i][coord[i]+1] - _offsets[i][coord[i]];
+          maxsize *= size_out[i];
+        }
+        else if (coord[i]<_dims[i]-r)
         {
           origin_out[i] = origin_in[i] + coord[i]*m;
           size_out[i] = m;
@@ -367,6 +495,7 @@ namespace Dune
       task.rank = rank;
       task.buffer = buffer;
       task.size = size;
+      task.probe = 0;
       if (rank!=_comm.rank())
         _sendrequests.push_back(task);
       else
@@ -380,6 +509,27 @@ namespace Dune
       task.rank = rank;
       task.buffer = buffer;
       task.size = size;
+      task.probe = 0;
+      if (rank!=_comm.rank())
+        _recvrequests.push_back(task);
+      else
+        _localrecvrequests.push_back(task);
+    }
+
+    /*! store a receive request for a message of unknown size; the buffer is resized to the message in exchange()
+
+       The size is probed from the arriving message, which saves a separate
+       exchange of the message sizes. Several messages from the same process
+       are matched in order, but within one exchange a process must not be
+       received from with both kinds of receive requests.
+     */
+    void recv (int rank, std::vector<char>& buffer) const
+    {
+      CommTask task;
+      task.rank = rank;
+      task.buffer = 0;
+      task.size = 0;
+      task.probe = &buffer;
       if (rank!=_comm.rank())
         _recvrequests.push_back(task);
       else
@@ -397,6 +547,12 @@ namespace Dune
       }
       for (unsigned int i=0; i<_localsendrequests.size(); i++)
       {
+        if (_localrecvrequests[i].probe)
+        {
+          _localrecvrequests[i].probe->resize(_localsendrequests[i].size);
+          _localrecvrequests[i].buffer = _localrecvrequests[i].probe->data();
+          _localrecvrequests[i].size = _localsendrequests[i].size;
+        }
         if (_localsendrequests[i].size!=_localrecvrequests[i].size)
         {
           std::cout << "[" << rank() << "]: ERROR: size in local sends/receive does not match in exchange!" << std::endl;
@@ -408,6 +564,20 @@ namespace Dune
       _localrecvrequests.clear();
 
 #if HAVE_MPI
+      // receives of unknown size are not possible in the collective
+      bool probing = false;
+      for (unsigned int i=0; i<_recvrequests.size(); i++)
+        probing = probing || _recvrequests[i].probe;
+
+      // one collective for all foreign requests
+      if (_backend==TorusBackend::neighborhood && !probing)
+      {
+        exchangeNeighborhood();
+        _sendrequests.clear();
+        _recvrequests.clear();
+        return;
+      }
+
       // handle foreign requests
       int sends=0;
       int recvs=0;
@@ -426,7 +596,7 @@ namespace Dune
 
       // issue receives from foreign processes
       for (unsigned int i=0; i<_recvrequests.size(); i++)
-        if (_recvrequests[i].rank!=rank())
+        if (_recvrequests[i].rank!=rank() && !_recvrequests[i].probe)
         {
           //          std::cout << "[" << rank() << "]"  << " recv " << _recvrequests[i].size << " bytes "
           //                    << "fm " << _recvrequests[i].rank << " p=" << _recvrequests[i].buffer << std::endl;
@@ -436,6 +606,20 @@ namespace Dune
           recvs++;
         }
 
+      // receive the messages of unknown size in order, all sends are issued already
+      for (unsigned int i=0; i<_recvrequests.size(); i++)
+        if (_recvrequests[i].probe)
+        {
+          MPI_Status status;
+          int count;
+          MPI_Probe(_recvrequests[i].rank, _tag, _comm, &status);
+          MPI_Get_count(&status, MPI_BYTE, &count);
+          _recvrequests[i].probe->resize(count);
+          MPI_Recv(_recvrequests[i].probe->data(), count, MPI_BYTE,
+                   _recvrequests[i].rank, _tag, _comm, MPI_STATUS_IGNORE);
+          _recvrequests[i].flag = true;
+        }
+
       // poll sends
       while (sends>0)
       {
@@ -475,6 +659,680 @@ namespace Dune
 #endif
     }
 
+#if HAVE_MPI && MPI_VERSION >= 3
+    /** \brief bytes of the shared window of each process for the communication plans
+
+       The window is allocated with each torus, so a new size only applies to tori
+       constructed afterwards. The default is 16 MiB.
+     */
+    static MPI_Aint& sharedWindowSize ()
+    {
+      static MPI_Aint size = 1 << 24;
+      return size;
+    }
+
+  private:
+    // the shared window of a torus, the plans reserve their send buffers in it
+    struct SharedWindow
+    {
+      MPI_Win win;
+      char* base;
+      MPI_Aint size;
+      // free ranges of the window of this process, offset to number of bytes
+      std::map<MPI_Aint,MPI_Aint> free;
+
+      // reserve bytes, returns their offset in the window or -1 if they do not fit
+      MPI_Aint allocate (MPI_Aint bytes)
+      {
+        bytes = (bytes + 15)/16*16;
+        for (auto range = free.begin(); range!=free.end(); ++range)
+          if (range->second >= bytes)
+          {
+            const MPI_Aint first = range->first;
+            const MPI_Aint rest = range->second - bytes;
+            free.erase(range);
+            if (rest > 0)
+              free[first + bytes] = rest;
+            return first;
+          }
+
+        static bool warned = false;
+        if (!warned)
+          std::cerr << "Warning: the shared window of " << size << " bytes of the YaspGrid communication plans is full, "
+                    << "messages within the node are sent point-to-point. Increase Torus::sharedWindowSize()." << std::endl;
+        warned = true;
+        return -1;
+      }
+
+      // give reserved bytes back, merging them with the free neighbors
+      void release (MPI_Aint first, MPI_Aint bytes)
+      {
+        bytes = (bytes + 15)/16*16;
+        auto next = free.lower_bound(first);
+        if (next!=free.end() && next->first == first + bytes)
+        {
+          bytes += next->second;
+          next = free.erase(next);
+        }
+        if (next!=free.begin())
+        {
+          auto previous = std::prev(next);
+          if (previous->first + previous->second == first)
+          {
+            previous->second += bytes;
+            return;
+          }
+        }
+        free[first] = bytes;
+      }
+    };
+
+  public:
+#endif
+
+    /*!
+       CommPlan is a persistent variant of the send/recv/exchange mechanism above.
+       The message partners and sizes are registered once, then commit() allocates
+       one buffer per message and (with MPI) sets up persistent requests. Each call
+       to exchange() only starts these requests and waits for them, which avoids
+       any memory allocation when the same pattern is communicated repeatedly.
+
+       The exchange can also be split into start() and a sequence of waitsome()
+       or testsome() calls, which report the receive messages as they arrive.
+
+       Messages are started in the order in which they were registered. As in
+       Torus::exchange() this guarantees that several messages between the same
+       pair of processes (periodic case) are matched correctly. Each plan uses
+       its own tag, such that a plan in flight is not confused with other messages.
+
+       With TorusBackend::sharedMemory the send buffers of messages to processes
+       on the same node live in a shared memory window. start() only sends an
+       empty notification, the receiver copies the data out of the window and
+       acknowledges with another empty message on the node communicator. The
+       plan stays active until all acknowledgements have arrived, so the send
+       buffers may be refilled as soon as the plan is no longer active. The
+       window belongs to the torus, so that plans can be created and destroyed
+       on each process independently of the other processes of the node.
+     */
+    class CommPlan {
+    public:
+      //! make an empty plan for the given torus
+      CommPlan (const Torus& torus)
+        : _torus(&torus), _tag(torus.plantag()), _committed(false), _active(false),
+          _localpending(false), _pending(0)
+      {
+#if HAVE_MPI && MPI_VERSION >= 3
+        _window = MPI_WIN_NULL;
+        _sharedfirst = -1;
+        _sharedbytes = 0;
+#endif
+      }
+
+      //! free the persistent requests and the send buffers in the shared window
+      ~CommPlan ()
+      {
+#if HAVE_MPI
+#if MPI_VERSION >= 3
+        if (_sharedfirst>=0)
+          if (std::shared_ptr<SharedWindow> window = _shared.lock())
+            window->release(_sharedfirst, _sharedbytes);
+#endif
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (!finalized)
+        {
+          for (std::size_t i=0; i<_requests.size(); i++)
+            if (_requests[i]!=MPI_REQUEST_NULL)
+              MPI_Request_free(&_requests[i]);
+          Torus::freeNeighborTypes(_sendcounts, _sendtypes);
+          Torus::freeNeighborTypes(_recvcounts, _recvtypes);
+        }
+#endif
+      }
+
+      //! register a message of size bytes to be sent to rank; returns its index
+      int send (int rank, int size)
+      {
+        assert(!_committed);
+        _sends.push_back(Message(rank,size));
+        return _sends.size()-1;
+      }
+
+      //! register a message of size bytes to be received from rank; returns its index
+      int recv (int rank, int size)
+      {
+        assert(!_committed);
+        _recvs.push_back(Message(rank,size));
+        return _recvs.size()-1;
+      }
+
+      //! allocate the buffers and set up persistent requests for foreign processes
+      void commit ()
+      {
+        int local = 0;
+        for (std::size_t i=0; i<_sends.size(); i++)
+          if (_sends[i].rank==_torus->rank())
+            local++;
+        for (std::size_t i=0; i<_recvs.size(); i++)
+          if (_recvs[i].rank==_torus->rank())
+            local--;
+        if (local!=0)
+          DUNE_THROW(Dune::Exception, "local sends/receives do not match in CommPlan!");
+
+        for (std::size_t i=0; i<_sends.size(); i++)
+          _sends[i].data = _sends[i].buffer.data();
+        for (std::size_t i=0; i<_recvs.size(); i++)
+          _recvs[i].data = _recvs[i].buffer.data();
+
+#if HAVE_MPI
+        if (_torus->backend()==TorusBackend::neighborhood)
+          commitNeighborhood();
+        else if (_torus->backend()==TorusBackend::sharedMemory)
+          commitSharedMemory();
+        else
+          commitPointToPoint();
+        _statuses.resize(_requests.size());
+        _indices.resize(_requests.size());
+#endif
+        _done.reserve(_recvs.size());
+        _committed = true;
+      }
+
+      //! return the number of registered send messages
+      int sends () const
+      {
+        return _sends.size();
+      }
+
+      //! return the number of registered receive messages
+      int recvs () const
+      {
+        return _recvs.size();
+      }
+
+      //! return buffer of send message i
+      void* sendBuffer (int i)
+      {
+        return _sends[i].data;
+      }
+
+      //! return buffer of receive message i
+      void* recvBuffer (int i)
+      {
+        return _recvs[i].data;
+      }
+
+      //! return size in bytes of send message i
+      int sendSize (int i) const
+      {
+        return _sends[i].size;
+      }
+
+      //! return size in bytes of receive message i
+      int recvSize (int i) const
+      {
+        return _recvs[i].size;
+      }
+
+      //! return true if the plan has been started and not all messages are complete
+      bool active () const
+      {
+        return _active;
+      }
+
+      //! start the exchange; local messages are copied immediately
+      void start ()
+      {
+        assert(_committed);
+        if (_active)
+          DUNE_THROW(Dune::InvalidStateException, "CommPlan started while a previous exchange is still in flight!");
+
+        // handle local requests first, they are matched in order
+        std::size_t j = 0;
+        for (std::size_t i=0; i<_sends.size(); i++)
+          if (_sends[i].rank==_torus->rank())
+          {
+            while (_recvs[j].rank!=_torus->rank())
+              j++;
+            if (_sends[i].size!=_recvs[j].size)
+              DUNE_THROW(Dune::Exception, "size in local sends/receive does not match in CommPlan!");
+            memcpy(_recvs[j].data,_sends[i].data,_sends[i].size);
+            j++;
+          }
+        _localpending = true;
+
+#if HAVE_MPI
+#if MPI_VERSION >= 3
+        // make the send buffers in the shared window visible to the other processes
+        if (_window!=MPI_WIN_NULL)
+          MPI_Win_sync(_window);
+#endif
+        // acknowledgements (-3) are only started when their message has been copied
+        _pending = 0;
+#if MPI_VERSION == 3
+        if (_torus->backend()==TorusBackend::neighborhood)
+        {
+          MPI_Ineighbor_alltoallw(MPI_BOTTOM, _sendcounts.data(), _senddispls.data(), _sendtypes.data(),
+                                  MPI_BOTTOM, _recvcounts.data(), _recvdispls.data(), _recvtypes.data(),
+                                  *_torus->_graph, &_requests[0]);
+          _pending = 1;
+        }
+        else
+#endif
+        for (std::size_t i=0; i<_requests.size(); i++)
+          if (_requestrecv[i]!=-3)
+          {
+            MPI_Start(&_requests[i]);
+            _pending++;
+          }
+#endif
+        _active = true;
+      }
+
+      //! wait until all messages are complete
+      void wait ()
+      {
+#if HAVE_MPI
+#if MPI_VERSION >= 3
+        // received shared memory messages have to be copied and acknowledged while waiting
+        if (_window!=MPI_WIN_NULL)
+          while (_pending>0)
+            collect(true);
+#endif
+        if (_pending>0)
+          MPI_Waitall(_requests.size(), _requests.data(), _statuses.data());
+        _pending = 0;
+        _done.clear();
+#endif
+        _localpending = false;
+        _active = false;
+      }
+
+      /** \brief wait until some messages are complete
+       *  \returns the indices of the receive messages that completed since the last call.
+       *  The plan is no longer active once all messages have been reported.
+       */
+      const std::vector<int>& waitsome ()
+      {
+        return some(true);
+      }
+
+      /** \brief like waitsome(), but return immediately if no message is complete
+       */
+      const std::vector<int>& testsome ()
+      {
+        return some(false);
+      }
+
+      //! exchange the contents of the send buffers into the receive buffers
+      void exchange ()
+      {
+        start();
+        wait();
+      }
+
+    private:
+      struct Message {
+        Message (int r, int s)
+          : rank(r), size(s), buffer(s), data(0), peer(0), ack(-1)
+        {}
+        int rank;
+        int size;
+        std::vector<char> buffer;
+        char* data;       // the message, in buffer or in the shared window
+        const char* peer; // shared memory receive: the message in the window of the sender
+        int ack;          // shared memory receive: request acknowledging the copy
+      };
+
+      // a plan owns persistent requests, do not copy it
+      CommPlan (const CommPlan&);
+      CommPlan& operator= (const CommPlan&);
+
+#if HAVE_MPI
+      //! return true if messages with rank are exchanged through shared memory
+      bool shared (int rank) const
+      {
+        return _torus->backend()==TorusBackend::sharedMemory
+               && rank!=_torus->rank() && _torus->noderank(rank)>=0;
+      }
+
+      //! set up one persistent request per foreign message
+      void commitPointToPoint ()
+      {
+        for (std::size_t i=0; i<_sends.size(); i++)
+          if (_sends[i].rank!=_torus->rank() && !shared(_sends[i].rank))
+          {
+            _requests.push_back(MPI_Request());
+            _requestrecv.push_back(-1);
+            MPI_Send_init(_sends[i].buffer.data(), _sends[i].size, MPI_BYTE,
+                          _sends[i].rank, _tag, _torus->plancomm(), &_requests.back());
+          }
+        for (std::size_t i=0; i<_recvs.size(); i++)
+          if (_recvs[i].rank!=_torus->rank() && !shared(_recvs[i].rank))
+          {
+            _requests.push_back(MPI_Request());
+            _requestrecv.push_back(i);
+            MPI_Recv_init(_recvs[i].buffer.data(), _recvs[i].size, MPI_BYTE,
+                          _recvs[i].rank, _tag, _torus->plancomm(), &_requests.back());
+          }
+      }
+
+      /** \brief place the messages to processes on the same node in a shared window
+
+         The send buffers are reserved in the window of the torus, without
+         collective operations, and given back when the plan is destroyed. The offsets of the messages in the window are
+         sent to the receivers once, an offset of -1 tells the receiver that
+         the window is full and the message is sent point-to-point instead.
+         Per exchange each message in the window needs an empty notification on
+         the communicator of the plans and an empty acknowledgement on the node
+         communicator, which are matched in order like the messages themselves.
+       */
+      void commitSharedMemory ()
+      {
+#if MPI_VERSION >= 3
+        MPI_Comm comm = _torus->plancomm();
+        MPI_Comm node = *_torus->_nodecomm;
+        const std::shared_ptr<SharedWindow> window = _torus->_window;
+        _shared = window;
+        _window = window->win;
+
+        MPI_Aint bytes = 0;
+        std::vector<MPI_Aint> sendoffsets(_sends.size(), 0);
+        for (std::size_t i=0; i<_sends.size(); i++)
+          if (shared(_sends[i].rank))
+          {
+            sendoffsets[i] = bytes;
+            bytes += _sends[i].size;
+          }
+
+        const MPI_Aint first = (bytes>0) ? window->allocate(bytes) : 0;
+        if (bytes>0 && first>=0)
+        {
+          _sharedfirst = first;
+          _sharedbytes = bytes;
+        }
+        for (std::size_t i=0; i<_sends.size(); i++)
+          if (shared(_sends[i].rank))
+          {
+            if (first>=0)
+            {
+              sendoffsets[i] += first;
+              _sends[i].data = window->base + sendoffsets[i];
+            }
+            else
+              sendoffsets[i] = -1;
+          }
+
+        // tell the receivers where to find their messages
+        std::vector<MPI_Aint> recvoffsets(_recvs.size(), 0);
+        std::vector<MPI_Request> requests;
+        for (std::size_t i=0; i<_recvs.size(); i++)
+          if (shared(_recvs[i].rank))
+          {
+            requests.push_back(MPI_Request());
+            MPI_Irecv(&recvoffsets[i], 1, MPI_AINT, _recvs[i].rank, _tag, comm, &requests.back());
+          }
+        for (std::size_t i=0; i<_sends.size(); i++)
+          if (shared(_sends[i].rank))
+          {
+            requests.push_back(MPI_Request());
+            MPI_Isend(&sendoffsets[i], 1, MPI_AINT, _sends[i].rank, _tag, comm, &requests.back());
+          }
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+        for (std::size_t i=0; i<_recvs.size(); i++)
+          if (shared(_recvs[i].rank) && recvoffsets[i]>=0)
+          {
+            MPI_Aint size;
+            int unit;
+            char* peerbase;
+            MPI_Win_shared_query(_window, _torus->noderank(_recvs[i].rank), &size, &unit, &peerbase);
+            _recvs[i].peer = peerbase + recvoffsets[i];
+          }
+
+        // notifications and acknowledgements, or the messages themselves if the window is full
+        for (std::size_t i=0; i<_sends.size(); i++)
+          if (shared(_sends[i].rank))
+          {
+            _requests.push_back(MPI_Request());
+            _requestrecv.push_back(-1);
+            if (first<0)
+            {
+              MPI_Send_init(_sends[i].data, _sends[i].size, MPI_BYTE, _sends[i].rank, _tag, comm, &_requests.back());
+              continue;
+            }
+            MPI_Send_init(0, 0, MPI_BYTE, _sends[i].rank, _tag, comm, &_requests.back());
+            _requests.push_back(MPI_Request());
+            _requestrecv.push_back(-1);
+            MPI_Recv_init(0, 0, MPI_BYTE, _torus->noderank(_sends[i].rank), _tag, node, &_requests.back());
+          }
+        for (std::size_t i=0; i<_recvs.size(); i++)
+          if (shared(_recvs[i].rank))
+          {
+            _requests.push_back(MPI_Request());
+            _requestrecv.push_back(i);
+            if (!_recvs[i].peer)
+            {
+              MPI_Recv_init(_recvs[i].data, _recvs[i].size, MPI_BYTE, _recvs[i].rank, _tag, comm, &_requests.back());
+              continue;
+            }
+            MPI_Recv_init(0, 0, MPI_BYTE, _recvs[i].rank, _tag, comm, &_requests.back());
+            _recvs[i].ack = _requests.size();
+            _requests.push_back(MPI_Request());
+            _requestrecv.push_back(-3);
+            MPI_Send_init(0, 0, MPI_BYTE, _torus->noderank(_recvs[i].rank), _tag, node, &_requests.back());
+          }
+#endif
+
+        // messages to other nodes
+        commitPointToPoint();
+      }
+
+      /** \brief describe all foreign messages by one neighborhood collective
+
+         With MPI-4 the collective is persistent, otherwise a nonblocking
+         collective is issued in each start(). Its single request completes all
+         foreign receives at once, this is marked by -2 in _requestrecv.
+       */
+      void commitNeighborhood ()
+      {
+#if MPI_VERSION >= 3
+        auto address = [](Message& m) { return static_cast<void*>(m.buffer.data()); };
+        Torus::neighborTypes(_torus->_destinations, _sends, address, _sendcounts, _sendtypes);
+        Torus::neighborTypes(_torus->_sources, _recvs, address, _recvcounts, _recvtypes);
+        _senddispls.assign(_sendcounts.size(), 0);
+        _recvdispls.assign(_recvcounts.size(), 0);
+        _requests.push_back(MPI_REQUEST_NULL);
+        _requestrecv.push_back(-2);
+#if MPI_VERSION >= 4
+        MPI_Neighbor_alltoallw_init(MPI_BOTTOM, _sendcounts.data(), _senddispls.data(), _sendtypes.data(),
+                                    MPI_BOTTOM, _recvcounts.data(), _recvdispls.data(), _recvtypes.data(),
+                                    *_torus->_graph, MPI_INFO_NULL, &_requests.back());
+#endif
+#endif
+      }
+#endif
+
+      const std::vector<int>& some (bool block)
+      {
+        _done.clear();
+
+        // local messages have been copied in start()
+        if (_localpending)
+        {
+          for (std::size_t i=0; i<_recvs.size(); i++)
+            if (_recvs[i].rank==_torus->rank())
+              _done.push_back(i);
+          _localpending = false;
+        }
+
+#if HAVE_MPI
+        // do not block if there is already something to report
+        if (_done.empty() && block)
+        {
+          // completed sends are not reported, keep waiting until a receive completes
+          while (_done.empty() && _pending>0)
+            collect(true);
+        }
+        else if (_pending>0)
+          collect(false);
+#endif
+
+        if (_pending==0)
+          _active = false;
+        return _done;
+      }
+
+#if HAVE_MPI
+      void collect (bool block)
+      {
+        int outcount = 0;
+        if (block)
+          MPI_Waitsome(_requests.size(), _requests.data(), &outcount, _indices.data(), _statuses.data());
+        else
+          MPI_Testsome(_requests.size(), _requests.data(), &outcount, _indices.data(), _statuses.data());
+        if (outcount==MPI_UNDEFINED)
+        {
+          _pending = 0;
+          return;
+        }
+        _pending -= outcount;
+        for (int k=0; k<outcount; k++)
+          if (_requestrecv[_indices[k]]>=0)
+          {
+            int i = _requestrecv[_indices[k]];
+#if MPI_VERSION >= 3
+            // copy the message out of the window of the sender and release it
+            if (_recvs[i].peer)
+            {
+              MPI_Win_sync(_window);
+              memcpy(_recvs[i].data, _recvs[i].peer, _recvs[i].size);
+              MPI_Start(&_requests[_recvs[i].ack]);
+              _pending++;
+            }
+#endif
+            _done.push_back(i);
+          }
+          else if (_requestrecv[_indices[k]]==-2)
+          {
+            // the neighborhood collective has completed all foreign receives
+            for (std::size_t i=0; i<_recvs.size(); i++)
+              if (_recvs[i].rank!=_torus->rank())
+                _done.push_back(i);
+          }
+      }
+#endif
+
+      const Torus* _torus;
+      int _tag;
+      bool _committed;
+      bool _active;
+      bool _localpending;
+      int _pending;
+      std::vector<Message> _sends;
+      std::vector<Message> _recvs;
+      std::vector<int> _done;
+#if HAVE_MPI
+      std::vector<MPI_Request> _requests;
+      std::vector<int> _requestrecv;
+      std::vector<int> _indices;
+      std::vector<MPI_Status> _statuses;
+      // datatypes of the neighborhood collective, one per neighbor
+      std::vector<int> _sendcounts, _recvcounts;
+      std::vector<MPI_Aint> _senddispls, _recvdispls;
+      std::vector<MPI_Datatype> _sendtypes, _recvtypes;
+#if MPI_VERSION >= 3
+      // window holding the messages to processes on the same node, and the range of this plan in it,
+      // the window is freed collectively with the torus and must not be kept alive by a plan
+      MPI_Win _window;
+      std::weak_ptr<SharedWindow> _shared;
+      MPI_Aint _sharedfirst;
+      MPI_Aint _sharedbytes;
+#endif
+#endif
+    };
+
+#if HAVE_MPI
+    /*!
+       DatatypeExchange sends and receives messages that are described by MPI
+       datatypes relative to a base address given at exchange time. This allows
+       to communicate directly from and into user arrays without intermediate
+       buffers. The exchange takes ownership of the datatypes it is given.
+       As for CommPlan, messages are posted in registration order and the
+       exchange uses its own tag.
+     */
+    class DatatypeExchange {
+    public:
+      //! make an empty exchange for the given torus
+      DatatypeExchange (const Torus& torus)
+        : _torus(&torus), _tag(torus.plantag())
+      {}
+
+      //! free the datatypes
+      ~DatatypeExchange ()
+      {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (!finalized)
+        {
+          for (std::size_t i=0; i<_sends.size(); i++)
+            MPI_Type_free(&_sends[i].type);
+          for (std::size_t i=0; i<_recvs.size(); i++)
+            MPI_Type_free(&_recvs[i].type);
+        }
+      }
+
+      //! register a message to rank with given datatype located at displacement bytes from the base
+      void send (int rank, MPI_Datatype type, std::ptrdiff_t displacement)
+      {
+        MPI_Type_commit(&type);
+        _sends.push_back(Message(rank,type,displacement));
+        _requests.resize(_sends.size()+_recvs.size());
+      }
+
+      //! register a message from rank with given datatype located at displacement bytes from the base
+      void recv (int rank, MPI_Datatype type, std::ptrdiff_t displacement)
+      {
+        MPI_Type_commit(&type);
+        _recvs.push_back(Message(rank,type,displacement));
+        _requests.resize(_sends.size()+_recvs.size());
+      }
+
+      //! exchange the messages; sends read from and receives write into the array at base
+      void exchange (void* base) const
+      {
+        char* p = static_cast<char*>(base);
+        std::size_t k = 0;
+        for (std::size_t i=0; i<_recvs.size(); i++)
+          MPI_Irecv(p+_recvs[i].displacement, 1, _recvs[i].type, _recvs[i].rank, _tag, _torus->plancomm(), &_requests[k++]);
+        for (std::size_t i=0; i<_sends.size(); i++)
+          MPI_Isend(p+_sends[i].displacement, 1, _sends[i].type, _sends[i].rank, _tag, _torus->plancomm(), &_requests[k++]);
+        if (k>0)
+          MPI_Waitall(k, _requests.data(), MPI_STATUSES_IGNORE);
+      }
+
+    private:
+      struct Message {
+        Message (int r, MPI_Datatype t, std::ptrdiff_t disp)
+          : rank(r), type(t), displacement(disp)
+        {}
+        int rank;
+        MPI_Datatype type;
+        std::ptrdiff_t displacement;
+      };
+
+      // an exchange owns datatypes, do not copy it
+      DatatypeExchange (const DatatypeExchange&);
+      DatatypeExchange& operator= (const DatatypeExchange&);
+
+      const Torus* _torus;
+      int _tag;
+      std::vector<Message> _sends;
+      std::vector<Message> _recvs;
+      mutable std::vector<MPI_Request> _requests;
+    };
+#endif
+
     //! global max
     double global_max (double x) const
     {
@@ -487,6 +1345,9 @@ namespace Dune
     void print (std::ostream& s) const
     {
       s << "[" << rank() <<  "]: Torus " << procs() << " processor(s) arranged as " << dims() << std::endl;
+      if (_internodeHalo[1]>=0.0)
+        s << "[" << rank() <<  "]: inter-node halo fraction " << _internodeHalo[1]
+          << " (lexicographic " << _internodeHalo[0] << ")" << std::endl;
       for (ProcListIterator i=sendbegin(); i!=sendend(); ++i)
       {
         s << "[" << rank() <<  "]: send to   "
@@ -505,6 +1366,340 @@ namespace Dune
 
   private:
 
+#if HAVE_MPI
+    //! return the slot of rank in a list of distinct neighbors, or -1
+    static int slot (const std::vector<int>& neighbors, int rank)
+    {
+      for (std::size_t j=0; j<neighbors.size(); j++)
+        if (neighbors[j]==rank)
+          return j;
+      return -1;
+    }
+
+    /** \brief describe the buffers to and from each neighbor by one datatype
+
+       All messages to (or from) the same neighbor are combined into one hindexed
+       datatype over absolute addresses, in the order they are given. This keeps
+       the in-order matching of the point to point exchange. Neighbors without
+       messages get a count of zero.
+     */
+    template<class Buffers, class Address>
+    static void neighborTypes (const std::vector<int>& neighbors, Buffers& buffers, Address address,
+                               std::vector<int>& counts, std::vector<MPI_Datatype>& types)
+    {
+      counts.assign(neighbors.size(), 0);
+      types.assign(neighbors.size(), MPI_BYTE);
+      std::vector<int> lengths;
+      std::vector<MPI_Aint> addresses;
+      for (std::size_t j=0; j<neighbors.size(); j++)
+      {
+        lengths.clear();
+        addresses.clear();
+        for (std::size_t i=0; i<buffers.size(); i++)
+          if (buffers[i].rank==neighbors[j])
+          {
+            MPI_Aint a;
+            MPI_Get_address(address(buffers[i]), &a);
+            lengths.push_back(buffers[i].size);
+            addresses.push_back(a);
+          }
+        if (lengths.empty())
+          continue;
+        MPI_Type_create_hindexed(lengths.size(), lengths.data(), addresses.data(), MPI_BYTE, &types[j]);
+        MPI_Type_commit(&types[j]);
+        counts[j] = 1;
+      }
+    }
+
+    //! free the datatypes created by neighborTypes()
+    static void freeNeighborTypes (const std::vector<int>& counts, std::vector<MPI_Datatype>& types)
+    {
+      for (std::size_t j=0; j<types.size(); j++)
+        if (counts[j]>0)
+          MPI_Type_free(&types[j]);
+    }
+
+    //! exchange the foreign requests with a neighborhood collective
+    void exchangeNeighborhood () const
+    {
+#if MPI_VERSION >= 3
+      std::vector<int> sendcounts, recvcounts;
+      std::vector<MPI_Datatype> sendtypes, recvtypes;
+      auto address = [](CommTask& task) { return task.buffer; };
+      neighborTypes(_destinations, _sendrequests, address, sendcounts, sendtypes);
+      neighborTypes(_sources, _recvrequests, address, recvcounts, recvtypes);
+      std::vector<MPI_Aint> senddispls(_destinations.size(), 0);
+      std::vector<MPI_Aint> recvdispls(_sources.size(), 0);
+
+      MPI_Neighbor_alltoallw(MPI_BOTTOM, sendcounts.data(), senddispls.data(), sendtypes.data(),
+                             MPI_BOTTOM, recvcounts.data(), recvdispls.data(), recvtypes.data(), *_graph);
+
+      freeNeighborTypes(sendcounts, sendtypes);
+      freeNeighborTypes(recvcounts, recvtypes);
+#endif
+    }
+#endif
+
+    //! return the number of cells of the coarse partition at coordinate c in direction i
+    int extent (int i, int c) const
+    {
+      return _offsets[i][c+1] - _offsets[i][c];
+    }
+
+    //! estimate the fraction of halo cells between processes on different nodes
+    double internodeHalo (const std::vector<int>& node) const
+    {
+      int n = 1;
+      for (int i=0; i<d; i++)
+        n *= 3;
+
+      double total = 0.0;
+      double internode = 0.0;
+      for (int r=0; r<procs(); r++)
+      {
+        iTupel coord = rank_to_coord(r);
+        for (int k=0; k<n; k++)
+        {
+          // the neighbor with delta given by the ternary digits of k
+          iTupel nb = coord;
+          double cells = 1.0;
+          bool valid = (k!=(n-1)/2);
+          for (int i=0, kk=k; i<d; i++, kk/=3)
+          {
+            int delta = kk%3-1;
+            nb[i] += delta;
+            if (nb[i]<0 || nb[i]>=_dims[i])
+              valid = false;
+            if (delta==0)
+              cells *= extent(i,coord[i]);
+          }
+          if (!valid)
+            continue;
+          total += cells;
+          if (node[coord_to_rank(nb)]!=node[r])
+            internode += cells;
+        }
+      }
+      return (total>0.0) ? internode/total : 0.0;
+    }
+
+    //! find the shape of a node box that tiles the torus with the smallest inter-node surface
+    void nodebox (int i, int n, const iTupel& size, iTupel& box, iTupel& trybox, double& opt) const
+    {
+      if (i<d-1)
+      {
+        for (int k=1; k<=n; k++)
+          if (n%k==0 && _dims[i]%k==0)
+          {
+            trybox[i] = k;
+            nodebox(i+1,n/k,size,box,trybox,opt);
+          }
+        return;
+      }
+
+      if (_dims[i]%n!=0)
+        return;
+      trybox[i] = n;
+
+      // surface of the box in cells, faces at the torus boundary do not count
+      double surface = 0.0;
+      for (int j=0; j<d; j++)
+        if (trybox[j]<_dims[j])
+        {
+          double face = 1.0;
+          for (int l=0; l<d; l++)
+            if (l!=j)
+              face *= trybox[l]*double(size[l])/_dims[l];
+          surface += 2*face;
+        }
+      if (surface<opt)
+      {
+        opt = surface;
+        box = trybox;
+      }
+    }
+
+    //! place the ranks of each shared memory node in a box of the torus
+    void nodemapping (const iTupel& size)
+    {
+#if HAVE_MPI && MPI_VERSION >= 3
+      // the lowest rank on each node identifies the node
+      MPI_Comm nodecomm;
+      MPI_Comm_split_type(_comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodecomm);
+      int leader = rank();
+      MPI_Bcast(&leader, 1, MPI_INT, 0, nodecomm);
+      MPI_Comm_free(&nodecomm);
+      std::vector<int> node(procs());
+      MPI_Allgather(&leader, 1, MPI_INT, node.data(), 1, MPI_INT, _comm);
+
+      // ranks on each node in ascending order
+      std::map<int, std::vector<int> > nodes;
+      for (int r=0; r<procs(); r++)
+        nodes[node[r]].push_back(r);
+
+      _internodeHalo[0] = _internodeHalo[1] = internodeHalo(node);
+
+      // all nodes need the same number of ranks, otherwise keep the lexicographic placement
+      int n = nodes.begin()->second.size();
+      for (const auto& k : nodes)
+        if (int(k.second.size())!=n)
+        {
+          _mapping = TorusMapping::lexicographic;
+          return;
+        }
+      if (nodes.size()==1)
+      {
+        _mapping = TorusMapping::lexicographic;
+        return;
+      }
+
+      iTupel box, trybox;
+      double opt = 1E100;
+      nodebox(0,n,size,box,trybox,opt);
+      if (opt==1E100)
+      {
+        _mapping = TorusMapping::lexicographic;
+        return;
+      }
+
+      // node k gets the k-th box, its ranks are ordered lexicographically within the box
+      iTupel boxes;
+      for (int i=0; i<d; i++)
+        boxes[i] = _dims[i]/box[i];
+      _position.resize(procs());
+      _rankat.resize(procs());
+      int k = 0;
+      for (const auto& nd : nodes)
+      {
+        for (std::size_t l=0; l<nd.second.size(); l++)
+        {
+          int position = 0;
+          for (int i=0, kk=k, ll=l; i<d; i++)
+          {
+            position += ((kk%boxes[i])*box[i] + ll%box[i])*_increment[i];
+            kk /= boxes[i];
+            ll /= box[i];
+          }
+          _position[nd.second[l]] = position;
+          _rankat[position] = nd.second[l];
+        }
+        k++;
+      }
+
+      _internodeHalo[1] = internodeHalo(node);
+#else
+      _mapping = TorusMapping::lexicographic;
+#endif
+    }
+
+    //! return the rank of a process in the node communicator, or -1 if it is on another node
+    int noderank (int rank) const
+    {
+#if HAVE_MPI
+      if (!_noderank.empty())
+        return _noderank[rank];
+#endif
+      return -1;
+    }
+
+    //! duplicate the communicator for the communication plans
+    void plancommunicator ()
+    {
+#if HAVE_MPI
+      MPI_Comm* plans = new MPI_Comm;
+      MPI_Comm_dup(_comm, plans);
+      _plancomm = std::shared_ptr<MPI_Comm>(plans, [](MPI_Comm* c)
+        {
+          int finalized = 0;
+          MPI_Finalized(&finalized);
+          if (!finalized)
+            MPI_Comm_free(c);
+          delete c;
+        });
+#endif
+    }
+
+    //! build the communicator of the processes sharing memory with this one
+    void sharedmemory ()
+    {
+#if HAVE_MPI && MPI_VERSION >= 3
+      MPI_Comm* node = new MPI_Comm;
+      MPI_Comm_split_type(_comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, node);
+      _nodecomm = std::shared_ptr<MPI_Comm>(node, [](MPI_Comm* c)
+        {
+          int finalized = 0;
+          MPI_Finalized(&finalized);
+          if (!finalized)
+            MPI_Comm_free(c);
+          delete c;
+        });
+
+      // translate all ranks to the node communicator
+      MPI_Group group, nodegroup;
+      MPI_Comm_group(_comm, &group);
+      MPI_Comm_group(*_nodecomm, &nodegroup);
+      std::vector<int> ranks(procs());
+      for (int r=0; r<procs(); r++)
+        ranks[r] = r;
+      _noderank.resize(procs());
+      MPI_Group_translate_ranks(group, procs(), ranks.data(), nodegroup, _noderank.data());
+      for (int r=0; r<procs(); r++)
+        if (_noderank[r]==MPI_UNDEFINED)
+          _noderank[r] = -1;
+      MPI_Group_free(&group);
+      MPI_Group_free(&nodegroup);
+
+      // the window of the communication plans, allocated and freed collectively with the torus
+      SharedWindow* window = new SharedWindow;
+      window->size = sharedWindowSize();
+      MPI_Win_allocate_shared(window->size, 1, MPI_INFO_NULL, *_nodecomm, &window->base, &window->win);
+      MPI_Win_lock_all(MPI_MODE_NOCHECK, window->win);
+      window->free[0] = window->size;
+      _window = std::shared_ptr<SharedWindow>(window, [](SharedWindow* w)
+        {
+          int finalized = 0;
+          MPI_Finalized(&finalized);
+          if (!finalized)
+          {
+            MPI_Win_unlock_all(w->win);
+            MPI_Win_free(&w->win);
+          }
+          delete w;
+        });
+#else
+      _backend = TorusBackend::pointToPoint;
+#endif
+    }
+
+
+    //! build the distributed graph communicator of the foreign neighbors
+    void neighborhood ()
+    {
+#if HAVE_MPI && MPI_VERSION >= 3
+      for (ProcListIterator i=recvbegin(); i!=recvend(); ++i)
+        if (i.rank()!=rank() && slot(_sources,i.rank())<0)
+          _sources.push_back(i.rank());
+      for (ProcListIterator i=sendbegin(); i!=sendend(); ++i)
+        if (i.rank()!=rank() && slot(_destinations,i.rank())<0)
+          _destinations.push_back(i.rank());
+
+      MPI_Comm* graph = new MPI_Comm;
+      MPI_Dist_graph_create_adjacent(_comm, _sources.size(), _sources.data(), MPI_UNWEIGHTED,
+                                     _destinations.size(), _destinations.data(), MPI_UNWEIGHTED,
+                                     MPI_INFO_NULL, 0, graph);
+      _graph = std::shared_ptr<MPI_Comm>(graph, [](MPI_Comm* c)
+        {
+          int finalized = 0;
+          MPI_Finalized(&finalized);
+          if (!finalized)
+            MPI_Comm_free(c);
+          delete c;
+        });
+#else
+      _backend = TorusBackend::pointToPoint;
+#endif
+    }
+
     void proclists ()
     {
       // compile the full neighbor list
@@ -561,7 +1756,32 @@ namespace Dune
 
     iTupel _dims;
     iTupel _increment;
+    // coarse grid size and first cell of each slab of process rows
+    iTupel _size;
+    std::array<std::vector<int>, d> _offsets;
     int _tag;
+    TorusBackend _backend = TorusBackend::pointToPoint;
+    TorusMapping _mapping = TorusMapping::lexicographic;
+    // rank -> lexicographic position and back, empty for the lexicographic mapping
+    std::vector<int> _position;
+    std::vector<int> _rankat;
+    // inter-node halo fraction of the lexicographic and of the actual mapping
+    std::array<double,2> _internodeHalo = {{-1.0, -1.0}};
+#if HAVE_MPI
+    // private communicator of the communication plans
+    std::shared_ptr<MPI_Comm> _plancomm;
+    // distinct foreign neighbors and the graph communicator for the neighborhood backend
+    std::vector<int> _sources;
+    std::vector<int> _destinations;
+    std::shared_ptr<MPI_Comm> _graph;
+    // processes on the same node for the shared memory backend
+    std::shared_ptr<MPI_Comm> _nodecomm;
+    std::vector<int> _noderank;
+#if MPI_VERSION >= 3
+    // the shared window of each process, shared by all plans of the torus
+    std::shared_ptr<SharedWindow> _window;
+#endif
+#endif
     std::deque<CommPartner> _sendlist;
     std::deque<CommPartner> _recvlist;
 
@@ -569,6 +1789,7 @@ namespace Dune
     mutable std::vector<CommTask> _recvrequests;
     mutable std::vector<CommTask> _localsendrequests;
     mutable std::vector<CommTask> _localrecvrequests;
+    mutable int _plans = 0;
 
   };
 
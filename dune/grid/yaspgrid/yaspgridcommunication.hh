@@ -0,0 +1,104 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRIDCOMMUNICATION_HH
+#define DUNE_GRID_YASPGRIDCOMMUNICATION_HH
+
+#include <array>
+
+/** \file
+ * \brief The YaspCommunication class
+ */
+
+namespace Dune {
+
+  /** \brief A split-phase communication on a YaspGrid level
+
+     The constructor gathers the data of all codims contained in the data handle
+     and starts the messages (see YaspGrid::communicateBegin). The received data
+     is scattered per neighbor as the messages arrive, either all at once in wait()
+     or incrementally with test(). This allows to overlap computation with the
+     halo exchange.
+
+     Only fixed size data is communicated asynchronously, variable size data is
+     communicated completely within the constructor. The data handle has to stay
+     alive until the communication is complete. If the object is destroyed before,
+     it waits for the remaining messages. Starting a communication while another
+     one with the same codim, interface and direction on this level is still in
+     flight throws an InvalidStateException.
+   */
+  template<class GridImp, class DataHandle>
+  class YaspCommunication
+  {
+    enum { dim=GridImp::dimension };
+    typedef typename Torus<typename GridImp::CollectiveCommunicationType,dim>::CommPlan CommPlan;
+  public:
+
+    //! gather the data and start the communication
+    YaspCommunication (const GridImp& grid, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level)
+      : _grid(&grid), _data(&data), _iftype(iftype), _dir(dir), _level(level)
+    {
+      std::fill(_plans.begin(), _plans.end(), static_cast<CommPlan*>(0));
+      try {
+        YaspCommunicateMeta<dim,dim>::begin(grid,data,iftype,dir,level,_plans);
+      }
+      catch (...) {
+        // complete the codims already started, e.g. if a plan is still in flight
+        wait();
+        throw;
+      }
+    }
+
+    //! take over a running communication
+    YaspCommunication (YaspCommunication&& other)
+      : _grid(other._grid), _data(other._data), _iftype(other._iftype), _dir(other._dir), _level(other._level),
+        _plans(other._plans)
+    {
+      std::fill(other._plans.begin(), other._plans.end(), static_cast<CommPlan*>(0));
+    }
+
+    //! complete the communication if this has not been done yet
+    ~YaspCommunication ()
+    {
+      if (!ready())
+        wait();
+    }
+
+    //! wait for all messages and scatter the received data
+    void wait ()
+    {
+      YaspCommunicateMeta<dim,dim>::finish(*_grid,*_data,_iftype,_dir,_level,_plans,true);
+    }
+
+    /** \brief scatter the data of all messages that have arrived so far
+     *  \returns true if the communication is complete
+     */
+    bool test ()
+    {
+      return YaspCommunicateMeta<dim,dim>::finish(*_grid,*_data,_iftype,_dir,_level,_plans,false);
+    }
+
+    //! return true if the communication is complete
+    bool ready () const
+    {
+      for (int codim=0; codim<=dim; codim++)
+        if (_plans[codim])
+          return false;
+      return true;
+    }
+
+  private:
+    // a running communication can not be duplicated
+    YaspCommunication (const YaspCommunication&);
+    YaspCommunication& operator= (const YaspCommunication&);
+
+    const GridImp* _grid;
+    DataHandle* _data;
+    InterfaceType _iftype;
+    CommunicationDirection _dir;
+    int _level;
+    std::array<CommPlan*, dim+1> _plans;
+  };
+
+}   // namespace Dune
+
+#endif  // DUNE_GRID_YASPGRIDCOMMUNICATION_HH
@@ -286,6 +286,8 @@ namespace Dune {
         return InteriorEntity;
       if (_g->interiorborder[codim].inside(_it.coord(),_it.shift()))
         return BorderEntity;
+      if (_g->ghosts)
+        return GhostEntity;
       if (_g->overlap[codim].inside(_it.coord(),_it.shift()))
         return OverlapEntity;
       if (_g->overlapfront[codim].inside(_it.coord(),_it.shift()))
@@ -352,7 +354,7 @@ namespace Dune {
     //! consecutive, codim-wise, level-wise index
     int compressedIndex () const
     {
-      return _it.superindex();
+      return _g->index(codim, _it.superindex());
     }
 
     //! subentity compressed index
@@ -384,7 +386,7 @@ namespace Dune {
       }
 
       int which = _g->overlapfront[cc].shiftmapping(shift);
-      return _g->overlapfront[cc].superindex(coord,which);
+      return _g->index(cc, _g->overlapfront[cc].superindex(coord,which));
     }
     public:
     const I& transformingsubiterator() const { return _it; }
@@ -478,6 +480,8 @@ namespace Dune {
     {
       if (_g->interior[0].inside(_it.coord(),_it.shift()))
         return InteriorEntity;
+      if (_g->ghosts)
+        return GhostEntity;
       if (_g->overlap[0].inside(_it.coord(),_it.shift()))
         return OverlapEntity;
       DUNE_THROW(GridError, "Impossible GhostEntity");
@@ -692,7 +696,7 @@ namespace Dune {
     //! consecutive, codim-wise, level-wise index
     int compressedIndex () const
     {
-      return _it.superindex();
+      return _g->index(0, _it.superindex());
     }
 
     //! subentity persistent index
@@ -766,7 +770,7 @@ namespace Dune {
       }
 
       int which = _g->overlapfront[cc].shiftmapping(shift);
-      return _g->overlapfront[cc].superindex(coord,which);
+      return _g->index(cc, _g->overlapfront[cc].superindex(coord,which));
     }
 
     I _it;         // position in the grid level
@@ -852,6 +856,8 @@ namespace Dune {
         return InteriorEntity;
       if (_g->interiorborder[dim].inside(_it.coord(),_it.shift()))
         return BorderEntity;
+      if (_g->ghosts)
+        return GhostEntity;
       if (_g->overlap[dim].inside(_it.coord(),_it.shift()))
         return OverlapEntity;
       if (_g->overlapfront[dim].inside(_it.coord(),_it.shift()))
@@ -918,7 +924,7 @@ namespace Dune {
     }
 
     //! consecutive, codim-wise, level-wise index
-    int compressedIndex () const { return _it.superindex();}
+    int compressedIndex () const { return _g->index(dim, _it.superindex());}
 
   public:
     const I& transformingsubiterator() const { return _it; }
@@ -23,25 +23,50 @@ namespace Dune {
   public:
     typedef typename GridImp::template Codim<codim>::Entity Entity;
     typedef typename GridImp::YGridLevelIterator YGLI;
+    typedef typename GridImp::YGrid YGrid;
     typedef typename GridImp::YGrid::Iterator I;
 
     //! default constructor
     YaspLevelIterator ()
+      : _yg(0), _exclude(0), _curve(0), _pos(-1)
     {}
 
     //! constructor
     YaspLevelIterator (const YGLI & g, const I& it)
-      : _entity(YaspEntity<codim, dim, GridImp>(g,it))
+      : _entity(YaspEntity<codim, dim, GridImp>(g,it)), _yg(0), _exclude(0), _curve(0), _pos(-1)
     {}
 
+    /** \brief constructor for a filtered traversal or a traversal along a space filling curve
+     *
+     * \param g the grid level
+     * \param yg the entities of the partition
+     * \param exclude entities that are skipped, or 0
+     * \param curve the entities of the whole level on the curve, see YGridLevel::curve,
+     *              or 0 for the lexicographic traversal
+     */
+    YaspLevelIterator (const YGLI & g, const YGrid& yg, const YGrid* exclude, const std::vector<int>* curve)
+      : _entity(YaspEntity<codim, dim, GridImp>(g,yg.begin())), _yg(&yg), _exclude(exclude), _curve(curve), _pos(-1)
+    {
+      if (_curve)
+        advance();
+      else
+        skip();
+    }
+
     //! copy constructor
     YaspLevelIterator (const YaspLevelIterator& i) :
-      _entity(i._entity) {}
+      _entity(i._entity), _yg(i._yg), _exclude(i._exclude), _curve(i._curve), _pos(i._pos) {}
 
     //! increment
     void increment()
     {
-      ++(GridImp::getRealImplementation(_entity)._it);
+      if (_curve)
+        advance();
+      else
+      {
+        ++(GridImp::getRealImplementation(_entity)._it);
+        skip();
+      }
     }
 
     //! equality
@@ -57,7 +82,49 @@ namespace Dune {
     }
 
   protected:
+    //! move to the next entity of the partition on the curve, or to the end
+    void advance ()
+    {
+      I& it = GridImp::getRealImplementation(_entity)._it;
+      const YGLI& g = GridImp::getRealImplementation(_entity).gridlevel();
+
+      // the curve runs through the box of the whole level, whose superindex is lexicographic
+      const auto& box = *g->overlapfront[codim].dataBegin();
+      const auto& partition = *_yg->dataBegin();
+      std::array<int, dim> coord;
+      while (++_pos < int(_curve->size()))
+      {
+        int k = (*_curve)[_pos];
+        for (int i=0; i<dim; i++)
+        {
+          coord[i] = box.origin(i) + k % box.size(i);
+          k /= box.size(i);
+        }
+        if (partition.inside(coord) && !(_exclude && _exclude->dataBegin()->inside(coord)))
+        {
+          it.reinit(*_yg, coord);
+          return;
+        }
+      }
+      it = _yg->end();
+    }
+
+    //! move forward to the next entity that is not excluded
+    void skip ()
+    {
+      if (!_exclude)
+        return;
+      I& it = GridImp::getRealImplementation(_entity)._it;
+      const I end = _yg->end();
+      while (it != end && _exclude->inside(it.coord(),it.shift()))
+        ++it;
+    }
+
     Entity _entity; //!< entity
+    const YGrid* _yg; //!< the partition for a filtered traversal
+    const YGrid* _exclude; //!< entities skipped by the traversal, or 0
+    const std::vector<int>* _curve; //!< the curve, or 0 for lexicographic traversal
+    int _pos; //!< position on the curve
   };
 
 }
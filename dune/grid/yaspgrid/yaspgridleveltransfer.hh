@@ -0,0 +1,286 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRIDLEVELTRANSFER_HH
+#define DUNE_GRID_YASPGRIDLEVELTRANSFER_HH
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+/** \file
+ * \brief The YaspLevelTransfer class
+ */
+
+namespace Dune {
+
+  /** \brief Index maps between two consecutive levels of a YaspGrid for multigrid transfer operators
+
+     Every cell of a level of YaspGrid is refined into 2^dim children. This
+     class computes, for all cells and vertices of a fine level on this
+     process including the overlap, the entities of the next coarser level
+     they come from, as flat arrays indexed by the level index sets:
+
+     - father()[k] is the index of the father of the fine cell k, or -1 if the
+       father is not on this process
+     - childSlot()[k] has bit i set if the fine cell k is the upper child of
+       its father in direction i
+     - the vertex stencil holds the weights of the multilinear interpolation
+       of the coarse vertices to the fine vertex k, in compressed row storage:
+       the entries stencilOffsets()[k] to stencilOffsets()[k+1]-1 of
+       stencilIndices() and stencilWeights()
+
+     The transfer operators then are loops over these arrays, without
+     entities, hierarchic iterators and geometries. The maps are valid as
+     long as the grid is not modified.
+
+     \tparam GridImp the YaspGrid type
+   */
+  template<class GridImp>
+  class YaspLevelTransfer
+  {
+    enum { dim = GridImp::dimension };
+    typedef typename GridImp::YGridLevelIterator YGridLevelIterator;
+  public:
+    typedef std::array<int, dim> iTupel;
+    typedef typename GridImp::ctype ctype;
+
+    //! compute the maps between the given level and the next coarser level
+    YaspLevelTransfer (const GridImp& grid, int fineLevel)
+      : _fineLevel(fineLevel)
+    {
+      if (fineLevel < 1 || fineLevel > grid.maxLevel())
+        DUNE_THROW(GridError, "YaspLevelTransfer needs a level between 1 and " << grid.maxLevel()
+                   << ", " << fineLevel << " was given");
+
+      const YGridLevelIterator fine = grid.begin(fineLevel);
+      const YGridLevelIterator coarse = grid.begin(fineLevel-1);
+      makeCellMaps(fine, coarse);
+      makeVertexStencil(fine, coarse);
+    }
+
+    //! return the fine level
+    int fineLevel () const
+    {
+      return _fineLevel;
+    }
+
+    //! return the index of the father of each fine cell, or -1
+    const std::vector<int>& father () const
+    {
+      return _father;
+    }
+
+    //! return the position of each fine cell in its father, bit i is set for the upper child in direction i
+    const std::vector<unsigned char>& childSlot () const
+    {
+      return _childSlot;
+    }
+
+    //! return the offsets of the stencils of the fine vertices, it has one entry more than there are fine vertices
+    const std::vector<int>& stencilOffsets () const
+    {
+      return _offsets;
+    }
+
+    //! return the indices of the coarse vertices of the stencils
+    const std::vector<int>& stencilIndices () const
+    {
+      return _indices;
+    }
+
+    //! return the interpolation weights of the stencils
+    const std::vector<ctype>& stencilWeights () const
+    {
+      return _weights;
+    }
+
+    //! prolongate cell data by injection, fine cells without father are not changed
+    template<class V>
+    void prolongateCells (const V& coarse, V& fine) const
+    {
+      for (std::size_t k=0; k<_father.size(); k++)
+        if (_father[k] >= 0)
+          fine[k] = coarse[_father[k]];
+    }
+
+    //! restrict cell data by summing over the children, the transpose of prolongateCells()
+    template<class V>
+    void restrictCells (const V& fine, V& coarse) const
+    {
+      for (auto& c : coarse)
+        c = 0;
+      for (std::size_t k=0; k<_father.size(); k++)
+        if (_father[k] >= 0)
+          coarse[_father[k]] += fine[k];
+    }
+
+    //! prolongate vertex data by multilinear interpolation, fine vertices without stencil are set to 0
+    template<class V>
+    void prolongateVertices (const V& coarse, V& fine) const
+    {
+      for (std::size_t k=0; k+1<_offsets.size(); k++)
+      {
+        fine[k] = 0;
+        for (int j=_offsets[k]; j<_offsets[k+1]; j++)
+          fine[k] += _weights[j]*coarse[_indices[j]];
+      }
+    }
+
+    //! restrict vertex data with the transpose of prolongateVertices()
+    template<class V>
+    void restrictVertices (const V& fine, V& coarse) const
+    {
+      for (auto& c : coarse)
+        c = 0;
+      for (std::size_t k=0; k+1<_offsets.size(); k++)
+        for (int j=_offsets[k]; j<_offsets[k+1]; j++)
+          coarse[_indices[j]] += _weights[j]*fine[k];
+    }
+
+  private:
+    void makeCellMaps (YGridLevelIterator fine, YGridLevelIterator coarse)
+    {
+      // the cells of a level consist of a single component covering the box
+      const auto& f = *fine->overlapfront[0].dataBegin();
+      const auto& c = *coarse->overlapfront[0].dataBegin();
+
+      int n = 1;
+      for (int i=0; i<dim; i++)
+        n *= f.size(i);
+      _father.resize(n);
+      _childSlot.resize(n);
+
+      iTupel x(f.origin());
+      for (int k=0; k<n; k++)
+      {
+        iTupel y;
+        unsigned char slot = 0;
+        for (int i=0; i<dim; i++)
+        {
+          y[i] = x[i] >> 1;
+          slot |= (x[i] & 1) << i;
+        }
+
+        const int index = fine->index(0, k);
+        _father[index] = c.inside(y) ? coarse->index(0, c.index(y)) : -1;
+        _childSlot[index] = slot;
+
+        // next cell in lexicographic order
+        for (int i=0; i<dim; i++)
+        {
+          if (++x[i] < f.origin(i) + f.size(i))
+            break;
+          x[i] = f.origin(i);
+        }
+      }
+    }
+
+    void makeVertexStencil (YGridLevelIterator fine, YGridLevelIterator coarse)
+    {
+      // the vertices of a level consist of a single component covering the box
+      const auto& f = *fine->overlapfront[dim].dataBegin();
+      const auto& c = *coarse->overlapfront[dim].dataBegin();
+
+      int n = 1;
+      for (int i=0; i<dim; i++)
+        n *= f.size(i);
+
+      // the stencils in lexicographic order of the fine vertices
+      std::vector<int> offsets(n+1, 0);
+      std::vector<int> indices;
+      std::vector<ctype> weights;
+      indices.reserve(n);
+      weights.reserve(n);
+
+      iTupel x(f.origin());
+      for (int k=0; k<n; k++)
+      {
+        // the coarse neighbors and their weights in each direction
+        std::array<std::array<int, 2>, dim> lower;
+        std::array<std::array<ctype, 2>, dim> weight;
+        std::array<int, dim> count;
+        bool inside = true;
+        for (int i=0; i<dim; i++)
+        {
+          count[i] = 1 + (x[i] & 1);
+          lower[i][0] = x[i] >> 1;
+          lower[i][1] = lower[i][0] + 1;
+          inside = (lower[i][0] >= c.origin(i)) && (lower[i][count[i]-1] < c.origin(i) + c.size(i));
+          if (!inside)
+            break;
+          weight[i][0] = 1;
+          if (count[i] == 2)
+          {
+            const ctype left = coarse->coords.coordinate(i, lower[i][0]);
+            const ctype right = coarse->coords.coordinate(i, lower[i][1]);
+            const ctype position = fine->coords.coordinate(i, x[i]);
+            weight[i][0] = (right - position)/(right - left);
+            weight[i][1] = (position - left)/(right - left);
+          }
+        }
+
+        // the tensor product of the directions, all coarse vertices have to be on this process
+        const std::size_t first = indices.size();
+        iTupel j;
+        std::fill(j.begin(), j.end(), 0);
+        while (inside)
+        {
+          iTupel y;
+          ctype w = 1;
+          for (int i=0; i<dim; i++)
+          {
+            y[i] = lower[i][j[i]];
+            w *= weight[i][j[i]];
+          }
+          indices.push_back(coarse->index(dim, c.index(y)));
+          weights.push_back(w);
+
+          int i = 0;
+          for ( ; i<dim; i++)
+          {
+            if (++j[i] < count[i])
+              break;
+            j[i] = 0;
+          }
+          if (i == dim)
+            break;
+        }
+        offsets[fine->index(dim, k)+1] = indices.size() - first;
+
+        // next vertex in lexicographic order
+        for (int i=0; i<dim; i++)
+        {
+          if (++x[i] < f.origin(i) + f.size(i))
+            break;
+          x[i] = f.origin(i);
+        }
+      }
+
+      // sort the stencils by the index of the fine vertices
+      for (int k=0; k<n; k++)
+        offsets[k+1] += offsets[k];
+      _offsets = offsets;
+      _indices.resize(indices.size());
+      _weights.resize(weights.size());
+      std::size_t first = 0;
+      for (int k=0; k<n; k++)
+      {
+        const int index = fine->index(dim, k);
+        const int length = _offsets[index+1] - _offsets[index];
+        std::copy(indices.begin()+first, indices.begin()+first+length, _indices.begin()+_offsets[index]);
+        std::copy(weights.begin()+first, weights.begin()+first+length, _weights.begin()+_offsets[index]);
+        first += length;
+      }
+    }
+
+    int _fineLevel;
+    std::vector<int> _father;
+    std::vector<unsigned char> _childSlot;
+    std::vector<int> _offsets;
+    std::vector<int> _indices;
+    std::vector<ctype> _weights;
+  };
+
+}   // namespace Dune
+
+#endif  // DUNE_GRID_YASPGRIDLEVELTRANSFER_HH
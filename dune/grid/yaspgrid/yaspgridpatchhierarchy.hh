@@ -0,0 +1,678 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRIDPATCHHIERARCHY_HH
+#define DUNE_GRID_YASPGRIDPATCHHIERARCHY_HH
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+/** \file
+ * \brief The YaspPatchHierarchy class
+ */
+
+namespace Dune {
+
+  namespace Yasp {
+
+    /** \brief Cover the flagged cells of a box by rectangular boxes (Berger-Rigoutsos)
+
+       A box is accepted if at least the fraction efficiency of its cells is
+       flagged, otherwise it is split at a hole or at the strongest inflection
+       point of the flag signatures, or bisected in its longest direction.
+
+       \param [in] size number of cells of the box in each direction
+       \param [in] flags flag of each cell, lexicographic with direction 0 running fastest
+       \param [in] efficiency minimum fraction of flagged cells of the boxes
+       \param [out] boxes the boxes [first,second) in local coordinates, disjoint and covering all flags
+     */
+    template<int dim>
+    void clusterFlags (const std::array<int, dim>& size, const std::vector<char>& flags, double efficiency,
+                       std::vector<std::pair<std::array<int, dim>, std::array<int, dim> > >& boxes)
+    {
+      typedef std::array<int, dim> iTupel;
+      std::vector<std::pair<iTupel, iTupel> > stack;
+      iTupel zero;
+      std::fill(zero.begin(), zero.end(), 0);
+      stack.push_back(std::make_pair(zero, size));
+
+      while (!stack.empty())
+      {
+        iTupel lower = stack.back().first;
+        iTupel upper = stack.back().second;
+        stack.pop_back();
+
+        // signatures: the number of flags in each slab of the box
+        std::array<std::vector<int>, dim> sig;
+        for (int i=0; i<dim; i++)
+          sig[i].assign(upper[i]-lower[i], 0);
+        int count = 0;
+        iTupel c(lower);
+        bool done = false;
+        for (int i=0; i<dim; i++)
+          done = done || (lower[i] >= upper[i]);
+        while (!done)
+        {
+          int k = 0;
+          for (int i=dim-1; i>=0; i--)
+            k = k*size[i] + c[i];
+          if (flags[k])
+          {
+            count++;
+            for (int i=0; i<dim; i++)
+              sig[i][c[i]-lower[i]]++;
+          }
+          int i = 0;
+          for ( ; i<dim; i++)
+          {
+            if (++c[i] < upper[i])
+              break;
+            c[i] = lower[i];
+          }
+          done = (i == dim);
+        }
+        if (count == 0)
+          continue;
+
+        // shrink to the bounding box of the flags
+        for (int i=0; i<dim; i++)
+        {
+          int first = 0, last = sig[i].size();
+          while (sig[i][first] == 0)
+            first++;
+          while (sig[i][last-1] == 0)
+            last--;
+          sig[i] = std::vector<int>(sig[i].begin()+first, sig[i].begin()+last);
+          upper[i] = lower[i] + last;
+          lower[i] += first;
+        }
+
+        double volume = 1.0;
+        for (int i=0; i<dim; i++)
+          volume *= upper[i]-lower[i];
+        if (count >= efficiency*volume)
+        {
+          boxes.push_back(std::make_pair(lower, upper));
+          continue;
+        }
+
+        // split at a hole closest to the middle of the box
+        int direction = -1, split = 0, best = 0;
+        for (int i=0; i<dim; i++)
+        {
+          const int n = sig[i].size();
+          for (int k=1; k<n-1; k++)
+            if (sig[i][k] == 0 && (direction < 0 || std::abs(2*k-n) < best))
+            {
+              direction = i;
+              split = k;
+              best = std::abs(2*k-n);
+            }
+        }
+
+        // otherwise at the strongest inflection point of the signatures
+        if (direction < 0)
+        {
+          best = 0;
+          for (int i=0; i<dim; i++)
+          {
+            const int n = sig[i].size();
+            for (int k=2; k<n-1; k++)
+            {
+              const int left = sig[i][k-2] - 2*sig[i][k-1] + sig[i][k];
+              const int right = sig[i][k-1] - 2*sig[i][k] + sig[i][k+1];
+              if ((left < 0) != (right < 0) && std::abs(right-left) > best)
+              {
+                direction = i;
+                split = k;
+                best = std::abs(right-left);
+              }
+            }
+          }
+        }
+
+        // otherwise bisect the longest direction
+        if (direction < 0)
+        {
+          direction = 0;
+          for (int i=1; i<dim; i++)
+            if (sig[i].size() > sig[direction].size())
+              direction = i;
+          split = sig[direction].size()/2;
+        }
+
+        if (split == 0)
+        {
+          // a single cell wide box cannot be split in its longest direction
+          boxes.push_back(std::make_pair(lower, upper));
+          continue;
+        }
+
+        iTupel middle(upper);
+        middle[direction] = lower[direction] + split;
+        stack.push_back(std::make_pair(lower, middle));
+        middle = lower;
+        middle[direction] += split;
+        stack.push_back(std::make_pair(middle, upper));
+      }
+    }
+
+  }
+
+  /** \brief Block-structured local refinement on top of the levels of a YaspGrid
+
+     The leaf cells of the hierarchy are the cells of rectangular patches on
+     the levels of the grid. Level 0 consists of one patch, the interior cells
+     of the process. The patches of level l+1 are refined boxes of level l
+     cells, which adapt() computes by clustering the cells marked for
+     refinement (see Yasp::clusterFlags). The patches are properly nested: a
+     patch of level l+1 keeps a distance of one cell of level l to the
+     boundary of the patches of level l, so neighboring leaf cells differ by
+     at most one level. The cells of a patch that are covered by a finer
+     patch are not leaf cells.
+
+     The leaf cells are numbered consecutively, level by level, patch by
+     patch and lexicographically inside each patch with direction 0 running
+     fastest, so forEachLeafRow() visits runs of leaf cells with consecutive
+     indices. forEachLeafFace() visits the faces between leaf cells, including
+     the faces between a fine and a coarse cell at the boundary of a patch,
+     which have a hanging node. Together they form a leaf view that is
+     conforming up to hanging nodes.
+
+     This is an alternative leaf structure, the leaf grid view of YaspGrid
+     remains the finest level. The levels of the grid are refined globally
+     as needed, which is cheap for YaspGrid as it does not store entities.
+     The patches are local to each process, faces on the process boundary
+     are not visited. The object is valid as long as the grid is not
+     modified by other means than adapt().
+
+     \tparam GridImp the YaspGrid type
+   */
+  template<class GridImp>
+  class YaspPatchHierarchy
+  {
+    enum { dim = GridImp::dimension };
+    typedef typename GridImp::YGridLevelIterator YGridLevelIterator;
+  public:
+    typedef std::array<int, dim> iTupel;
+    typedef typename GridImp::ctype ctype;
+
+    //! a box of cells [lower,upper) in the global cell coordinates of a level
+    struct Patch
+    {
+      iTupel lower;
+      iTupel upper;
+
+      //! return true if the cell with the given coordinates is in the patch
+      bool contains (const iTupel& coord) const
+      {
+        for (int i=0; i<dim; i++)
+          if (coord[i] < lower[i] || coord[i] >= upper[i])
+            return false;
+        return true;
+      }
+
+      //! return the number of cells in the patch
+      int volume () const
+      {
+        int v = 1;
+        for (int i=0; i<dim; i++)
+          v *= upper[i]-lower[i];
+        return v;
+      }
+    };
+
+    //! a face between two leaf cells, its normal is the unit vector in direction
+    struct Face
+    {
+      //! the direction of the normal
+      int direction;
+      //! the leaf index of the cell below the face in direction
+      int inside;
+      //! the leaf index of the cell above the face in direction
+      int outside;
+    };
+
+    /** \brief make a hierarchy consisting of the interior cells of level 0
+
+       \param grid the grid, adapt() refines it globally as needed
+       \param efficiency minimum fraction of marked cells in a patch
+     */
+    explicit YaspPatchHierarchy (GridImp& grid, double efficiency = 0.7)
+      : _grid(grid), _efficiency(efficiency)
+    {
+      std::vector<std::vector<Patch> > patches(1);
+      patches[0].push_back(interiorBox(0));
+      build(patches);
+    }
+
+    //! return the finest level with a patch on this process
+    int maxLevel () const
+    {
+      return _patches.size()-1;
+    }
+
+    //! return the patches of a level
+    const std::vector<Patch>& patches (int level) const
+    {
+      return _patches[level];
+    }
+
+    //! return the number of leaf cells
+    int size () const
+    {
+      return _level.size();
+    }
+
+    //! return the level of a leaf cell
+    int level (int index) const
+    {
+      return _level[index];
+    }
+
+    //! return the global coordinates of a leaf cell on its level
+    const iTupel& coord (int index) const
+    {
+      return _coord[index];
+    }
+
+    //! return the index of a cell of a level, -1 if it is covered by finer cells and -2 if it is in no patch
+    int index (int level, const iTupel& coord) const
+    {
+      if (level > maxLevel())
+        return -2;
+      const std::vector<Patch>& patches = _patches[level];
+      for (std::size_t p=0; p<patches.size(); p++)
+        if (patches[p].contains(coord))
+        {
+          int k = 0;
+          for (int i=dim-1; i>=0; i--)
+            k = k*(patches[p].upper[i]-patches[p].lower[i]) + coord[i]-patches[p].lower[i];
+          return _leaf[level][p][k];
+        }
+      return -2;
+    }
+
+    //! return the index of the leaf cell that is or contains the given cell, -1 if the cell is covered by finer cells
+    int leafAncestor (int level, iTupel coord) const
+    {
+      for (int l=level; l>=0; l--)
+      {
+        const int k = index(l, coord);
+        if (k != -2)
+          return k;
+        for (int i=0; i<dim; i++)
+          coord[i] >>= 1;
+      }
+      return -1;
+    }
+
+    //! return the leaf index of an interior cell of the grid, -1 if it is no leaf cell
+    template<class Entity>
+    int leafIndex (const Entity& e) const
+    {
+      // the global index of a cell is lexicographic in the cells of the level
+      auto k = _grid.globalIndex(e);
+      iTupel coord;
+      for (int i=0; i<dim; i++)
+      {
+        coord[i] = k % _grid.levelSize(e.level(),i);
+        k /= _grid.levelSize(e.level(),i);
+      }
+      return std::max(index(e.level(), coord), -1);
+    }
+
+    //! return the lower coordinate in direction i of the cells with coordinate c on a level
+    ctype lower (int level, int i, int c) const
+    {
+      return _grid.begin(level)->coords.coordinate(i, c);
+    }
+
+    //! return the width in direction i of the cells with coordinate c on a level
+    ctype meshsize (int level, int i, int c) const
+    {
+      return _grid.begin(level)->coords.meshsize(i, c);
+    }
+
+    //! return the volume of a leaf cell
+    ctype volume (int index) const
+    {
+      ctype v = 1.0;
+      for (int i=0; i<dim; i++)
+        v *= meshsize(_level[index], i, _coord[index][i]);
+      return v;
+    }
+
+    //! return the area of a face, the face of the finer of its two cells
+    ctype area (const Face& face) const
+    {
+      const int k = (_level[face.inside] >= _level[face.outside]) ? face.inside : face.outside;
+      ctype a = 1.0;
+      for (int i=0; i<dim; i++)
+        if (i != face.direction)
+          a *= meshsize(_level[k], i, _coord[k][i]);
+      return a;
+    }
+
+    /** \brief mark a leaf cell for refinement or coarsening in the next adapt()
+
+       \param refCount the number of levels the cell should be refined, negative values coarsen
+       \param index the leaf index of the cell
+     */
+    bool mark (int refCount, int index)
+    {
+      _marks[index] = refCount;
+      return true;
+    }
+
+    //! return the mark of a leaf cell
+    int getMark (int index) const
+    {
+      return _marks[index];
+    }
+
+    /** \brief recompute the patches from the marks and renumber the leaf cells
+
+       Every leaf cell asks for the region it covers to be resolved on its
+       level plus its mark. The patches of the finest level are computed first,
+       each coarser level gets the cells needed for the proper nesting of the
+       finer patches. The marks are reset. This method is collective, as it
+       refines the grid if the hierarchy gets finer than its finest level.
+
+       \return true if the patches changed
+     */
+    bool adapt ()
+    {
+      std::vector<int> want(size());
+      int finest = 0;
+      for (int k=0; k<size(); k++)
+      {
+        want[k] = std::max(0, _level[k] + _marks[k]);
+        finest = std::max(finest, want[k]);
+      }
+      finest = _grid.comm().max(finest);
+      if (finest > _grid.maxLevel())
+        _grid.globalRefine(finest - _grid.maxLevel());
+
+      std::vector<std::vector<Patch> > patches(finest+1);
+      patches[0].push_back(interiorBox(0));
+      for (int l=finest; l>=1; l--)
+      {
+        // flag the cells of level l-1 that need to be refined
+        const Patch box = interiorBox(l-1);
+        iTupel extent;
+        for (int i=0; i<dim; i++)
+          extent[i] = box.upper[i]-box.lower[i];
+        std::vector<char> flags(box.volume(), 0);
+        auto flag = [&](const iTupel& c)
+        {
+          int k = 0;
+          for (int i=dim-1; i>=0; i--)
+            k = k*extent[i] + c[i]-box.lower[i];
+          flags[k] = 1;
+        };
+        auto flagBox = [&](const iTupel& lower, const iTupel& upper)
+        {
+          iTupel c(lower);
+          while (true)
+          {
+            flag(c);
+            int i = 0;
+            for ( ; i<dim; i++)
+            {
+              if (++c[i] < upper[i])
+                break;
+              c[i] = lower[i];
+            }
+            if (i == dim)
+              break;
+          }
+        };
+
+        // a leaf cell flags the cell of level l-1 containing it, or all its descendants on level l-1
+        for (int k=0; k<size(); k++)
+          if (want[k] >= l)
+          {
+            const int shift = _level[k]-l+1;
+            iTupel lower, upper;
+            for (int i=0; i<dim; i++)
+            {
+              lower[i] = (shift >= 0) ? _coord[k][i] >> shift : _coord[k][i] << -shift;
+              upper[i] = (shift >= 0) ? lower[i]+1 : (_coord[k][i]+1) << -shift;
+            }
+            flagBox(lower, upper);
+          }
+
+        // the finer patches with one cell of level l around them have to be inside the patches of level l
+        if (l < finest)
+        {
+          const Patch fine = interiorBox(l);
+          for (const Patch& q : patches[l+1])
+          {
+            iTupel lower, upper;
+            for (int i=0; i<dim; i++)
+            {
+              lower[i] = std::max(q.lower[i]/2-1, fine.lower[i])/2;
+              upper[i] = (std::min(q.upper[i]/2+1, fine.upper[i])+1)/2;
+            }
+            flagBox(lower, upper);
+          }
+        }
+
+        std::vector<std::pair<iTupel, iTupel> > boxes;
+        Yasp::clusterFlags<dim>(extent, flags, _efficiency, boxes);
+        for (const auto& b : boxes)
+        {
+          Patch p;
+          for (int i=0; i<dim; i++)
+          {
+            p.lower[i] = 2*(box.lower[i] + b.first[i]);
+            p.upper[i] = 2*(box.lower[i] + b.second[i]);
+          }
+          patches[l].push_back(p);
+        }
+      }
+
+      // drop the empty levels on this process
+      while (patches.size() > 1 && patches.back().empty())
+        patches.pop_back();
+
+      bool changed = (patches.size() != _patches.size());
+      for (std::size_t l=0; l<patches.size() && !changed; l++)
+      {
+        changed = (patches[l].size() != _patches[l].size());
+        for (std::size_t p=0; p<patches[l].size() && !changed; p++)
+          changed = (patches[l][p].lower != _patches[l][p].lower || patches[l][p].upper != _patches[l][p].upper);
+      }
+
+      build(patches);
+      return changed;
+    }
+
+    /** \brief call f for the runs of consecutive leaf cells along direction 0
+
+       \param f called as f(level, first, length, index), where first are the
+                coordinates of the first cell of the run on the level and
+                index its leaf index, the other cells of the run follow in
+                direction 0 with consecutive indices
+     */
+    template<class F>
+    void forEachLeafRow (F&& f) const
+    {
+      for (int l=0; l<=maxLevel(); l++)
+        for (std::size_t p=0; p<_patches[l].size(); p++)
+        {
+          const Patch& patch = _patches[l][p];
+          const std::vector<int>& leaf = _leaf[l][p];
+          const int width = patch.upper[0]-patch.lower[0];
+          for (std::size_t k=0; k<leaf.size(); k+=width)
+          {
+            int x = 0;
+            while (x < width)
+            {
+              if (leaf[k+x] < 0)
+              {
+                x++;
+                continue;
+              }
+              int length = 1;
+              while (x+length < width && leaf[k+x+length] >= 0)
+                length++;
+              iTupel first(_coord[leaf[k+x]]);
+              f(l, static_cast<const iTupel&>(first), length, leaf[k+x]);
+              x += length;
+            }
+          }
+        }
+    }
+
+    /** \brief call f for each face between two leaf cells on this process
+
+       Each face is visited once. A face between a fine and a coarse cell is
+       the face of the fine cell, a coarse cell thus has several faces on a
+       side with a finer neighbor patch.
+
+       \param f called with a const Face&
+     */
+    template<class F>
+    void forEachLeafFace (F&& f) const
+    {
+      Face face;
+      for (int k=0; k<size(); k++)
+      {
+        const int l = _level[k];
+        const Patch box = interiorBox(l);
+        for (int i=0; i<dim; i++)
+          for (int side=-1; side<=1; side+=2)
+          {
+            iTupel n(_coord[k]);
+            n[i] += side;
+            if (!box.contains(n))
+              continue;
+
+            // neighbors on the same level are visited from below, finer neighbors visit this cell
+            int neighbor = index(l, n);
+            if (neighbor == -1 || (neighbor >= 0 && side < 0))
+              continue;
+            if (neighbor == -2)
+            {
+              for (int j=0; j<dim; j++)
+                n[j] >>= 1;
+              neighbor = leafAncestor(l-1, n);
+              if (neighbor < 0)
+                continue;
+            }
+
+            face.direction = i;
+            face.inside = (side > 0) ? k : neighbor;
+            face.outside = (side > 0) ? neighbor : k;
+            f(static_cast<const Face&>(face));
+          }
+      }
+    }
+
+  private:
+    //! the interior cells of the process on a level
+    Patch interiorBox (int level) const
+    {
+      const auto& interior = *_grid.begin(level)->interior[0].dataBegin();
+      Patch box;
+      for (int i=0; i<dim; i++)
+      {
+        box.lower[i] = interior.origin(i);
+        box.upper[i] = interior.origin(i) + interior.size(i);
+      }
+      return box;
+    }
+
+    //! set the patches and number the leaf cells
+    void build (const std::vector<std::vector<Patch> >& patches)
+    {
+      _patches = patches;
+      _leaf.assign(patches.size(), std::vector<std::vector<int> >());
+      _level.clear();
+      _coord.clear();
+
+      for (std::size_t l=0; l<patches.size(); l++)
+      {
+        _leaf[l].resize(patches[l].size());
+        for (std::size_t p=0; p<patches[l].size(); p++)
+        {
+          const Patch& patch = patches[l][p];
+          std::vector<int>& leaf = _leaf[l][p];
+          leaf.assign(patch.volume(), 0);
+          iTupel extent;
+          for (int i=0; i<dim; i++)
+            extent[i] = patch.upper[i]-patch.lower[i];
+
+          // the cells covered by the patches of the next level
+          if (l+1 < patches.size())
+            for (const Patch& q : patches[l+1])
+            {
+              iTupel lower, upper;
+              bool empty = false;
+              for (int i=0; i<dim; i++)
+              {
+                lower[i] = std::max(q.lower[i]/2, patch.lower[i]);
+                upper[i] = std::min(q.upper[i]/2, patch.upper[i]);
+                empty = empty || (lower[i] >= upper[i]);
+              }
+              if (empty)
+                continue;
+              iTupel c(lower);
+              while (true)
+              {
+                int k = 0;
+                for (int i=dim-1; i>=0; i--)
+                  k = k*extent[i] + c[i]-patch.lower[i];
+                leaf[k] = -1;
+                int i = 0;
+                for ( ; i<dim; i++)
+                {
+                  if (++c[i] < upper[i])
+                    break;
+                  c[i] = lower[i];
+                }
+                if (i == dim)
+                  break;
+              }
+            }
+
+          iTupel c(patch.lower);
+          for (std::size_t k=0; k<leaf.size(); k++)
+          {
+            if (leaf[k] == 0)
+            {
+              leaf[k] = _level.size();
+              _level.push_back(l);
+              _coord.push_back(c);
+            }
+
+            for (int i=0; i<dim; i++)
+            {
+              if (++c[i] < patch.upper[i])
+                break;
+              c[i] = patch.lower[i];
+            }
+          }
+        }
+      }
+
+      _marks.assign(_level.size(), 0);
+    }
+
+    GridImp& _grid;
+    double _efficiency;
+    std::vector<std::vector<Patch> > _patches;
+    // _leaf[l][p][k] is the leaf index of cell k of patch p on level l, or -1
+    std::vector<std::vector<std::vector<int> > > _leaf;
+    std::vector<int> _level;
+    std::vector<iTupel> _coord;
+    std::vector<int> _marks;
+  };
+
+}   // namespace Dune
+
+#endif  // DUNE_GRID_YASPGRIDPATCHHIERARCHY_HH
@@ -0,0 +1,282 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRIDSTATIC_HH
+#define DUNE_GRID_YASPGRIDSTATIC_HH
+
+#include <array>
+#include <bitset>
+#include <type_traits>
+
+/** \file
+ * \brief The StaticYaspGrid and YaspStaticAccess classes
+ */
+
+namespace Dune {
+
+  namespace Yasp {
+
+    //! the i-th value of a list of integers, usable in constant expressions
+    template<int first, int... rest>
+    struct StaticList
+    {
+      static constexpr int get (int i)
+      {
+        return (i == 0) ? first : StaticList<rest...>::get(i-1);
+      }
+    };
+
+    template<int first>
+    struct StaticList<first>
+    {
+      static constexpr int get (int)
+      {
+        return first;
+      }
+    };
+
+  }
+
+  /** \brief An equidistant YaspGrid whose cell counts, periodicity and overlap are template parameters
+
+     This is a YaspGrid in all respects, the grid interface is the same as
+     for the runtime variant. In addition the extents of the boxes of cells of
+     the levels on a single process are known at compile time, which
+     YaspStaticAccess uses to turn index computations and loop bounds into
+     constants.
+
+     \tparam overlap the overlap on level 0
+     \tparam periodic bit i is set if the grid is periodic in direction i
+     \tparam N the number of cells of level 0 in each direction
+   */
+  template<int overlap, unsigned int periodic, int... N>
+  class StaticYaspGrid
+    : public YaspGrid<sizeof...(N)>
+  {
+    typedef YaspGrid<sizeof...(N)> Base;
+  public:
+    enum { dim = sizeof...(N) };
+    typedef typename Base::ctype ctype;
+    typedef typename Base::CollectiveCommunicationType CollectiveCommunicationType;
+
+    //! return the number of cells of level 0 in direction i
+    static constexpr int cells (int i)
+    {
+      return Yasp::StaticList<N...>::get(i);
+    }
+
+    //! return true if the grid is periodic in direction i
+    static constexpr bool isPeriodic (int i)
+    {
+      return (periodic >> i) & 1u;
+    }
+
+    //! return the overlap on level 0
+    static constexpr int overlapCells ()
+    {
+      return overlap;
+    }
+
+    /** \brief make a grid of the given extent
+
+       \param L extension of the domain
+       \param comm the collective communication object for this grid
+       \param lb pointer to an overloaded YLoadBalance instance
+     */
+    StaticYaspGrid (Dune::FieldVector<ctype, dim> L,
+                    CollectiveCommunicationType comm = CollectiveCommunicationType(),
+                    const YLoadBalance<dim>* lb = Base::defaultLoadbalancer())
+      : Base(L, std::array<int, dim>{{N...}}, std::bitset<dim>(periodic), overlap, comm, lb)
+    {}
+
+    /** \brief Make a grid with the given options
+       \param L extension of the domain
+       \param comm the collective communication object for this grid
+       \param options load balancer, backend, mapping, ordering, halo and threads, see YaspGridOptions
+     */
+    StaticYaspGrid (Dune::FieldVector<ctype, dim> L,
+                    CollectiveCommunicationType comm,
+                    const YaspGridOptions<dim>& options)
+      : Base(L, std::array<int, dim>{{N...}}, std::bitset<dim>(periodic), overlap, comm, options)
+    {}
+  };
+
+  /** \brief Compile-time sized access to the box of cells of a level of a StaticYaspGrid on one process
+
+     The counterpart of YaspStructuredAccess for a StaticYaspGrid living on a
+     single process. The extents, strides and interior bounds of the box are
+     constant expressions, so the compiler folds the index arithmetic and
+     knows the trip counts of the loops. The box of level l has cells(i)<<l
+     interior cells in direction i and, in periodic directions, overlap<<l
+     overlap cells on both sides, as the overlap is kept on refinement by
+     default. The constructor checks this against the grid and throws a
+     GridError otherwise, e.g. if the grid is distributed.
+
+     \code
+     YaspStaticAccess<Grid> s(grid);
+     s.forEachInterior([&](int k)
+     {
+       r[k] = 4*u[k] - u[k-1] - u[k+1] - u[k-s.stride(1)] - u[k+s.stride(1)];
+     });
+     \endcode
+
+     \tparam GridImp the StaticYaspGrid type
+     \tparam level the level of the grid
+   */
+  template<class GridImp, int level = 0>
+  class YaspStaticAccess
+  {
+    enum { dim = GridImp::dim };
+  public:
+    typedef std::array<int, dim> iTupel;
+    typedef typename GridImp::ctype ctype;
+
+    //! access the cells of the level, which must have the extents known at compile time
+    explicit YaspStaticAccess (const GridImp& grid)
+    {
+      if (grid.maxLevel() < level)
+        DUNE_THROW(GridError, "YaspStaticAccess of level " << level << " of a grid with maxLevel " << grid.maxLevel());
+      auto g = grid.begin(level);
+      if (g->mg->ordering() != YaspOrdering::lexicographic)
+        DUNE_THROW(GridError, "YaspStaticAccess requires the lexicographic numbering of the cells");
+
+      const auto& all = *g->overlapfront[0].dataBegin();
+      const auto& interior = *g->interior[0].dataBegin();
+      for (int i=0; i<dim; i++)
+      {
+        if (all.size(i) != size(i) || all.superincrement(i) != stride(i)
+            || interior.origin(i) - all.origin(i) != interiorBegin(i) || interior.size(i) != interiorEnd(i) - interiorBegin(i))
+          DUNE_THROW(GridError, "The cells of level " << level << " on this process do not have the extents of the StaticYaspGrid");
+
+        // the coordinates are equidistant
+        _meshsize[i] = g->coords.meshsize(i, all.origin(i));
+        _lower[i] = g->coords.coordinate(i, all.origin(i));
+      }
+    }
+
+    //! return the number of interior cells in direction i
+    static constexpr int interiorSize (int i)
+    {
+      return GridImp::cells(i) << level;
+    }
+
+    //! return the number of overlap cells on each side in direction i
+    static constexpr int overlapSize (int i)
+    {
+      return GridImp::isPeriodic(i) ? (GridImp::overlapCells() << level) : 0;
+    }
+
+    //! return the number of cells of the box in direction i
+    static constexpr int size (int i)
+    {
+      return interiorSize(i) + 2*overlapSize(i);
+    }
+
+    //! return the total number of cells of the box, i.e. the size of the index set
+    static constexpr int count ()
+    {
+      int n = 1;
+      for (int i=0; i<dim; i++)
+        n *= size(i);
+      return n;
+    }
+
+    //! return the difference of the indices of neighboring cells in direction i
+    static constexpr int stride (int i)
+    {
+      int s = 1;
+      for (int j=0; j<i; j++)
+        s *= size(j);
+      return s;
+    }
+
+    //! return the first local coordinate of the interior cells in direction i
+    static constexpr int interiorBegin (int i)
+    {
+      return overlapSize(i);
+    }
+
+    //! return one past the last local coordinate of the interior cells in direction i
+    static constexpr int interiorEnd (int i)
+    {
+      return overlapSize(i) + interiorSize(i);
+    }
+
+    //! return the index of the cell with the given local coordinates
+    static constexpr int index (const iTupel& coord)
+    {
+      int k = 0;
+      for (int i=0; i<dim; i++)
+        k += coord[i]*stride(i);
+      return k;
+    }
+
+    //! return the local coordinates of the cell with the given index
+    static iTupel coord (int index)
+    {
+      iTupel c;
+      for (int i=0; i<dim; i++)
+      {
+        c[i] = index % size(i);
+        index /= size(i);
+      }
+      return c;
+    }
+
+    //! return the width of the cells in direction i
+    ctype meshsize (int i) const
+    {
+      return _meshsize[i];
+    }
+
+    //! return the lower coordinate in direction i of the cells with local coordinate k
+    ctype lower (int i, int k) const
+    {
+      return _lower[i] + k*_meshsize[i];
+    }
+
+    /** \brief call f for the index of each interior cell
+
+       The cells are visited lexicographically with direction 0 running
+       fastest. All loop bounds are constant expressions.
+     */
+    template<class F>
+    void forEachInterior (F&& f) const
+    {
+      loop<dim-1>(0, f, std::integral_constant<bool, (dim > 1)>());
+    }
+
+    /** \brief call f for the index of each cell of the box, including the overlap
+     */
+    template<class F>
+    void forEach (F&& f) const
+    {
+      for (int k=0; k<count(); k++)
+        f(k);
+    }
+
+  private:
+    //! loop over direction d > 0
+    template<int d, class F>
+    static void loop (int offset, F& f, std::true_type)
+    {
+      for (int c=interiorBegin(d); c<interiorEnd(d); c++)
+        loop<d-1>(offset + c*stride(d), f, std::integral_constant<bool, (d > 1)>());
+    }
+
+    //! loop over a row in direction 0
+    template<int d, class F>
+    static void loop (int offset, F& f, std::false_type)
+    {
+      const int begin = offset + interiorBegin(0);
+      const int end = offset + interiorEnd(0);
+      for (int k=begin; k<end; k++)
+        f(k);
+    }
+
+    std::array<ctype, dim> _meshsize;
+    std::array<ctype, dim> _lower;
+  };
+
+}   // namespace Dune
+
+#endif  // DUNE_GRID_YASPGRIDSTATIC_HH
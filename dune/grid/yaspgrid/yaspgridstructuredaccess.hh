@@ -0,0 +1,320 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRIDSTRUCTUREDACCESS_HH
+#define DUNE_GRID_YASPGRIDSTRUCTUREDACCESS_HH
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+/** \file
+ * \brief The YaspStructuredAccess class
+ */
+
+namespace Dune {
+
+  /** \brief A pack of consecutive cells in direction 0 of a YaspGrid level, in structure of arrays form
+
+     Filled by YaspStructuredAccess::forEachBatch(). Only the first size() lanes
+     are cells of the batch, the remaining lanes repeat the last cell, so that
+     kernels may always process all N lanes.
+
+     \tparam ct the coordinate type
+     \tparam dim the dimension
+     \tparam N the number of lanes, e.g. the SIMD width
+   */
+  template<class ct, int dim, int N>
+  struct YaspCellBatch
+  {
+    //! the number of cells in the batch, at most N
+    int size () const
+    {
+      return count;
+    }
+
+    //! the number of valid lanes
+    int count;
+    //! the indices of the cells in the level index set
+    std::array<int, N> index;
+    //! lowerLeft[i][j] is the coordinate of the lower left corner of cell j in direction i
+    std::array<std::array<ct, N>, dim> lowerLeft;
+    //! extent[i][j] is the width of cell j in direction i
+    std::array<std::array<ct, N>, dim> extent;
+  };
+
+  /** \brief Direct access to the box of cells of a YaspGrid level on one process
+
+     The cells of a YaspGrid level on one process, including the overlap, form
+     a box. Their index in the level index set, and in the leaf index set on the
+     finest level, is lexicographic in this box with direction 0 running fastest.
+     This class exposes the extents and strides of the box, so that stencil
+     operations on arrays indexed by the index set can be written as nested loops
+     over contiguous memory, without entities, geometries and intersections.
+
+     Local coordinates run from 0 to size(i)-1 in each direction, the neighbor of
+     the cell with index k in direction i is k+stride(i) or k-stride(i), if it is
+     inside the box. The object is valid as long as the grid is not modified.
+     It requires the lexicographic numbering of the cells, see YaspOrdering.
+
+     \code
+     YaspStructuredAccess<Grid> s(grid);
+     for (int j=s.interiorBegin(1); j<s.interiorEnd(1); j++)
+     {
+       int k = s.index({{s.interiorBegin(0), j}});
+       for (int i=s.interiorBegin(0); i<s.interiorEnd(0); i++, k++)
+         r[k] = 4*u[k] - u[k-1] - u[k+1] - u[k-s.stride(1)] - u[k+s.stride(1)];
+     }
+     \endcode
+
+     \tparam GridImp the YaspGrid type
+   */
+  template<class GridImp>
+  class YaspStructuredAccess
+  {
+    enum { dim = GridImp::dimension };
+    typedef typename GridImp::YGridLevelIterator YGridLevelIterator;
+  public:
+    typedef std::array<int, dim> iTupel;
+    typedef typename GridImp::ctype ctype;
+
+    //! access the cells of the given level
+    YaspStructuredAccess (const GridImp& grid, int level)
+    {
+      init(grid.begin(level));
+    }
+
+    //! access the cells of the leaf grid, i.e. of the finest level
+    explicit YaspStructuredAccess (const GridImp& grid)
+    {
+      init(grid.begin(grid.maxLevel()));
+    }
+
+    //! return the level
+    int level () const
+    {
+      return _g->level();
+    }
+
+    //! return the global coordinate of the cells with local coordinate 0 in direction i
+    int origin (int i) const
+    {
+      return _origin[i];
+    }
+
+    //! return the number of cells of the box in direction i
+    int size (int i) const
+    {
+      return _size[i];
+    }
+
+    //! return the number of cells of the box in all directions
+    const iTupel& size () const
+    {
+      return _size;
+    }
+
+    //! return the total number of cells of the box, i.e. the size of the index set
+    int count () const
+    {
+      return _count;
+    }
+
+    //! return the difference of the indices of neighboring cells in direction i
+    int stride (int i) const
+    {
+      return _stride[i];
+    }
+
+    //! return the first local coordinate of the interior cells in direction i
+    int interiorBegin (int i) const
+    {
+      return _interiorBegin[i];
+    }
+
+    //! return one past the last local coordinate of the interior cells in direction i
+    int interiorEnd (int i) const
+    {
+      return _interiorEnd[i];
+    }
+
+    //! return the index of the cell with the given local coordinates
+    int index (const iTupel& coord) const
+    {
+      int k = 0;
+      for (int i=0; i<dim; i++)
+        k += coord[i]*_stride[i];
+      return k;
+    }
+
+    //! return the local coordinates of the cell with the given index
+    iTupel coord (int index) const
+    {
+      iTupel c;
+      for (int i=0; i<dim; i++)
+      {
+        c[i] = index % _size[i];
+        index /= _size[i];
+      }
+      return c;
+    }
+
+    //! return the index of the cell offset cells away from a cell in direction i, it has to be inside the box
+    int neighbor (int index, int i, int offset) const
+    {
+      return index + offset*_stride[i];
+    }
+
+    //! return true if the local coordinates are inside the box
+    bool contains (const iTupel& coord) const
+    {
+      for (int i=0; i<dim; i++)
+        if (coord[i] < 0 || coord[i] >= _size[i])
+          return false;
+      return true;
+    }
+
+    //! return the width in direction i of the cells with local coordinate k
+    ctype meshsize (int i, int k) const
+    {
+      return _width[i][k];
+    }
+
+    //! return the lower coordinate in direction i of the cells with local coordinate k
+    ctype lower (int i, int k) const
+    {
+      return _lower[i][k];
+    }
+
+    /** \brief call f for packs of N consecutive cells of a partition
+
+       The cells are visited in rows along direction 0, each row is split into
+       batches of N cells, the last one may be smaller. The partition types of
+       YaspGrid cells are interior and overlap, or interior and ghost, see
+       YaspHalo. Interior_Partition and InteriorBorder_Partition visit the
+       interior cells, All_Partition all cells. With an overlap halo
+       Overlap_Partition and OverlapFront_Partition visit all cells and
+       Ghost_Partition none, with a ghost halo Overlap_Partition and
+       OverlapFront_Partition visit the interior cells and Ghost_Partition the
+       halo cells.
+
+       \tparam N the number of cells per batch
+       \param f called with a const YaspCellBatch<ctype,dim,N>&
+     */
+    template<int N, class F>
+    void forEachBatch (PartitionIteratorType pitype, F&& f) const
+    {
+      const bool ghosts = _g->ghosts;
+      if (pitype == Ghost_Partition && !ghosts)
+        return;
+
+      const bool interior = (pitype == Interior_Partition || pitype == InteriorBorder_Partition
+                             || (ghosts && pitype != All_Partition && pitype != Ghost_Partition));
+      iTupel begin, end;
+      for (int i=0; i<dim; i++)
+      {
+        begin[i] = interior ? _interiorBegin[i] : 0;
+        end[i] = interior ? _interiorEnd[i] : _size[i];
+        if (begin[i] >= end[i])
+          return;
+      }
+
+      YaspCellBatch<ctype,dim,N> batch;
+      iTupel c(begin);
+      while (true)
+      {
+        // the coordinates in directions 1,...,dim-1 are the same for the whole row
+        bool interiorRow = true;
+        for (int i=1; i<dim; i++)
+        {
+          batch.lowerLeft[i].fill(_lower[i][c[i]]);
+          batch.extent[i].fill(_width[i][c[i]]);
+          interiorRow = interiorRow && (c[i] >= _interiorBegin[i]) && (c[i] < _interiorEnd[i]);
+        }
+
+        // the ghost cells of a row passing the interior are the two pieces beside it
+        const int row = index(c) - c[0];
+        if (pitype == Ghost_Partition && interiorRow)
+        {
+          batchRow<N>(row, begin[0], _interiorBegin[0], batch, f);
+          batchRow<N>(row, _interiorEnd[0], end[0], batch, f);
+        }
+        else
+          batchRow<N>(row, begin[0], end[0], batch, f);
+
+        // next row
+        int i = 1;
+        for ( ; i<dim; i++)
+        {
+          if (++c[i] < end[i])
+            break;
+          c[i] = begin[i];
+        }
+        if (i == dim)
+          return;
+      }
+    }
+
+  private:
+    //! call f for the batches of the cells [first,last) in direction 0 of a row
+    template<int N, class F>
+    void batchRow (int row, int first, int last, YaspCellBatch<ctype,dim,N>& batch, F& f) const
+    {
+      const YaspCellBatch<ctype,dim,N>& result = batch;
+      for (int x=first; x<last; x+=N)
+      {
+        batch.count = std::min(N, last-x);
+        for (int j=0; j<N; j++)
+        {
+          const int k = x + std::min(j, batch.count-1);
+          batch.index[j] = row + k;
+          batch.lowerLeft[0][j] = _lower[0][k];
+          batch.extent[0][j] = _width[0][k];
+        }
+        f(result);
+      }
+    }
+
+    void init (YGridLevelIterator g)
+    {
+      if (g->mg->ordering() != YaspOrdering::lexicographic)
+        DUNE_THROW(GridError, "YaspStructuredAccess requires the lexicographic numbering of the cells");
+
+      _g = g;
+      // the cells of a level consist of a single component
+      const auto& all = *g->overlapfront[0].dataBegin();
+      const auto& interior = *g->interior[0].dataBegin();
+      _count = 1;
+      for (int i=0; i<dim; i++)
+      {
+        _origin[i] = all.origin(i);
+        _size[i] = all.size(i);
+        _stride[i] = all.superincrement(i);
+        _interiorBegin[i] = interior.origin(i) - all.origin(i);
+        _interiorEnd[i] = _interiorBegin[i] + interior.size(i);
+        _count *= _size[i];
+
+        // the coordinates of the box, taken once from the coordinate container
+        _lower[i].resize(_size[i]);
+        _width[i].resize(_size[i]);
+        for (int k=0; k<_size[i]; k++)
+        {
+          _lower[i][k] = g->coords.coordinate(i, _origin[i]+k);
+          _width[i][k] = g->coords.meshsize(i, _origin[i]+k);
+        }
+      }
+    }
+
+    YGridLevelIterator _g;
+    iTupel _origin;
+    iTupel _size;
+    iTupel _stride;
+    iTupel _interiorBegin;
+    iTupel _interiorEnd;
+    int _count;
+    std::array<std::vector<ctype>, dim> _lower;
+    std::array<std::vector<ctype>, dim> _width;
+  };
+
+}   // namespace Dune
+
+#endif  // DUNE_GRID_YASPGRIDSTRUCTUREDACCESS_HH
@@ -0,0 +1,148 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/** \file
+ * \brief Compare the insertion of single entities into a grid factory with the bulk insertion
+ *
+ * Usage: gridfactory-insertion [OneDGrid elements] [UGGrid cells per direction]
+ *
+ * A OneDGrid on the unit interval and, if UG is available, a structured 2d
+ * simplex UGGrid are inserted into their factories, once vertex by vertex
+ * and element by element, and once with reserve(), insertVertices() and
+ * insertElements() from flat arrays. The times of the insertion and of
+ * createGrid() are reported.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/grid/onedgrid.hh>
+#if HAVE_UG
+#include <dune/grid/uggrid.hh>
+#endif
+
+// insert the grid into a factory and create it, the times are added to insertTime and createTime
+template<class Grid>
+std::size_t createGrid (const std::vector<double>& coordinates, const Dune::GeometryType& type,
+                        const std::vector<unsigned int>& connectivity, bool bulk,
+                        double& insertTime, double& createTime)
+{
+  const int dimworld = Grid::dimensionworld;
+  const std::size_t numVertices = coordinates.size()/dimworld;
+  const std::size_t numCorners = type.isSimplex() ? type.dim()+1 : 1u << type.dim();
+  const std::size_t numElements = connectivity.size()/numCorners;
+
+  Dune::Timer timer;
+  Dune::GridFactory<Grid> factory;
+  if (bulk)
+  {
+    factory.reserve(numVertices, numElements);
+    factory.insertVertices(coordinates.data(), numVertices);
+    factory.insertElements(type, connectivity.data(), numElements);
+  }
+  else
+  {
+    Dune::FieldVector<double,dimworld> pos;
+    for (std::size_t i=0; i<numVertices; i++)
+    {
+      for (int j=0; j<dimworld; j++)
+        pos[j] = coordinates[i*dimworld+j];
+      factory.insertVertex(pos);
+    }
+    for (std::size_t i=0; i<numElements; i++)
+      factory.insertElement(type, std::vector<unsigned int>(connectivity.begin()+i*numCorners,
+                                                            connectivity.begin()+(i+1)*numCorners));
+  }
+  insertTime += timer.elapsed();
+
+  timer.reset();
+  std::unique_ptr<Grid> grid(factory.createGrid());
+  createTime += timer.elapsed();
+
+  return grid->size(0);
+}
+
+template<class Grid>
+void compare (const std::string& name, const std::vector<double>& coordinates, const Dune::GeometryType& type,
+              const std::vector<unsigned int>& connectivity)
+{
+  double singleInsert = 0.0, singleCreate = 0.0, bulkInsert = 0.0, bulkCreate = 0.0;
+  std::size_t singleSize = createGrid<Grid>(coordinates, type, connectivity, false, singleInsert, singleCreate);
+  std::size_t bulkSize = createGrid<Grid>(coordinates, type, connectivity, true, bulkInsert, bulkCreate);
+
+  std::cout << name << " with " << singleSize << " elements" << std::endl;
+  std::cout << "  single insertion: " << singleInsert << " s, createGrid: " << singleCreate << " s" << std::endl;
+  std::cout << "  bulk insertion:   " << bulkInsert << " s, createGrid: " << bulkCreate << " s" << std::endl;
+  if (singleSize != bulkSize)
+    std::cout << "  the grids differ, the bulk grid has " << bulkSize << " elements" << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper::instance(argc, argv);
+
+    int onedElements = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+    int cells = (argc > 2) ? std::atoi(argv[2]) : 256;
+
+    // a OneDGrid of the unit interval
+    {
+      std::vector<double> coordinates(onedElements+1);
+      for (int i=0; i<=onedElements; i++)
+        coordinates[i] = double(i)/onedElements;
+      std::vector<unsigned int> connectivity(2*onedElements);
+      for (int i=0; i<onedElements; i++)
+      {
+        connectivity[2*i] = i;
+        connectivity[2*i+1] = i+1;
+      }
+      compare<Dune::OneDGrid>("OneDGrid", coordinates, Dune::GeometryType(Dune::GeometryType::simplex, 1), connectivity);
+    }
+
+#if HAVE_UG
+    // the unit square, each square of the structured grid split into two triangles
+    {
+      std::vector<double> coordinates;
+      coordinates.reserve(2*(cells+1)*(cells+1));
+      for (int j=0; j<=cells; j++)
+        for (int i=0; i<=cells; i++)
+        {
+          coordinates.push_back(double(i)/cells);
+          coordinates.push_back(double(j)/cells);
+        }
+      std::vector<unsigned int> connectivity;
+      connectivity.reserve(6*cells*cells);
+      for (int j=0; j<cells; j++)
+        for (int i=0; i<cells; i++)
+        {
+          unsigned int v = j*(cells+1) + i;
+          unsigned int triangles[6] = {v, v+1, v+cells+1, v+1, v+cells+2, v+cells+1};
+          connectivity.insert(connectivity.end(), triangles, triangles+6);
+        }
+      compare<Dune::UGGrid<2> >("UGGrid<2>", coordinates, Dune::GeometryType(Dune::GeometryType::simplex, 2), connectivity);
+    }
+#else
+    std::cout << "UG is not available, the UGGrid with " << cells << " cells per direction is skipped" << std::endl;
+#endif
+  }
+  catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/** \file
+ * \brief Measure the index update of UGGrid after local refinement
+ *
+ * Usage: uggrid-adapt [cells per direction] [steps]
+ *
+ * A structured 2d simplex grid is refined around a point moving along the
+ * diagonal of the domain: in each step the leaf elements next to the point
+ * are refined, and those next to its previous position are coarsened. The
+ * time of adapt(), which updates the index sets incrementally, is compared
+ * with the time of renumbering the leaf index set from scratch.
+ */
+
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/utility/structuredgridfactory.hh>
+
+const int dim = 2;
+typedef Dune::UGGrid<dim> Grid;
+typedef Dune::UGGridLeafIndexSet<const Grid> LeafIndexSet;
+
+// mark the leaf elements whose center is closer than radius to the point
+void markAround (Grid& grid, const Dune::FieldVector<double,dim>& point, double radius, int refCount)
+{
+  for (const auto& element : elements(grid.leafGridView()))
+    if ((element.geometry().center() - point).two_norm() < radius)
+      grid.mark(refCount, element);
+}
+
+int main (int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper::instance(argc, argv);
+
+    int cells = (argc > 1) ? std::atoi(argv[1]) : 256;
+    int steps = (argc > 2) ? std::atoi(argv[2]) : 20;
+
+    std::cout << "UGGrid<" << dim << "> with 2*" << cells << "^" << dim << " triangles, "
+              << steps << " local adaptation steps" << std::endl;
+
+    Dune::FieldVector<double,dim> lower(0.0), upper(1.0);
+    std::array<unsigned int,dim> elements;
+    elements.fill(cells);
+    std::shared_ptr<Grid> grid = Dune::StructuredGridFactory<Grid>::createSimplexGrid(lower, upper, elements);
+
+    const double radius = 2.0/cells;
+    Dune::FieldVector<double,dim> previous(-1.0);
+    double adaptTime = 0.0, renumberTime = 0.0;
+    for (int step=0; step<steps; step++)
+    {
+      Dune::FieldVector<double,dim> point(double(step+1)/(steps+1));
+
+      // refine twice around the point, the old refinement is coarsened
+      for (int k=0; k<2; k++)
+      {
+        markAround(*grid, point, radius, 1);
+        markAround(*grid, previous, radius, -1);
+        grid->preAdapt();
+        Dune::Timer timer;
+        grid->adapt();
+        adaptTime += timer.elapsed();
+        grid->postAdapt();
+      }
+      previous = point;
+
+      Dune::Timer timer;
+      const_cast<LeafIndexSet&>(static_cast<const LeafIndexSet&>(grid->leafIndexSet())).update();
+      renumberTime += timer.elapsed();
+    }
+
+    std::cout << "leaf elements after the last step: " << grid->leafGridView().size(0) << std::endl;
+    std::cout << "adapt with incremental index update: " << adaptTime/(2*steps)*1e3 << " ms per call" << std::endl;
+    std::cout << "full leaf index renumbering:         " << renumberTime/steps*1e3 << " ms per call" << std::endl;
+  }
+  catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
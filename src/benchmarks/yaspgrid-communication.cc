@@ -0,0 +1,116 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/** \file
+ * \brief Compare the halo exchange of YaspGrid for the different Torus backends
+ *
+ * Usage: yaspgrid-communication [cells per direction] [iterations]
+ *
+ * For each backend a 3d grid is created and one double per cell is exchanged
+ * repeatedly over the InteriorBorder_All_Interface. The maximum time over all
+ * processes is reported.
+ */
+
+#include <bitset>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+const int dim = 3;
+typedef Dune::YaspGrid<dim> Grid;
+
+// communicates one double per cell
+template<class GridView>
+class CellDataHandle
+  : public Dune::CommDataHandleIF<CellDataHandle<GridView>, double>
+{
+public:
+  CellDataHandle (const GridView& gv, std::vector<double>& data)
+    : _gv(gv), _data(data)
+  {}
+
+  bool contains (int, int codim) const { return codim == 0; }
+  bool fixedSize (int, int) const { return true; }
+
+  template<class E>
+  std::size_t size (const E&) const { return 1; }
+
+  template<class Buf, class E>
+  void gather (Buf& buf, const E& e) const
+  {
+    buf.write(_data[_gv.indexSet().index(e)]);
+  }
+
+  template<class Buf, class E>
+  void scatter (Buf& buf, const E& e, std::size_t)
+  {
+    buf.read(_data[_gv.indexSet().index(e)]);
+  }
+
+private:
+  const GridView& _gv;
+  std::vector<double>& _data;
+};
+
+void run (Dune::TorusBackend backend, const std::string& name, int cells, int iterations)
+{
+  Dune::FieldVector<double,dim> L(1.0);
+  std::array<int,dim> s;
+  std::fill(s.begin(), s.end(), cells);
+  Grid grid(L, s, std::bitset<dim>(0ULL), 1, Grid::CollectiveCommunicationType(),
+            Grid::defaultLoadbalancer(), backend);
+  auto gv = grid.leafGridView();
+
+  std::vector<double> data(gv.size(0), 1.0);
+  CellDataHandle<Grid::LeafGridView> handle(gv, data);
+
+  // warm up, this sets up the cached communication plan
+  gv.communicate(handle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+
+  grid.comm().barrier();
+  Dune::Timer timer;
+  for (int i=0; i<iterations; i++)
+    gv.communicate(handle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+  double time = grid.comm().max(timer.elapsed());
+
+  if (grid.comm().rank() == 0)
+    std::cout << name << ": " << time/iterations*1e6 << " us per exchange" << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
+
+    int cells = (argc > 1) ? std::atoi(argv[1]) : 64;
+    int iterations = (argc > 2) ? std::atoi(argv[2]) : 100;
+
+    if (helper.rank() == 0)
+      std::cout << "YaspGrid<" << dim << "> with " << cells << "^" << dim << " cells on "
+                << helper.size() << " processes, " << iterations << " iterations" << std::endl;
+
+    run(Dune::TorusBackend::pointToPoint, "point to point", cells, iterations);
+    run(Dune::TorusBackend::neighborhood, "neighborhood  ", cells, iterations);
+    run(Dune::TorusBackend::sharedMemory, "shared memory ", cells, iterations);
+  }
+  catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
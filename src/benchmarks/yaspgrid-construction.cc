@@ -0,0 +1,85 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/** \file
+ * \brief Measure the construction time of YaspGrid levels for different numbers of threads
+ *
+ * Usage: yaspgrid-construction [cells per direction] [maximum number of threads]
+ *
+ * For the numberings along space filling curves and for 1, 2, 4, ... threads
+ * a 3d grid is created and refined once. The maximum time over all processes
+ * is reported. The lexicographic numbering, which does not use the threads,
+ * is measured once for comparison.
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+const int dim = 3;
+typedef Dune::YaspGrid<dim> Grid;
+
+int main (int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
+
+    int cells = (argc > 1) ? std::atoi(argv[1]) : 64;
+    int maxThreads = (argc > 2) ? std::atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+    if (helper.rank() == 0)
+      std::cout << "YaspGrid<" << dim << "> with " << cells << "^" << dim << " cells on "
+                << helper.size() << " processes, refined once" << std::endl;
+
+    Dune::FieldVector<double,dim> L(1.0);
+    std::array<int,dim> size;
+    std::fill(size.begin(), size.end(), cells);
+
+    const Dune::YaspOrdering orderings[] = { Dune::YaspOrdering::lexicographic, Dune::YaspOrdering::morton,
+                                             Dune::YaspOrdering::hilbert };
+    const std::string names[] = { "lexicographic", "morton", "hilbert" };
+    for (int o=0; o<3; o++)
+      for (int threads=1; threads<=(o == 0 ? 1 : maxThreads); threads*=2)
+      {
+        Grid::CollectiveCommunicationType comm;
+        comm.barrier();
+        Dune::YaspGridOptions<dim> options;
+        options.ordering = orderings[o];
+        options.threads = threads;
+        Dune::Timer timer;
+        Grid grid(L, size, std::bitset<dim>(0ULL), 1, comm, options);
+        double constructionTime = grid.comm().max(timer.elapsed());
+
+        grid.comm().barrier();
+        timer.reset();
+        grid.globalRefine(1);
+        double refineTime = grid.comm().max(timer.elapsed());
+
+        if (helper.rank() == 0)
+          std::cout << names[o] << ", " << threads << " threads: construction "
+                    << constructionTime*1e3 << " ms, globalRefine " << refineTime*1e3 << " ms" << std::endl;
+      }
+  }
+  catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
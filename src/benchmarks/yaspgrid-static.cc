@@ -0,0 +1,179 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/** \file
+ * \brief Compare YaspGrid with runtime extents and StaticYaspGrid with extents known at compile time
+ *
+ * Usage: yaspgrid-static [iterations]
+ *
+ * A periodic 3d grid of 64^3 cells with overlap 1 is created once as YaspGrid
+ * and once as StaticYaspGrid, each process creates its own sequential grid.
+ * The residual of the 7-point Laplacian is applied to a vector indexed by the
+ * level index set, via the iterators of the runtime grid, via the loops of
+ * YaspStructuredAccess and via the constant loop bounds of YaspStaticAccess.
+ * Then the index of every cell is computed from its coordinates with both
+ * accessors. The results are compared and the times of rank 0 are reported.
+ */
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+const int dim = 3;
+const int cells = 64;
+typedef Dune::YaspGrid<dim> Grid;
+typedef Dune::StaticYaspGrid<1, 7u, cells, cells, cells> StaticGrid;
+typedef Dune::YaspStaticAccess<StaticGrid> StaticAccess;
+
+// apply the stencil with the level iterator and the index set, the neighbors are found by the strides of the box
+void applyIterators (const Grid::LevelGridView& gv, const Dune::YaspStructuredAccess<Grid>& s,
+                     const std::vector<double>& u, std::vector<double>& r)
+{
+  const double h2 = 1.0/(s.meshsize(0,0)*s.meshsize(0,0));
+  for (const auto& e : elements(gv, Dune::Partitions::interior))
+  {
+    const int k = gv.indexSet().index(e);
+    double sum = 0.0;
+    for (int i=0; i<dim; i++)
+      sum += h2*(2*u[k] - u[k-s.stride(i)] - u[k+s.stride(i)]);
+    r[k] = sum;
+  }
+}
+
+// apply the stencil with nested loops, the bounds and strides are runtime values
+void applyStructured (const Dune::YaspStructuredAccess<Grid>& s, const std::vector<double>& u, std::vector<double>& r)
+{
+  const double h2 = 1.0/(s.meshsize(0,0)*s.meshsize(0,0));
+  const int sy = s.stride(1);
+  const int sz = s.stride(2);
+  for (int z=s.interiorBegin(2); z<s.interiorEnd(2); z++)
+    for (int y=s.interiorBegin(1); y<s.interiorEnd(1); y++)
+    {
+      const int begin = s.index({{s.interiorBegin(0), y, z}});
+      const int end = begin + s.interiorEnd(0) - s.interiorBegin(0);
+      for (int k=begin; k<end; k++)
+        r[k] = h2*(6*u[k] - u[k-1] - u[k+1] - u[k-sy] - u[k+sy] - u[k-sz] - u[k+sz]);
+    }
+}
+
+// apply the stencil with constant loop bounds and strides
+void applyStatic (const StaticAccess& s, const std::vector<double>& u, std::vector<double>& r)
+{
+  const double h2 = 1.0/(s.meshsize(0)*s.meshsize(0));
+  const double* v = u.data();
+  double* w = r.data();
+  s.forEachInterior([=](int k)
+  {
+    w[k] = h2*(6*v[k] - v[k-1] - v[k+1] - v[k-StaticAccess::stride(1)] - v[k+StaticAccess::stride(1)]
+               - v[k-StaticAccess::stride(2)] - v[k+StaticAccess::stride(2)]);
+  });
+}
+
+// sum of the indices computed from the coordinates of all cells
+template<class Access>
+long indexSum (const Access& s)
+{
+  long sum = 0;
+  std::array<int,dim> c;
+  for (c[2]=0; c[2]<s.size(2); c[2]++)
+    for (c[1]=0; c[1]<s.size(1); c[1]++)
+      for (c[0]=0; c[0]<s.size(0); c[0]++)
+        sum += s.index(c);
+  return sum;
+}
+
+int main (int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
+
+    int iterations = (argc > 1) ? std::atoi(argv[1]) : 10;
+
+    if (helper.rank() == 0)
+      std::cout << "periodic YaspGrid<" << dim << "> with " << cells << "^" << dim << " cells, "
+                << iterations << " iterations" << std::endl;
+
+#if HAVE_MPI
+    Grid::CollectiveCommunicationType comm(MPI_COMM_SELF);
+#else
+    Grid::CollectiveCommunicationType comm;
+#endif
+    Dune::FieldVector<double,dim> L(1.0);
+    std::array<int,dim> size;
+    std::fill(size.begin(), size.end(), cells);
+    Grid grid(L, size, std::bitset<dim>(7u), 1, comm);
+    StaticGrid staticGrid(L, comm);
+    auto gv = grid.levelGridView(0);
+    Dune::YaspStructuredAccess<Grid> s(grid, 0);
+    StaticAccess t(staticGrid);
+
+    std::vector<double> u(gv.size(0));
+    for (std::size_t k=0; k<u.size(); k++)
+      u[k] = std::sin(0.1*k);
+    std::vector<double> r1(u.size(), 0.0), r2(u.size(), 0.0), r3(u.size(), 0.0);
+
+    Dune::Timer timer;
+    for (int i=0; i<iterations; i++)
+      applyIterators(gv, s, u, r1);
+    double iteratorTime = timer.elapsed();
+
+    timer.reset();
+    for (int i=0; i<iterations; i++)
+      applyStructured(s, u, r2);
+    double structuredTime = timer.elapsed();
+
+    timer.reset();
+    for (int i=0; i<iterations; i++)
+      applyStatic(t, u, r3);
+    double staticTime = timer.elapsed();
+
+    long runtimeSum = 0, staticSum = 0;
+    timer.reset();
+    for (int i=0; i<iterations; i++)
+      runtimeSum += indexSum(s);
+    double runtimeIndexTime = timer.elapsed();
+
+    timer.reset();
+    for (int i=0; i<iterations; i++)
+      staticSum += indexSum(t);
+    double staticIndexTime = timer.elapsed();
+
+    double difference = 0.0;
+    for (std::size_t k=0; k<u.size(); k++)
+      difference = std::max(difference, std::max(std::abs(r1[k] - r3[k]), std::abs(r2[k] - r3[k])));
+
+    if (helper.rank() == 0)
+    {
+      std::cout << "iterators:                  " << iteratorTime/iterations*1e3 << " ms per application" << std::endl;
+      std::cout << "runtime structured access:  " << structuredTime/iterations*1e3 << " ms per application" << std::endl;
+      std::cout << "static access:              " << staticTime/iterations*1e3 << " ms per application" << std::endl;
+      std::cout << "runtime index computation:  " << runtimeIndexTime/iterations*1e3 << " ms per sweep" << std::endl;
+      std::cout << "static index computation:   " << staticIndexTime/iterations*1e3 << " ms per sweep" << std::endl;
+      std::cout << "maximum difference " << difference
+                << ", index sums " << (runtimeSum == staticSum ? "agree" : "differ") << std::endl;
+    }
+  }
+  catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
@@ -0,0 +1,154 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/** \file
+ * \brief Compare a 7-point stencil on YaspGrid via iterators and via YaspStructuredAccess
+ *
+ * Usage: yaspgrid-stencil [cells per direction] [iterations]
+ *
+ * The residual of the finite volume Laplacian is applied to a vector indexed by
+ * the leaf index set, once by iterating over the interior cells and their
+ * intersections, and once by nested loops over the box of YaspStructuredAccess.
+ * Both results are compared and the maximum time over all processes is reported.
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/grid/yaspgrid.hh>
+
+const int dim = 3;
+typedef Dune::YaspGrid<dim> Grid;
+
+// apply the stencil with entity, geometry and intersection objects
+void applyIterators (const Grid::LeafGridView& gv, const std::vector<double>& u, std::vector<double>& r)
+{
+  for (const auto& e : elements(gv, Dune::Partitions::interior))
+  {
+    const int k = gv.indexSet().index(e);
+    const double volume = e.geometry().volume();
+    double sum = 0.0;
+    for (const auto& is : intersections(gv, e))
+    {
+      if (!is.neighbor())
+        continue;
+      const auto& outside = is.outside();
+      const double distance = (outside.geometry().center() - e.geometry().center()).two_norm();
+      sum += is.geometry().volume()/distance*(u[k] - u[gv.indexSet().index(outside)]);
+    }
+    r[k] = sum/volume;
+  }
+}
+
+// apply the stencil with nested loops over contiguous memory
+void applyStructured (const Dune::YaspStructuredAccess<Grid>& s, const std::vector<double>& u, std::vector<double>& r)
+{
+  std::array<double,dim> coeff;
+  for (int i=0; i<dim; i++)
+    coeff[i] = 1.0/(s.meshsize(i,0)*s.meshsize(i,0));
+
+  // neighbors outside of the domain do not contribute
+  std::array<int,dim> lower, upper;
+  for (int i=0; i<dim; i++)
+  {
+    lower[i] = (s.origin(i) + s.interiorBegin(i) > 0) ? 1 : 0;
+    upper[i] = (s.interiorEnd(i) < s.size(i)) ? 1 : 0;
+  }
+
+  const int sy = s.stride(1);
+  const int sz = s.stride(2);
+  for (int z=s.interiorBegin(2); z<s.interiorEnd(2); z++)
+    for (int y=s.interiorBegin(1); y<s.interiorEnd(1); y++)
+    {
+      const bool down = (y > s.interiorBegin(1)) || lower[1];
+      const bool up = (y < s.interiorEnd(1)-1) || upper[1];
+      const bool back = (z > s.interiorBegin(2)) || lower[2];
+      const bool front = (z < s.interiorEnd(2)-1) || upper[2];
+      const int begin = s.index({{s.interiorBegin(0), y, z}});
+      const int end = begin + s.interiorEnd(0) - s.interiorBegin(0);
+
+      for (int k=begin; k<end; k++)
+      {
+        const double c = u[k];
+        double sum = 0.0;
+        if (k > begin || lower[0]) sum += coeff[0]*(c - u[k-1]);
+        if (k < end-1 || upper[0]) sum += coeff[0]*(c - u[k+1]);
+        if (down) sum += coeff[1]*(c - u[k-sy]);
+        if (up) sum += coeff[1]*(c - u[k+sy]);
+        if (back) sum += coeff[2]*(c - u[k-sz]);
+        if (front) sum += coeff[2]*(c - u[k+sz]);
+        r[k] = sum;
+      }
+    }
+}
+
+int main (int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
+
+    int cells = (argc > 1) ? std::atoi(argv[1]) : 64;
+    int iterations = (argc > 2) ? std::atoi(argv[2]) : 10;
+
+    if (helper.rank() == 0)
+      std::cout << "YaspGrid<" << dim << "> with " << cells << "^" << dim << " cells on "
+                << helper.size() << " processes, " << iterations << " iterations" << std::endl;
+
+    Dune::FieldVector<double,dim> L(1.0);
+    std::array<int,dim> size;
+    std::fill(size.begin(), size.end(), cells);
+    Grid grid(L, size);
+    auto gv = grid.leafGridView();
+    Dune::YaspStructuredAccess<Grid> s(grid);
+
+    std::vector<double> u(gv.size(0));
+    for (std::size_t k=0; k<u.size(); k++)
+      u[k] = std::sin(0.1*k);
+    std::vector<double> r1(u.size(), 0.0), r2(u.size(), 0.0);
+
+    grid.comm().barrier();
+    Dune::Timer timer;
+    for (int i=0; i<iterations; i++)
+      applyIterators(gv, u, r1);
+    double iteratorTime = grid.comm().max(timer.elapsed());
+
+    grid.comm().barrier();
+    timer.reset();
+    for (int i=0; i<iterations; i++)
+      applyStructured(s, u, r2);
+    double structuredTime = grid.comm().max(timer.elapsed());
+
+    double difference = 0.0;
+    for (std::size_t k=0; k<u.size(); k++)
+      difference = std::max(difference, std::abs(r1[k] - r2[k]));
+    difference = grid.comm().max(difference);
+
+    if (helper.rank() == 0)
+    {
+      std::cout << "iterators:         " << iteratorTime/iterations*1e3 << " ms per application" << std::endl;
+      std::cout << "structured access: " << structuredTime/iterations*1e3 << " ms per application" << std::endl;
+      std::cout << "maximum difference " << difference << std::endl;
+    }
+  }
+  catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+
+  return 0;
+}